@@ -0,0 +1,283 @@
+/*****************************************************************************
+  benchUtil.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+/*
+   Helpers for bedtools-bench.
+
+   benchUtil gen  writes deterministic synthetic intervals. The output
+                  depends only on the genome file, -n and -seed, so runs
+                  on different machines time the same workload.
+   benchUtil bam  converts the generated BED to BAM. (bedtobam needs the
+                  genome's FASTA, which a synthetic workload doesn't have,
+                  so the records are written without sequence.)
+   benchUtil run  runs a shell command and reports its wall time and peak
+                  RSS (there's no portable /usr/bin/time -f to rely on).
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "api/BamAlignment.h"
+#include "api/BamWriter.h"
+
+using namespace std;
+using namespace BamTools;
+
+// splitmix64. Small, fast and the same everywhere, unlike rand().
+class BenchRng {
+public:
+    BenchRng(uint64_t seed) : _state(seed) {}
+    uint64_t next() {
+        uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    // uniform in (0, 1]
+    double uniform() { return ((next() >> 11) + 1) * (1.0 / 9007199254740992.0); }
+private:
+    uint64_t _state;
+};
+
+struct BenchChrom {
+    string name;
+    uint64_t length;
+    double weight;
+    uint64_t count;
+};
+
+static void usage() {
+    cerr << "Usage: benchUtil gen -g <genome> -n <count> [-seed <n>] [-unsorted]" << endl;
+    cerr << "       benchUtil bam -g <genome> -i <bed>" << endl;
+    cerr << "       benchUtil run <shell command>" << endl;
+    exit(1);
+}
+
+static uint64_t parseCount(const char *str) {
+    char *end = NULL;
+    double val = strtod(str, &end);
+    if (*end == 'K' || *end == 'k') val *= 1e3;
+    else if (*end == 'M' || *end == 'm') val *= 1e6;
+    else if (*end == 'G' || *end == 'g') val *= 1e9;
+    return (uint64_t)val;
+}
+
+// Interval lengths are heavy-tailed (Pareto, alpha 1.2): mostly a few
+// hundred bp, with the occasional 100kb+ feature that long sweeps and
+// caches have to cope with.
+static uint64_t drawLength(BenchRng &rng) {
+    static const double MIN_LEN = 50.0;
+    static const double MAX_LEN = 2000000.0;
+    double len = MIN_LEN * pow(rng.uniform(), -1.0 / 1.2);
+    return (uint64_t)min(len, MAX_LEN);
+}
+
+static void printInterval(const BenchChrom &chrom, uint64_t start, uint64_t end,
+                          uint64_t id, BenchRng &rng, string &out) {
+    char line[256];
+    int len = snprintf(line, sizeof(line), "%s\t%llu\t%llu\tf%llu\t%d\t%c\n",
+                       chrom.name.c_str(), (unsigned long long)start, (unsigned long long)end,
+                       (unsigned long long)id, (int)(rng.next() % 1000), (rng.next() & 1) ? '+' : '-');
+    out.append(line, len);
+}
+
+static int gen(int argc, char **argv) {
+    string genomeFile;
+    uint64_t count = 0;
+    uint64_t seed = 1;
+    bool unsorted = false;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) genomeFile = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) count = parseCount(argv[++i]);
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-unsorted") == 0) unsorted = true;
+        else usage();
+    }
+    if (genomeFile.empty() || count == 0) usage();
+
+    // every other chromosome is sparse (a tenth of the density of the
+    // others), so tools see both crowded and nearly empty sweeps.
+    vector<BenchChrom> chroms;
+    ifstream genome(genomeFile.c_str());
+    if (!genome.good()) {
+        cerr << "Error: can't open genome file " << genomeFile << endl;
+        return 1;
+    }
+    BenchChrom chrom;
+    double totalWeight = 0;
+    while (genome >> chrom.name >> chrom.length) {
+        chrom.weight = (double)chrom.length * (chroms.size() % 2 == 0 ? 1.0 : 0.1);
+        totalWeight += chrom.weight;
+        chroms.push_back(chrom);
+    }
+    uint64_t assigned = 0;
+    for (size_t i = 0; i < chroms.size(); i++) {
+        chroms[i].count = (uint64_t)(count * (chroms[i].weight / totalWeight));
+        assigned += chroms[i].count;
+    }
+    chroms[0].count += count - assigned;
+
+    BenchRng rng(seed);
+    string out;
+    vector<string> lines;
+    uint64_t id = 0;
+
+    // sorted output is streamed, with starts drawn as exponential gaps,
+    // so even 1B intervals need no memory. Unsorted output visits the
+    // chromosomes in a shuffled order and shuffles windows of records.
+    vector<size_t> order(chroms.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    if (unsorted) {
+        for (size_t i = order.size(); i > 1; i--) swap(order[i - 1], order[rng.next() % i]);
+    }
+    static const size_t SHUFFLE_WINDOW = 65536;
+    for (size_t c = 0; c < order.size(); c++) {
+        const BenchChrom &chrom = chroms[order[c]];
+        double meanGap = (double)chrom.length / (chrom.count + 1);
+        double pos = 0;
+        for (uint64_t i = 0; i < chrom.count; i++) {
+            pos += -log(rng.uniform()) * meanGap;
+            uint64_t start = min((uint64_t)pos, chrom.length - 1);
+            uint64_t end = min(start + drawLength(rng), chrom.length);
+            if (!unsorted) {
+                printInterval(chrom, start, end, id++, rng, out);
+                if (out.size() > (1 << 20)) {
+                    fwrite(out.data(), 1, out.size(), stdout);
+                    out.clear();
+                }
+                continue;
+            }
+            string line;
+            printInterval(chrom, start, end, id++, rng, line);
+            lines.push_back(line);
+            if (lines.size() == SHUFFLE_WINDOW) {
+                for (size_t j = lines.size(); j > 1; j--) swap(lines[j - 1], lines[rng.next() % j]);
+                for (size_t j = 0; j < lines.size(); j++) fputs(lines[j].c_str(), stdout);
+                lines.clear();
+            }
+        }
+    }
+    for (size_t j = lines.size(); j > 1; j--) swap(lines[j - 1], lines[rng.next() % j]);
+    for (size_t j = 0; j < lines.size(); j++) fputs(lines[j].c_str(), stdout);
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
+
+static int bam(int argc, char **argv) {
+    string genomeFile, bedFile;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) genomeFile = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) bedFile = argv[++i];
+        else usage();
+    }
+    if (genomeFile.empty() || bedFile.empty()) usage();
+
+    ifstream genome(genomeFile.c_str());
+    ifstream bed(bedFile.c_str());
+    if (!genome.good() || !bed.good()) {
+        cerr << "Error: can't open " << genomeFile << " or " << bedFile << endl;
+        return 1;
+    }
+    RefVector refs;
+    map<string, int> refIds;
+    string header = "@HD\tVN:1.0\tSO:coordinate\n";
+    string chrom;
+    uint64_t length;
+    while (genome >> chrom >> length) {
+        refIds[chrom] = (int)refs.size();
+        refs.push_back(RefData(chrom, (int32_t)length));
+        ostringstream line;
+        line << "@SQ\tSN:" << chrom << "\tLN:" << length << "\n";
+        header += line.str();
+    }
+
+    BamWriter writer;
+    if (!writer.Open("stdout", header, refs)) {
+        cerr << "Error: can't write BAM to stdout" << endl;
+        return 1;
+    }
+    string name, strand;
+    int start, end, score;
+    BamAlignment al;
+    while (bed >> chrom >> start >> end >> name >> score >> strand) {
+        al.Name = name;
+        al.RefID = refIds[chrom];
+        al.Position = start;
+        al.MapQuality = score % 256;
+        al.AlignmentFlag = 0;
+        al.SetIsReverseStrand(strand == "-");
+        al.CigarData.assign(1, CigarOp('M', end - start));
+        al.MateRefID = -1;
+        al.MatePosition = -1;
+        al.InsertSize = 0;
+        writer.SaveAlignment(al);
+    }
+    writer.Close();
+    return 0;
+}
+
+// prints "<exit status>\t<wall seconds>\t<peak RSS in KB>"
+static int run(int argc, char **argv) {
+    if (argc < 1) usage();
+    string cmd;
+    for (int i = 0; i < argc; i++) {
+        if (i > 0) cmd += " ";
+        cmd += argv[i];
+    }
+    struct timeval startTime, endTime;
+    gettimeofday(&startTime, NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0) {
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), (char *)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        perror("wait4");
+        return 1;
+    }
+    gettimeofday(&endTime, NULL);
+    double seconds = (endTime.tv_sec - startTime.tv_sec) + (endTime.tv_usec - startTime.tv_usec) / 1e6;
+    long maxRss = usage.ru_maxrss;
+#ifdef __APPLE__
+    maxRss /= 1024; // bytes on OS X
+#endif
+    // wait4 covers the shell; the tool itself is one of its children.
+    struct rusage childUsage;
+    getrusage(RUSAGE_CHILDREN, &childUsage);
+    long childRss = childUsage.ru_maxrss;
+#ifdef __APPLE__
+    childRss /= 1024;
+#endif
+    printf("%d\t%.3f\t%ld\n", WIFEXITED(status) ? WEXITSTATUS(status) : 128,
+           seconds, max(maxRss, childRss));
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) usage();
+    if (strcmp(argv[1], "gen") == 0) return gen(argc - 2, argv + 2);
+    if (strcmp(argv[1], "bam") == 0) return bam(argc - 2, argv + 2);
+    if (strcmp(argv[1], "run") == 0) return run(argc - 2, argv + 2);
+    usage();
+    return 1;
+}
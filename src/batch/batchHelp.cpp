@@ -0,0 +1,55 @@
+/*****************************************************************************
+  batchHelp.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#include "CommonHelp.h"
+
+
+void batch_help(void) {
+
+    cerr << "\nTool:    bedtools batch" << endl;
+    cerr << "Version: " << VERSION << "\n";
+    cerr << "Summary: Run several tools on the same A and B files in one pass." << endl;
+    cerr << "\t A and B are read and swept once, and the overlaps are handed" << endl;
+    cerr << "\t to every tool in the script, each writing its own output file." << endl << endl;
+
+    cerr << "Usage:   " << "bedtools batch" << " [OPTIONS] -a <bed/gff/vcf/bam> -b <bed/gff/vcf/bam> -script <file>" << endl << endl;
+
+    cerr << "Options: " << endl;
+
+    cerr << "\t-script\t"       << "A file with one job per line. Each job is a tool and its options," << endl;
+    cerr                        << "\t\twithout -a or -b, followed by '> ' and an output file." << endl;
+    cerr                        << "\t\tSupported tools are intersect, map, coverage and subtract." << endl;
+    cerr                        << "\t\tBlank lines and text after '#' are ignored." << endl << endl;
+
+    cerr << "\t-names\t"        << "When using multiple databases, provide an alias for each that" << endl;
+    cerr                        << "\t\twill appear instead of a fileId when also printing the DB record." << endl << endl;
+
+    cerr << "\t-filenames\t"    << "When using multiple databases, show each complete filename" << endl;
+    cerr                        << "\t\t\tinstead of a fileId when also printing the DB record." << endl << endl;
+
+    cerr << "\t-g\t"            << "Provide a genome file to enforce consistent chromosome sort order" << endl;
+    cerr                        << "\t\tacross input files." << endl << endl;
+
+    cerr << "\t-nonamecheck\t"  << "For sorted data, don't throw an error if the file has different naming conventions" << endl;
+    cerr                        << "\t\t\tfor the same chromosome. ex. \"chr1\" vs \"chr01\"." << endl << endl;
+
+    cerr << "\t-iobuf\t"        << "Specify amount of memory to use for input buffer." << endl;
+    cerr                        << "\t\tTakes an integer argument. Optional suffixes K/M/G supported." << endl << endl;
+
+    cerr << "Notes: " << endl;
+    cerr << "\t(1) Input must be sorted, as with -sorted. Each job is run as" << endl;
+    cerr << "\t    though it had been given -sorted." << endl;
+    cerr << "\t(2) The input options above are passed on to every job." << endl << endl;
+
+    cerr << "Example: " << endl;
+    cerr << "\t$ cat jobs.txt" << endl;
+    cerr << "\tintersect -u > overlaps.bed" << endl;
+    cerr << "\tcoverage -hist > coverage.txt" << endl;
+    cerr << "\tmap -c 5 -o mean > means.bed" << endl << endl;
+    cerr << "\t$ bedtools batch -a a.bed -b b.bed -script jobs.txt" << endl << endl;
+
+    // end the program here
+    exit(1);
+}
@@ -40,6 +40,7 @@ void showHelp(const QuickString &subCmd);
 int annotate_main(int argc, char* argv[]);//
 int bamtobed_main(int argc, char* argv[]);//
 int bamtofastq_main(int argc, char* argv[]);//
+void batch_help();
 int bed12tobed6_main(int argc, char* argv[]); //
 int bedtobam_main(int argc, char* argv[]);//
 int bedtoigv_main(int argc, char* argv[]);//
@@ -58,6 +59,7 @@ void groupby_help();
 void intersect_help();
 void map_help();
 void jaccard_help(); //
+int jaccardmatrix_main(int argc, char* argv[]); //
 void fisher_help();
 int links_main(int argc, char* argv[]);//
 int maskfastafrombed_main(int argc, char* argv[]);//
@@ -68,6 +70,7 @@ int multiintersect_main(int argc, char* argv[]);//
 int nuc_main(int argc, char* argv[]);//
 int pairtobed_main(int argc, char* argv[]);//
 int pairtopair_main(int argc, char* argv[]);//
+int permtest_main(int argc, char* argv[]); //
 int random_main(int argc, char* argv[]); //
 int reldist_main(int argc, char* argv[]); //
 void sample_help();
@@ -143,6 +146,8 @@ int main(int argc, char *argv[])
 
     // statistics tools
     else if (subCmd == "reldist")     return reldist_main(argc-1, argv+1);
+    else if (subCmd == "permtest")    return permtest_main(argc-1, argv+1);
+    else if (subCmd == "jaccardmatrix") return jaccardmatrix_main(argc-1, argv+1);
 
     // misc. tools
     else if (subCmd == "overlap")     return getoverlap_main(argc-1, argv+1);
@@ -251,6 +256,8 @@ int bedtools_help(void)
     cout  << "    jaccard       "  << "Calculate the Jaccard statistic b/w two sets of intervals.\n";
     cout  << "    reldist       "  << "Calculate the distribution of relative distances b/w two files.\n";
     cout  << "    fisher        "  << "Calculate Fisher statistic b/w two feature files.\n";
+    cout  << "    permtest      "  << "Test a statistic b/w two files against shuffles of the first.\n";
+    cout  << "    jaccardmatrix "  << "Calculate the Jaccard statistic b/w every pair of many files.\n";
 
     cout  << endl;
     cout  << "[ Miscellaneous tools ]" << endl;
@@ -261,6 +268,7 @@ int bedtools_help(void)
     cout  << "    groupby       "  << "Group by common cols. & summarize oth. cols. (~ SQL \"groupBy\")\n";
     cout  << "    expand        "  << "Replicate lines based on lists of values in columns.\n";
     cout  << "    split         "  << "Split a file into multiple files with equal records or base pairs.\n"; 
+    cout  << "    batch         "  << "Run several tools on the same files in a single pass.\n";
 
     cout  << endl;
     cout  << "[ General help ]" << endl;
@@ -312,6 +320,8 @@ void showHelp(const QuickString &subCmd) {
 		complement_help();
 	} else if (subCmd == "groupby") {
 		groupby_help();
+	} else if (subCmd == "batch") {
+		batch_help();
 	}
 
 
@@ -7,22 +7,55 @@
 
 #include "closestFile.h"
 #include "CloseSweep.h"
+#include "FileRecordMgr.h"
+#include <pthread.h>
 
 ClosestFile::ClosestFile(ContextClosest *context)
-: IntersectFile(context)
+: IntersectFile(context),
+  _indexData(NULL),
+  _batchPos(0)
 {
 
 }
 
+ClosestFile::~ClosestFile()
+{
+	for (size_t i=0; i < _indexes.size(); i++) {
+		delete _indexes[i];
+	}
+	delete _indexData;
+}
+
+bool ClosestFile::init()
+{
+	if (upCast(_context)->getSortedInput()) {
+		return IntersectFile::init();
+	}
+	_queryFRM = upCast(_context)->getFile(upCast(_context)->getQueryFileIdx());
+	_indexData = new CloseIndexData(upCast(_context));
+	_indexData->loadDB();
+	for (int i=0; i < upCast(_context)->getNumThreads(); i++) {
+		_indexes.push_back(new CloseIndex(upCast(_context), _indexData));
+	}
+	return true;
+}
+
 bool ClosestFile::findNext(RecordKeyVector &hits)
 {
+	if (_indexData != NULL) {
+		return nextIndexedFind(hits);
+	}
 	return nextSortedFind(hits);
 }
 
 void ClosestFile::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits)
 {
 	if (upCast(_context)->reportDistance()) {
-		outputMgr->printClosest(hits, &(upCastSweep()->getDistances()));
+		if (_indexData != NULL) {
+			outputMgr->printClosest(hits, &(_batchDists[_batchPos -1]));
+		} else {
+			outputMgr->printClosest(hits, &(upCastSweep()->getDistances()));
+		}
 	} else {
 		outputMgr->printClosest(hits, NULL);
 	}
@@ -33,3 +66,88 @@ void ClosestFile::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits)
 void ClosestFile::makeSweep() {
 	_sweep = new CloseSweep(upCast(_context));
 }
+
+bool ClosestFile::nextIndexedFind(RecordKeyVector &hits)
+{
+	if (_batchPos == _batchQueries.size() && !fillBatch()) {
+		return false;
+	}
+	hits.setKey(_batchQueries[_batchPos]);
+	const vector<const Record *> &batchHits = _batchHits[_batchPos];
+	for (size_t i=0; i < batchHits.size(); i++) {
+		hits.push_back(batchHits[i]);
+	}
+	_batchPos++;
+	return true;
+}
+
+class ClosestBatchArgs {
+public:
+	ClosestFile *_tool;
+	int _thread;
+};
+
+bool ClosestFile::fillBatch()
+{
+	//the previous batch's queries were deleted by cleanupHits.
+	_batchQueries.clear();
+	_batchPos = 0;
+	while (_batchQueries.size() < BATCH_SIZE && !_queryFRM->eof()) {
+		Record *queryRecord = _queryFRM->getNextRecord();
+		if (queryRecord == NULL) {
+			continue;
+		}
+		_context->testNameConventions(queryRecord);
+		_batchQueries.push_back(queryRecord);
+	}
+	if (_batchQueries.empty()) {
+		return false;
+	}
+	_batchHits.resize(_batchQueries.size());
+	_batchDists.resize(_batchQueries.size());
+
+	int numThreads = (int)_indexes.size();
+	if (numThreads == 1 || _batchQueries.size() < 2) {
+		findBatchHits(0);
+		return true;
+	}
+	vector<pthread_t> threads(numThreads);
+	vector<ClosestBatchArgs> args(numThreads);
+	for (int i=0; i < numThreads; i++) {
+		args[i]._tool = this;
+		args[i]._thread = i;
+		if (pthread_create(&threads[i], NULL, runBatchThread, &args[i]) != 0) {
+			cerr << "Error: unable to create thread." << endl;
+			exit(1);
+		}
+	}
+	for (int i=0; i < numThreads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	return true;
+}
+
+void *ClosestFile::runBatchThread(void *args)
+{
+	ClosestBatchArgs *batchArgs = static_cast<ClosestBatchArgs *>(args);
+	batchArgs->_tool->findBatchHits(batchArgs->_thread);
+	return NULL;
+}
+
+void ClosestFile::findBatchHits(int thread)
+{
+	//each thread takes every numThreads'th query, so that long and
+	//short queries are spread evenly.
+	CloseIndex *index = _indexes[thread];
+	RecordKeyVector retList;
+	size_t numThreads = _indexes.size();
+	for (size_t i = thread; i < _batchQueries.size(); i += numThreads) {
+		retList.clearAll();
+		index->findClosest(_batchQueries[i], retList);
+		_batchHits[i].clear();
+		for (RecordKeyVector::const_iterator_type iter = retList.begin(); iter != retList.end(); iter = retList.next()) {
+			_batchHits[i].push_back(*iter);
+		}
+		_batchDists[i] = index->getDistances();
+	}
+}
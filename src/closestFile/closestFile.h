@@ -11,11 +11,14 @@
 #include "intersectFile.h"
 #include "ContextClosest.h"
 #include "CloseSweep.h"
+#include "CloseIndex.h"
 
 class ClosestFile : public IntersectFile {
 
 public:
     ClosestFile(ContextClosest *context);
+    virtual ~ClosestFile();
+    virtual bool init();
   	bool findNext(RecordKeyVector &hits);
 	virtual void processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits);
 
@@ -24,6 +27,20 @@ protected:
 	virtual CloseSweep *upCastSweep() { return static_cast<CloseSweep *>(_sweep); }
 	virtual void makeSweep();
 
+	//for -unsorted input. Queries are read in batches, and the batch
+	//is answered by one CloseIndex per thread before any of it is output.
+	static const size_t BATCH_SIZE = 16384;
+	CloseIndexData *_indexData;
+	vector<CloseIndex *> _indexes;
+	vector<Record *> _batchQueries;
+	vector<vector<const Record *> > _batchHits;
+	vector<vector<int> > _batchDists;
+	size_t _batchPos;
+
+	bool nextIndexedFind(RecordKeyVector &hits);
+	bool fillBatch();
+	void findBatchHits(int thread);
+	static void *runBatchThread(void *args);
 };
 
 
@@ -72,6 +72,12 @@ void closest_help(void) {
     cerr << "\t-N\t"            << "Require that the query and the closest hit have different names." << endl;
     cerr                        << "\t\tFor BED, the 4th column is compared." << endl << endl;
 
+    cerr << "\t-unsorted\t"     << "Allow unsorted input. B is loaded into an index, and A is answered" << endl;
+    cerr                        << "\t\tin its own order. Uses memory in proportion to the size of B." << endl << endl;
+
+    cerr << "\t-threads\t"      << "With -unsorted, A is answered on all the threads. Otherwise" << endl;
+    cerr                        << "\t\tthey are only for -obgz or -ogz output." << endl << endl;
+
     IntersectCommonHelp();
     multiDbOutputHelp();
     allToolsCommonHelp();
@@ -6,6 +6,7 @@
  */
 
 #include "coverageFile.h"
+#include "ParseTools.h"
 
 CoverageFile::CoverageFile(ContextCoverage *context)
 : IntersectFile(context),
@@ -13,8 +14,7 @@ CoverageFile::CoverageFile(ContextCoverage *context)
  _depthArrayCapacity(0),
  _queryLen(0),
  _totalQueryLen(0),
- _queryOffset(0),
- _floatValBuf(NULL)
+ _queryOffset(0)
 {
 	//allocate and initialize depth array.
 	//Use C's malloc and free becauase we want
@@ -24,13 +24,10 @@ CoverageFile::CoverageFile(ContextCoverage *context)
 	_depthArray = (size_t *)malloc(newSize);
 	memset(_depthArray, 0, newSize);
 	_depthArrayCapacity = DEFAULT_DEPTH_CAPACITY;
-
-	_floatValBuf = new char[floatValBufLen];
 }
 
 CoverageFile::~CoverageFile() {
 	free(_depthArray);
-	delete _floatValBuf;
 }
 
 
@@ -64,8 +61,8 @@ void CoverageFile::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits
 
 }
 
-void CoverageFile::cleanupHits(RecordKeyVector &hits) {
-	IntersectFile::cleanupHits(hits);
+void CoverageFile::releaseHits(RecordKeyVector &hits) {
+	IntersectFile::releaseHits(hits);
 	memset(_depthArray, 0, sizeof(size_t) * _queryLen);
 
 }
@@ -209,7 +206,5 @@ void CoverageFile::doDefault(RecordOutputMgr *outputMgr, RecordKeyVector &hits)
 
 void CoverageFile::format(float val)
 {
-	memset(_floatValBuf, 0, floatValBufLen);
-	sprintf(_floatValBuf, "%0.7f", val);
-   _finalOutput.append(_floatValBuf);
+	fixed2str(val, _finalOutput, 7, true);
 }
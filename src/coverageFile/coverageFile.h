@@ -16,7 +16,7 @@ public:
 	CoverageFile(ContextCoverage *);
 	~CoverageFile();
 	virtual void processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits);
-	virtual void cleanupHits(RecordKeyVector &hits);
+	virtual void releaseHits(RecordKeyVector &hits);
 	virtual void  giveFinalReport(RecordOutputMgr *outputMgr);
 
 
@@ -29,8 +29,6 @@ protected:
 	size_t _totalQueryLen;
 	int _queryOffset;
 	static const int DEFAULT_DEPTH_CAPACITY = 1024;
-	char *_floatValBuf;
-	static const int floatValBufLen = 16;
 
 	typedef map<size_t, size_t> depthMapType;
 	depthMapType _currDepthMap;
@@ -37,6 +37,7 @@ bool Fisher::finalizeCalculations()
 
     _queryCounts = _sweep->getQueryTotalRecords();
     _dbCounts = _sweep->getDatabaseTotalRecords();
+    _overlapCounts = (unsigned long)_numIntersections;
 
     _unionVal = _queryUnion + _dbUnion;
     return true;
@@ -87,29 +88,3 @@ void Fisher::giveFinalReport(RecordOutputMgr *outputMgr)
     printf("left\tright\ttwo-tail\tratio\n");
     printf("%.5g\t%.5g\t%.5g\t%.3f\n", left, right, two, ratio);
 }
-
-unsigned long Fisher::getTotalIntersection(RecordKeyVector &recList)
-{
-    unsigned long intersection = 0;
-    const Record *key = recList.getKey();
-    int keyStart = key->getStartPos();
-    int keyEnd = key->getEndPos();
-
-    _overlapCounts += recList.size();
-    _qsizes.push_back((keyEnd - keyStart));
-
-    int hitIdx = 0;
-    for (RecordKeyVector::const_iterator_type iter = recList.begin(); iter != recList.end(); iter = recList.next()) {
-        int maxStart = max((*iter)->getStartPos(), keyStart);
-        int minEnd = min((*iter)->getEndPos(), keyEnd);
-        _qsizes.push_back((int)(minEnd - maxStart));
-        if (_context->getObeySplits()) {
-            intersection += upCast(_context)->getSplitBlockInfo()->getOverlapBases(hitIdx);
-            hitIdx++;
-        } else {
-            intersection += (unsigned long)(minEnd - maxStart);
-        }
-    }
-    _numIntersections += (int)recList.size();
-    return intersection;
-}
@@ -25,9 +25,7 @@ protected:
     unsigned long _queryCounts;
     unsigned long _dbCounts;
     unsigned long _overlapCounts;
-    vector<int> _qsizes;
     BedFile *_excludeFile;
-    unsigned long getTotalIntersection(RecordKeyVector &hits);
     virtual ContextFisher *upCast(ContextBase *context) { return static_cast<ContextFisher *>(context); }
 
 };
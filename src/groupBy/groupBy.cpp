@@ -7,18 +7,29 @@
 #include "groupBy.h"
 #include "Tokenizer.h"
 #include "ParseTools.h"
+#include <cctype>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
 
 GroupBy::GroupBy(ContextGroupBy *context)
 : ToolBase(context),
   _queryFRM(NULL),
-  _prevRecord(NULL)
+  _prevRecord(NULL),
+  _groupsLoaded(false),
+  _currGroup(NULL),
+  _memUsed(0),
+  _numRecords(0),
+  _parallelOps(NULL)
 {
 
 }
 
 GroupBy::~GroupBy()
 {
-
+	delete _parallelOps;
+	_parallelOps = NULL;
 }
 
 bool GroupBy::init()
@@ -44,14 +55,41 @@ bool GroupBy::init()
 		}
 	}
 	_queryFRM = _context->getFile(0);
+	_queryFRM->addNeededColumns(_groupCols);
 	_prevFields.resize(_groupCols.size());
 
 	_prevRecord = getNextRecord();
+
+	int numThreads = _context->getNumThreads();
+	if (numThreads > 1) {
+		//groupBy deletes its own records, once they've been printed.
+		_parallelOps = new ParallelKeyListOps(*_context->getKeyListOps(), numThreads - 1, vector<FileRecordMgr *>());
+	}
 	return true;
 }
 
 bool GroupBy::findNext(RecordKeyVector &hits)
 {
+	if (upCast(_context)->unsortedInput()) {
+		if (!_groupsLoaded) {
+			loadGroups();
+		}
+		if (_groups.empty()) {
+			return false;
+		}
+		if (_currGroup != NULL) {
+			_groups.pop_front();
+			_currGroup = NULL;
+			if (_groups.empty()) {
+				return false;
+			}
+		}
+		_currGroup = &_groups.front();
+		hits.setKey(_currGroup->key);
+		hits.push_back(_currGroup->key);
+		return true;
+	}
+
 	//get one record.
 	if (_prevRecord == NULL) {
 		return false;
@@ -76,9 +114,51 @@ bool GroupBy::findNext(RecordKeyVector &hits)
 
 void GroupBy::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits)
 {
-
+	if (_parallelOps != NULL) {
+		_parallelOps->add(hits);
+		printDone(outputMgr);
+		return;
+	}
 	const Record *rec = hits.getKey();
-	const QuickString &opVal  = _context->getColumnOpsVal(hits);
+	const QuickString &opVal  = (_currGroup != NULL) ?
+			_context->getKeyListOps()->getOpVals(_currGroup->summary) :
+			_context->getColumnOpsVal(hits);
+	printGroup(outputMgr, rec, opVal);
+	cleanupHits(hits);
+}
+
+void GroupBy::giveFinalReport(RecordOutputMgr *outputMgr)
+{
+	if (_parallelOps != NULL) {
+		_parallelOps->finish();
+		printDone(outputMgr);
+	}
+	if (!_spillParts.empty()) {
+		//the groups in memory have all been printed. Now gather the
+		//spilled ones, each part's in their input order, and merge them.
+		vector<FILE *> results;
+		for (int i=0; i < (int)_spillParts.size(); i++) {
+			results.push_back(openSpillFile());
+			gatherSpill(_spillParts[i], 1, results.back());
+		}
+		_spillParts.clear();
+		mergeSpillResults(results, NULL, outputMgr);
+	}
+}
+
+void GroupBy::printDone(RecordOutputMgr *outputMgr)
+{
+	while (_parallelOps->nextDone(_doneHits)) {
+		if (!_parallelOps->getWarning().empty()) {
+			cerr << _parallelOps->getWarning() << endl;
+		}
+		printGroup(outputMgr, _doneHits.getKey(), _parallelOps->getOpVals());
+		cleanupHits(_doneHits);
+	}
+}
+
+void GroupBy::printGroup(RecordOutputMgr *outputMgr, const Record *rec, const QuickString &opVal)
+{
 	if (upCast(_context)->printFullCols()) {
 		outputMgr->printRecord(rec, opVal);
 	} else {
@@ -90,7 +170,6 @@ void GroupBy::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits)
 		outBuf.append(opVal);
 		outputMgr->printRecord(NULL, outBuf);
 	}
-	cleanupHits(hits);
 }
 
 void GroupBy::cleanupHits(RecordKeyVector &hits)
@@ -115,6 +194,309 @@ const Record *GroupBy::getNextRecord() {
 	return NULL;
 }
 
+void GroupBy::loadGroups() {
+	//each group's first record is kept until the group is printed.
+	//The others are only added to the group's summary.
+	//Groups are found through an open addressing hash table of their
+	//indexes plus one, so that zero marks an empty slot. It's kept at
+	//most half full.
+	vector<size_t> table(1024, 0);
+	QuickString key;
+	_context->getKeyListOps()->initSummary(_emptySummary);
+	_spillEntry.vals.resize(_emptySummary.size());
+	size_t maxMem = upCast(_context)->getMaxMem();
+	for (const Record *record = _prevRecord; record != NULL; record = getNextRecord()) {
+		makeGroupKey(record, key);
+		size_t slot = findSlot(_groups, table, key);
+		if (table[slot] == 0) {
+			if (!_spillParts.empty()) {
+				spillRecord(record, key);
+				_queryFRM->deleteRecord(record);
+				_numRecords++;
+				continue;
+			}
+			_groups.push_back(Group());
+			Group &newGroup = _groups.back();
+			newGroup.key = record;
+			newGroup.keyStr = key;
+			newGroup.summary = _emptySummary;
+			newGroup.seq = _numRecords;
+			table[slot] = _groups.size();
+			_memUsed += GROUP_BYTES + 2 * key.size();
+		}
+		Group &group = _groups[table[slot] - 1];
+		size_t prevMemUsed = summaryMemUsed(group.summary);
+		KeyListOps::addToSummary(group.summary, record);
+		_memUsed += summaryMemUsed(group.summary) - prevMemUsed;
+		if (record != group.key) {
+			_queryFRM->deleteRecord(record);
+		}
+		_numRecords++;
+		if (_groups.size() * 2 > table.size()) {
+			rehashGroups(_groups, table);
+		}
+		if (_spillParts.empty() && _memUsed > maxMem) {
+			openSpillParts(_spillParts);
+		}
+	}
+	_prevRecord = NULL;
+	_groupsLoaded = true;
+}
+
+size_t GroupBy::findSlot(const deque<Group> &groups, const vector<size_t> &table, const QuickString &key) {
+	size_t mask = table.size() - 1;
+	size_t slot = hashKey(key) & mask;
+	while (table[slot] != 0 && !(groups[table[slot] - 1].keyStr == key)) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void GroupBy::rehashGroups(const deque<Group> &groups, vector<size_t> &table) {
+	table.assign(table.size() * 2, 0);
+	size_t mask = table.size() - 1;
+	for (size_t i=0; i < groups.size(); i++) {
+		size_t slot = hashKey(groups[i].keyStr) & mask;
+		while (table[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+		table[slot] = i + 1;
+	}
+}
+
+size_t GroupBy::hashKey(const QuickString &key, uint32_t seed) {
+	//FNV-1a. Other seeds give the unrelated hashes that split spilled parts.
+	uint32_t hash = seed;
+	for (size_t i=0; i < key.size(); i++) {
+		hash ^= (unsigned char)key[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+size_t GroupBy::summaryMemUsed(const vector<ColumnOpSummary> &summary) {
+	size_t memUsed = 0;
+	for (int i=0; i < (int)summary.size(); i++) {
+		memUsed += summary[i].getMemUsed();
+	}
+	return memUsed;
+}
+
+void GroupBy::spillRecord(const Record *record, const QuickString &key) {
+	if (record->getType() == FileRecordTypeChecker::BAM_RECORD_TYPE && upCast(_context)->printFullCols()) {
+		cerr << "***** ERROR: groupby -unsorted passed its -mem limit, but can't spill whole BAM records to disk." << endl;
+		cerr << "***** Give a larger -mem, or sort the input." << endl;
+		exit(1);
+	}
+	SpillEntry &entry = _spillEntry;
+	entry.seq = _numRecords;
+	entry.key = key;
+	makeGroupText(record, entry.text);
+	for (int i=0; i < (int)_emptySummary.size(); i++) {
+		entry.vals[i] = record->getField(_emptySummary[i].getColumn());
+	}
+	writeSpillEntry(_spillParts[spillPart(key, 0)], entry);
+}
+
+void GroupBy::gatherSpill(FILE *part, int level, FILE *out) {
+	//as loadGroups, but from a part's entries, and with any new groups
+	//past the cap spilled into parts of this one.
+	deque<Group> groups;
+	vector<size_t> table(1024, 0);
+	vector<FILE *> subParts;
+	size_t memUsed = 0;
+	size_t maxMem = upCast(_context)->getMaxMem();
+	SpillEntry &entry = _spillEntry;
+	rewindSpillFile(part);
+	while (readSpillEntry(part, entry)) {
+		size_t slot = findSlot(groups, table, entry.key);
+		if (table[slot] == 0) {
+			if (!subParts.empty()) {
+				writeSpillEntry(subParts[spillPart(entry.key, level)], entry);
+				continue;
+			}
+			groups.push_back(Group());
+			Group &newGroup = groups.back();
+			newGroup.key = NULL;
+			newGroup.keyStr = entry.key;
+			newGroup.summary = _emptySummary;
+			newGroup.seq = entry.seq;
+			newGroup.text = entry.text;
+			table[slot] = groups.size();
+			memUsed += GROUP_BYTES + 2 * entry.key.size() + entry.text.size();
+		}
+		Group &group = groups[table[slot] - 1];
+		size_t prevMemUsed = summaryMemUsed(group.summary);
+		for (int i=0; i < (int)group.summary.size(); i++) {
+			group.summary[i].add(entry.vals[i]);
+		}
+		memUsed += summaryMemUsed(group.summary) - prevMemUsed;
+		if (groups.size() * 2 > table.size()) {
+			rehashGroups(groups, table);
+		}
+		if (subParts.empty() && memUsed > maxMem) {
+			openSpillParts(subParts);
+		}
+	}
+	fclose(part);
+
+	//this part's groups all came before any it spilled.
+	QuickString line;
+	for (size_t i=0; i < groups.size(); i++) {
+		line = groups[i].text;
+		line.append(_context->getKeyListOps()->getOpVals(groups[i].summary));
+		fwrite(&groups[i].seq, sizeof(uint64_t), 1, out);
+		writeSpillStr(out, line);
+	}
+	groups.clear();
+	table.clear();
+
+	if (!subParts.empty()) {
+		vector<FILE *> results;
+		for (int i=0; i < (int)subParts.size(); i++) {
+			results.push_back(openSpillFile());
+			gatherSpill(subParts[i], level + 1, results.back());
+		}
+		mergeSpillResults(results, out, NULL);
+	}
+}
+
+void GroupBy::mergeSpillResults(vector<FILE *> &results, FILE *out, RecordOutputMgr *outputMgr) {
+	//each result holds its groups in input order. Print them, or write them
+	//to out, in that order, always taking the earliest of the results' next groups.
+	int numResults = (int)results.size();
+	vector<uint64_t> seqs(numResults);
+	vector<QuickString> lines(numResults);
+	for (int i=0; i < numResults; i++) {
+		rewindSpillFile(results[i]);
+		if (fread(&seqs[i], sizeof(uint64_t), 1, results[i]) != 1 || !readSpillStr(results[i], lines[i])) {
+			fclose(results[i]);
+			results[i] = NULL;
+		}
+	}
+	while (1) {
+		int minIdx = -1;
+		for (int i=0; i < numResults; i++) {
+			if (results[i] != NULL && (minIdx == -1 || seqs[i] < seqs[minIdx])) {
+				minIdx = i;
+			}
+		}
+		if (minIdx == -1) break;
+
+		if (out != NULL) {
+			fwrite(&seqs[minIdx], sizeof(uint64_t), 1, out);
+			writeSpillStr(out, lines[minIdx]);
+		} else {
+			outputMgr->printRecord(NULL, lines[minIdx]);
+		}
+		FILE *result = results[minIdx];
+		if (fread(&seqs[minIdx], sizeof(uint64_t), 1, result) != 1 || !readSpillStr(result, lines[minIdx])) {
+			fclose(result);
+			results[minIdx] = NULL;
+		}
+	}
+	results.clear();
+}
+
+void GroupBy::openSpillParts(vector<FILE *> &parts) {
+	for (int i=0; i < NUM_SPILL_PARTS; i++) {
+		parts.push_back(openSpillFile());
+	}
+}
+
+FILE *GroupBy::openSpillFile() {
+	//the file is unlinked at once, so it's removed when closed, or on exit.
+	const char *tmpDir = getenv("TMPDIR");
+	if (tmpDir == NULL || tmpDir[0] == '\0') {
+		tmpDir = "/tmp";
+	}
+	string fileName(tmpDir);
+	fileName += "/bedtools.groupby.XXXXXX";
+	vector<char> nameBuf(fileName.begin(), fileName.end());
+	nameBuf.push_back('\0');
+	int fd = mkstemp(&nameBuf[0]);
+	FILE *fp = (fd == -1) ? NULL : fdopen(fd, "w+b");
+	if (fp == NULL) {
+		cerr << "***** ERROR: groupby -unsorted can't open a temporary file in " << tmpDir << ": " << strerror(errno) << endl;
+		exit(1);
+	}
+	unlink(&nameBuf[0]);
+	return fp;
+}
+
+void GroupBy::rewindSpillFile(FILE *fp) {
+	if (fflush(fp) != 0 || ferror(fp)) {
+		cerr << "***** ERROR: groupby -unsorted failed writing a temporary file: " << strerror(errno) << endl;
+		exit(1);
+	}
+	rewind(fp);
+}
+
+int GroupBy::spillPart(const QuickString &key, int level) {
+	return hashKey(key, 2166136261u + level + 1) % NUM_SPILL_PARTS;
+}
+
+void GroupBy::writeSpillEntry(FILE *fp, const SpillEntry &entry) {
+	fwrite(&entry.seq, sizeof(uint64_t), 1, fp);
+	writeSpillStr(fp, entry.key);
+	writeSpillStr(fp, entry.text);
+	for (int i=0; i < (int)entry.vals.size(); i++) {
+		writeSpillStr(fp, entry.vals[i]);
+	}
+}
+
+bool GroupBy::readSpillEntry(FILE *fp, SpillEntry &entry) {
+	if (fread(&entry.seq, sizeof(uint64_t), 1, fp) != 1) return false;
+	readSpillStr(fp, entry.key);
+	readSpillStr(fp, entry.text);
+	for (int i=0; i < (int)entry.vals.size(); i++) {
+		readSpillStr(fp, entry.vals[i]);
+	}
+	return true;
+}
+
+void GroupBy::writeSpillStr(FILE *fp, const QuickString &str) {
+	uint32_t len = str.size();
+	fwrite(&len, sizeof(uint32_t), 1, fp);
+	fwrite(str.c_str(), 1, len, fp);
+}
+
+bool GroupBy::readSpillStr(FILE *fp, QuickString &str) {
+	uint32_t len = 0;
+	if (fread(&len, sizeof(uint32_t), 1, fp) != 1) return false;
+	str.resize(len);
+	return fread(&str[0], 1, len, fp) == len;
+}
+
+void GroupBy::makeGroupKey(const Record *record, QuickString &key) {
+	key.clear();
+	for (int i=0; i < (int)_groupCols.size(); i++) {
+		const QuickString &field = record->getField(_groupCols[i]);
+		if (upCast(_context)->ignoreCase()) {
+			for (size_t j=0; j < field.size(); j++) {
+				key.append((char)tolower(field[j]));
+			}
+		} else {
+			key.append(field);
+		}
+		key.append('\t');
+	}
+}
+
+void GroupBy::makeGroupText(const Record *record, QuickString &text) {
+	//as printGroup prints before the op values.
+	text.clear();
+	if (upCast(_context)->printFullCols()) {
+		record->print(text);
+		text.append('\t');
+	} else {
+		for (int i=0; i < (int)_groupCols.size(); i++) {
+			text.append(record->getField(_groupCols[i]));
+			text.append('\t');
+		}
+	}
+}
+
 void GroupBy::assignPrevFields() {
 	for (int i=0; i < (int)_prevFields.size(); i++) {
 		_prevFields[i] = _prevRecord->getField(_groupCols[i]);
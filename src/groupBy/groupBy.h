@@ -9,6 +9,10 @@
 
 #include "ToolBase.h"
 #include "ContextGroupBy.h"
+#include "ColumnOpSummary.h"
+#include "ParallelKeyListOps.h"
+#include <deque>
+#include <cstdio>
 
 class GroupBy : public ToolBase {
 
@@ -21,7 +25,7 @@ public:
 	virtual void cleanupHits(RecordKeyVector &hits);
 	//do any last things needed to wrap up.
 	virtual bool finalizeCalculations() { return true;}
-	virtual void  giveFinalReport(RecordOutputMgr *outputMgr) {}
+	virtual void  giveFinalReport(RecordOutputMgr *outputMgr);
 
 protected:
 	virtual ContextGroupBy *upCast(ContextBase *context) { return static_cast<ContextGroupBy *>(context); }
@@ -33,6 +37,66 @@ protected:
 	const Record *getNextRecord();
 	bool canGroup(const Record *);
 	void assignPrevFields();
+	void printGroup(RecordOutputMgr *outputMgr, const Record *rec, const QuickString &opVal);
+
+	//with -unsorted, the groups in the order they first appeared, each with
+	//its first record and the running summary of its column operations.
+	struct Group {
+		const Record *key;
+		QuickString keyStr; //the group fields, as made by makeGroupKey.
+		vector<ColumnOpSummary> summary;
+		//for groups gathered from spilled records, which have no key record:
+		uint64_t seq; //the number of the group's first record in the input.
+		QuickString text; //what's printed before the op values.
+	};
+	deque<Group> _groups;
+	bool _groupsLoaded;
+	Group *_currGroup;
+	void loadGroups();
+	static size_t findSlot(const deque<Group> &groups, const vector<size_t> &table, const QuickString &key);
+	static void rehashGroups(const deque<Group> &groups, vector<size_t> &table);
+	static size_t hashKey(const QuickString &key, uint32_t seed = 2166136261u);
+	void makeGroupKey(const Record *record, QuickString &key);
+	void makeGroupText(const Record *record, QuickString &text);
+
+	//The groups' memory is kept near the -mem cap. Once it's reached, records
+	//of the groups in memory are still added to their summaries, but those of
+	//new groups are spilled to disk, split by their keys' hashes into parts,
+	//and gathered a part at a time after the groups in memory are printed.
+	//A part whose groups again pass the cap is split the same way, a level
+	//down. The groups of each part are merged back into their input order.
+	struct SpillEntry {
+		uint64_t seq; //the record's number in the input.
+		QuickString key;
+		QuickString text;
+		vector<QuickString> vals; //the field of each op's column.
+	};
+	size_t _memUsed;
+	uint64_t _numRecords;
+	vector<FILE *> _spillParts;
+	vector<ColumnOpSummary> _emptySummary;
+	SpillEntry _spillEntry;
+	static const int NUM_SPILL_PARTS = 16;
+	//what a group takes beyond its key and summaries; an estimate.
+	static const size_t GROUP_BYTES = 256;
+
+	static size_t summaryMemUsed(const vector<ColumnOpSummary> &summary);
+	void spillRecord(const Record *record, const QuickString &key);
+	void gatherSpill(FILE *part, int level, FILE *out);
+	void mergeSpillResults(vector<FILE *> &results, FILE *out, RecordOutputMgr *outputMgr);
+	static void openSpillParts(vector<FILE *> &parts);
+	static FILE *openSpillFile();
+	static void rewindSpillFile(FILE *fp);
+	static int spillPart(const QuickString &key, int level);
+	static void writeSpillEntry(FILE *fp, const SpillEntry &entry);
+	static bool readSpillEntry(FILE *fp, SpillEntry &entry);
+	static void writeSpillStr(FILE *fp, const QuickString &str);
+	static bool readSpillStr(FILE *fp, QuickString &str);
+
+	//with -threads, the column operations are computed here.
+	ParallelKeyListOps *_parallelOps;
+	RecordKeyVector _doneHits;
+	void printDone(RecordOutputMgr *outputMgr);
 };
 
 
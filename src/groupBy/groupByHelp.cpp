@@ -61,6 +61,21 @@ void groupby_help(void) {
 
     cerr << "\t-ignorecase\t"   << "Group values regardless of upper/lower case." << endl << endl;
 
+    cerr << "\t-unsorted\t"     << "The input need not be sorted or grouped by the -g columns." << endl;
+    cerr            << "\t\t\tGroups are gathered in memory, and reported in the order" << endl;
+    cerr            << "\t\t\tthat each first appears." << endl << endl;
+
+    cerr << "\t-mem\t\t"     << "With -unsorted, about how much memory the groups may take" << endl;
+    cerr            << "\t\t\tbefore those found after are spilled to temporary files" << endl;
+    cerr            << "\t\t\t(in $TMPDIR, or /tmp). Takes K, M or G suffixes." << endl;
+    cerr            << "\t\t\tValues kept for ops such as median or collapse may still" << endl;
+    cerr            << "\t\t\tgrow past it. Output is the same. Default: 1G." << endl << endl;
+
+    cerr << "\t-threads\t"     << "Number of threads. With more than one, the operations are" << endl;
+    cerr            << "\t\t\tcomputed on the others while the input is read." << endl;
+    cerr            << "\t\t\tOutput is the same. With -unsorted, they only compress" << endl;
+    cerr            << "\t\t\t-obgz or -ogz output." << endl << endl;
+
     cerr << "\t-prec\t"   << "Sets the decimal precision for output (Default: 5)" << endl << endl;
     cerr << "\t-delim\t"                 << "Specify a custom delimiter for the collapse operations." << endl;
     cerr                                 << "\t\t- Example: -delim \"|\"" << endl;
@@ -82,7 +97,8 @@ void groupby_help(void) {
     cerr << "\tchr1 10  20  A   ATATCGCG" << endl << endl;
 
     cerr << "Notes: " << endl;
-    cerr << "\t(1)  The input file/stream should be sorted/grouped by the -grp. columns" << endl;
+    cerr << "\t(1)  The input file/stream should be sorted/grouped by the -grp. columns," << endl;
+    cerr << "\t     unless -unsorted is used." << endl;
     cerr << "\t(2)  If -i is unspecified, input is assumed to come from stdin." << endl << endl;
 
 
@@ -72,13 +72,47 @@ void IntersectFile::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hit
 
 void IntersectFile::cleanupHits(RecordKeyVector &hits)
 {
-	_queryFRM->deleteRecord(hits.getKey());
+	const Record *key = hits.getKey();
+	releaseHits(hits);
+	_queryFRM->deleteRecord(key);
+}
+
+bool IntersectFile::initShared() {
+	_queryFRM = upCast(_context)->getFile(upCast(_context)->getQueryFileIdx());
+	return true;
+}
+
+void IntersectFile::findShared(RecordKeyVector &sharedHits, RecordKeyVector &hits)
+{
+	//the shared sweep used the loosest overlap test, so apply ours.
+	const Record *key = sharedHits.getKey();
+	ContextIntersect *context = upCast(_context);
+	hits.setKey(key);
+	for (RecordKeyVector::const_iterator_type iter = sharedHits.begin(); iter != sharedHits.end(); iter = sharedHits.next()) {
+		if (key->sameChromIntersects(*iter,
+									 context->getSameStrand(),
+									 context->getDiffStrand(),
+									 context->getOverlapFractionA(),
+									 context->getOverlapFractionB(),
+									 context->getReciprocalFraction(),
+									 context->getEitherFraction())) {
+			hits.push_back(*iter);
+		}
+	}
+	if (context->getSortOutput()) {
+		hits.sortVector();
+	}
+	checkSplits(hits);
+}
+
+void IntersectFile::releaseHits(RecordKeyVector &hits)
+{
 	hits.clearAll();
 }
 
 bool IntersectFile::finalizeCalculations()
 {
-    if (upCast(_context)->getSortedInput() && !upCast(_context)->hasGenomeFile()) 
+    if (upCast(_context)->getSortedInput() && !upCast(_context)->hasGenomeFile() && _sweep != NULL)
     {
         if (_context->getNameCheckDisabled())
             _sweep->closeOut(false);
@@ -123,11 +157,13 @@ void IntersectFile::checkSplits(RecordKeyVector &hitSet)
 		RecordKeyVector keySet(hitSet.getKey());
 		RecordKeyVector resultSet(hitSet.getKey());
 		RecordKeyVector overlapSet(hitSet.getKey());
-		upCast(_context)->getSplitBlockInfo()->findBlockedOverlaps(keySet, hitSet, resultSet, overlapSet);
-		
+
 		// when using coverage, we need a list of the sub-intervals of coverage
 		// so that per-base depth can be properly calculated when obeying splits
-		if (_context->getProgram() == ContextBase::COVERAGE)
+		bool isCoverage = _context->getProgram() == ContextBase::COVERAGE;
+		upCast(_context)->getSplitBlockInfo()->findBlockedOverlaps(keySet, hitSet, resultSet, isCoverage ? &overlapSet : NULL);
+
+		if (isCoverage)
 		{
 			hitSet.swap(overlapSet);
 		}
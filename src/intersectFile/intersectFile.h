@@ -32,6 +32,14 @@ public:
 	virtual bool finalizeCalculations();
 	virtual void  giveFinalReport(RecordOutputMgr *outputMgr) {}
 
+	// bedtools batch runs several tools off of one sweep. Instead of
+	// sweeping, each tool is handed the shared hits for every query and
+	// keeps those that meet its own overlap options. The query record
+	// belongs to the batch driver, so releaseHits only clears the tool's
+	// per-query state, and doesn't delete the query.
+	virtual bool initShared();
+	virtual void findShared(RecordKeyVector &sharedHits, RecordKeyVector &hits);
+	virtual void releaseHits(RecordKeyVector &hits);
 
 protected:
 	NewChromSweep *_sweep;
@@ -6,6 +6,7 @@
  */
 
 #include "jaccard.h"
+#include <sstream>
 
 Jaccard::Jaccard(ContextJaccard *context)
 : IntersectFile(context),
@@ -13,12 +14,32 @@ Jaccard::Jaccard(ContextJaccard *context)
  _dbUnion(0),
  _intersectionVal(0),
  _unionVal(0),
- _numIntersections(0)
+ _numIntersections(0),
+ _jaccardSweep(NULL)
 {
 
 }
 
+void Jaccard::makeSweep() {
+	//with -split, or a minimum overlap, each query's hits are needed.
+	ContextJaccard *context = upCast(_context);
+	if (context->getObeySplits() || context->getOverlapFractionA() != 0.0 ||
+			context->getOverlapFractionB() != 0.0) {
+		IntersectFile::makeSweep();
+		return;
+	}
+	_jaccardSweep = new JaccardSweep(context);
+	_sweep = _jaccardSweep;
+}
+
 bool Jaccard::findNext(RecordKeyVector &hits) {
+	if (_jaccardSweep != NULL) {
+		//the whole sweep at once. It adds up the overlaps itself.
+		while (_jaccardSweep->next(hits)) {}
+		_intersectionVal = _jaccardSweep->getIntersectionBases();
+		_numIntersections = (int)_jaccardSweep->getNumIntersections();
+		return false;
+	}
 	if (nextSortedFind(hits)) {
 		checkSplits(hits);
 		_intersectionVal += getTotalIntersection(hits);
@@ -46,12 +67,15 @@ void  Jaccard::giveFinalReport(RecordOutputMgr *outputMgr) {
 	// header
 	outputMgr->checkForHeader();
 
-	cout << "intersection\tunion-intersection\tjaccard\tn_intersections" << endl;
+	//through the output manager, so it follows the file header, and goes to -obgz and the like.
+	outputMgr->printRecord(NULL, "intersection\tunion-intersection\tjaccard\tn_intersections");
 
 	unsigned long adjustedUnion = _unionVal - _intersectionVal;
 
-	cout << _intersectionVal << "\t" << adjustedUnion << "\t" <<
-			(float) _intersectionVal / (float)adjustedUnion << "\t" << _numIntersections << endl;
+	ostringstream report;
+	report << _intersectionVal << "\t" << adjustedUnion << "\t" <<
+			(float) _intersectionVal / (float)adjustedUnion << "\t" << _numIntersections;
+	outputMgr->printRecord(NULL, report.str());
 }
 
 unsigned long Jaccard::getTotalIntersection(RecordKeyVector &hits)
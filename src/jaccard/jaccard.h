@@ -10,6 +10,7 @@
 
 #include "ContextJaccard.h"
 #include "intersectFile.h"
+#include "JaccardSweep.h"
 
 class Jaccard : public IntersectFile {
 
@@ -30,7 +31,11 @@ protected:
     unsigned long _unionVal;
     int _numIntersections;
 
-     virtual unsigned long getTotalIntersection(RecordKeyVector &hits);
+    //NULL if the generic sweep (and its hit lists) are needed.
+    JaccardSweep *_jaccardSweep;
+
+    virtual void makeSweep();
+    virtual unsigned long getTotalIntersection(RecordKeyVector &hits);
 
 	virtual ContextJaccard *upCast(ContextBase *context) { return static_cast<ContextJaccard *>(context); }
 	virtual FileRecordMergeMgr *upCastFRM(FileRecordMgr *frm) { return static_cast<FileRecordMergeMgr *>(frm); }
@@ -0,0 +1,290 @@
+/*****************************************************************************
+  jaccardMatrix.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#include "jaccardMatrix.h"
+#include "kfunc.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+// the width, in files, of the tiles the matrix is computed in.
+static const int TILE_SIZE = 16;
+
+
+JaccardMatrix::JaccardMatrix(vector<string> &files, vector<string> &names,
+                             Statistic stat, string &genomeFile, int numThreads)
+: _files(files),
+  _names(names),
+  _stat(stat),
+  _numThreads(numThreads),
+  _genomeSize(0),
+  _nextJob(0)
+{
+    if (_stat == FISHER) {
+        GenomeFile genome(genomeFile);
+        _genomeSize = genome.getGenomeSize();
+    }
+    pthread_mutex_init(&_jobLock, NULL);
+}
+
+
+JaccardMatrix::~JaccardMatrix(void) {
+    pthread_mutex_destroy(&_jobLock);
+}
+
+
+struct LoadedInterval {
+    int chromId;
+    MatrixInterval interval;
+    bool operator<(const LoadedInterval &other) const {
+        if (chromId != other.chromId) return chromId < other.chromId;
+        return interval < other.interval;
+    }
+};
+
+
+void JaccardMatrix::LoadFile(int fileNum) {
+    // chroms get ids local to the file for now, so
+    // that the threads loading files share nothing.
+    MatrixFile &set = _sets[fileNum];
+    map<string, int> chromIds;
+    vector<LoadedInterval> loaded;
+    LoadedInterval curr;
+
+    BedFile bed(_files[fileNum]);
+    BED bedEntry;
+    bed.Open();
+    while (bed.GetNextBed(bedEntry)) {
+        if (bed._status != BED_VALID)
+            continue;
+        map<string, int>::const_iterator id = chromIds.find(bedEntry.chrom);
+        if (id == chromIds.end()) {
+            curr.chromId = (int)set.chromNames.size();
+            chromIds[bedEntry.chrom] = curr.chromId;
+            set.chromNames.push_back(bedEntry.chrom);
+        }
+        else {
+            curr.chromId = id->second;
+        }
+        curr.interval.start = bedEntry.start;
+        curr.interval.end   = bedEntry.end;
+        loaded.push_back(curr);
+    }
+    bed.Close();
+
+    // merge, as "bedtools jaccard" does. Book-ended intervals merge too.
+    sort(loaded.begin(), loaded.end());
+    set.bases = 0;
+    for (size_t i = 0; i < loaded.size(); i++) {
+        bool newChrom = set.chroms.empty() ||
+                        set.chroms.back().chromId != loaded[i].chromId;
+        if (!newChrom && loaded[i].interval.start <= set.intervals.back().end) {
+            set.intervals.back().end = max(set.intervals.back().end,
+                                           loaded[i].interval.end);
+            continue;
+        }
+        if (newChrom) {
+            MatrixChrom chrom;
+            chrom.chromId = loaded[i].chromId;
+            chrom.begin = set.intervals.size();
+            set.chroms.push_back(chrom);
+        }
+        set.intervals.push_back(loaded[i].interval);
+        set.chroms.back().end = set.intervals.size();
+    }
+    for (size_t i = 0; i < set.intervals.size(); i++)
+        set.bases += set.intervals[i].end - set.intervals[i].start;
+}
+
+
+void JaccardMatrix::AssignChromIds() {
+    map<string, int> chromIds;
+    for (size_t f = 0; f < _sets.size(); f++) {
+        MatrixFile &set = _sets[f];
+        for (size_t c = 0; c < set.chroms.size(); c++) {
+            const string &name = set.chromNames[set.chroms[c].chromId];
+            map<string, int>::const_iterator id = chromIds.find(name);
+            if (id == chromIds.end()) {
+                int newId = (int)chromIds.size();
+                chromIds[name] = newId;
+                set.chroms[c].chromId = newId;
+            }
+            else {
+                set.chroms[c].chromId = id->second;
+            }
+        }
+        sort(set.chroms.begin(), set.chroms.end());
+        vector<string>().swap(set.chromNames);
+    }
+}
+
+
+double JaccardMatrix::Compare(const MatrixFile &a, const MatrixFile &b) {
+    // both files are merged, so a two-pointer walk of each chrom
+    // finds every overlapping pair exactly once.
+    uint64_t intersection = 0, numOverlaps = 0;
+    size_t ca = 0, cb = 0;
+    while (ca < a.chroms.size() && cb < b.chroms.size()) {
+        if (a.chroms[ca].chromId < b.chroms[cb].chromId) {
+            ca++;
+            continue;
+        }
+        if (b.chroms[cb].chromId < a.chroms[ca].chromId) {
+            cb++;
+            continue;
+        }
+        size_t i = a.chroms[ca].begin, iEnd = a.chroms[ca].end;
+        size_t j = b.chroms[cb].begin, jEnd = b.chroms[cb].end;
+        while (i < iEnd && j < jEnd) {
+            const MatrixInterval &x = a.intervals[i];
+            const MatrixInterval &y = b.intervals[j];
+            CHRPOS start = max(x.start, y.start);
+            CHRPOS end = min(x.end, y.end);
+            if (start < end) {
+                intersection += end - start;
+                numOverlaps++;
+            }
+            if (x.end < y.end) i++;
+            else j++;
+        }
+        ca++;
+        cb++;
+    }
+
+    if (_stat == OVERLAPS)
+        return (double)numOverlaps;
+
+    if (_stat == JACCARD) {
+        uint64_t unionLen = a.bases + b.bases - intersection;
+        return (unionLen > 0) ? (float)intersection / (float)unionLen : 0;
+    }
+
+    // FISHER: the right tail, from the table "bedtools fisher -m" reports.
+    if (a.intervals.empty() || b.intervals.empty())
+        return 1;
+    long long aCount = (long long)a.intervals.size();
+    long long bCount = (long long)b.intervals.size();
+    long double aMean = 1.0 + a.bases / (long double)aCount;
+    long double bMean = 1.0 + b.bases / (long double)bCount;
+    long long n11 = (long long)numOverlaps;
+    long long n12 = max(0LL, aCount - n11);
+    long long n21 = max(0LL, bCount - n11);
+    long long n22_full = max(n21 + n12 + n11,
+                             (long long)(_genomeSize / (aMean + bMean)));
+    long long n22 = max(0LL, n22_full - n12 - n21 - n11);
+    double left, right, two;
+    kt_fisher_exact(n11, n12, n21, n22, &left, &right, &two);
+    return right;
+}
+
+
+void JaccardMatrix::CompareTile(int rowTile, int colTile) {
+    int numFiles = (int)_sets.size();
+    int rowEnd = min(numFiles, (rowTile + 1) * TILE_SIZE);
+    int colEnd = min(numFiles, (colTile + 1) * TILE_SIZE);
+    for (int i = rowTile * TILE_SIZE; i < rowEnd; i++) {
+        for (int j = max(i, colTile * TILE_SIZE); j < colEnd; j++) {
+            double val = Compare(_sets[i], _sets[j]);
+            _matrix[(size_t)i * numFiles + j] = val;
+            _matrix[(size_t)j * numFiles + i] = val;
+        }
+    }
+}
+
+
+bool JaccardMatrix::NextJob(size_t numJobs, size_t &job) {
+    pthread_mutex_lock(&_jobLock);
+    job = _nextJob++;
+    pthread_mutex_unlock(&_jobLock);
+    return job < numJobs;
+}
+
+
+void JaccardMatrix::RunThread(bool loading) {
+    size_t job;
+    size_t numJobs = loading ? _sets.size() : _tiles.size();
+    while (NextJob(numJobs, job)) {
+        if (loading)
+            LoadFile((int)job);
+        else
+            CompareTile(_tiles[job].first, _tiles[job].second);
+    }
+}
+
+
+struct MatrixThread {
+    JaccardMatrix *matrix;
+    bool loading;
+};
+
+static void *runMatrixThread(void *arg) {
+    MatrixThread *thread = (MatrixThread *)arg;
+    thread->matrix->RunThread(thread->loading);
+    return NULL;
+}
+
+
+void JaccardMatrix::RunThreads(bool loading) {
+    _nextJob = 0;
+    vector<pthread_t> threads(_numThreads);
+    MatrixThread arg;
+    arg.matrix  = this;
+    arg.loading = loading;
+    for (int t = 0; t < _numThreads; t++) {
+        if (pthread_create(&threads[t], NULL, runMatrixThread, &arg) != 0) {
+            cerr << "Error: unable to start thread " << t + 1 << "." << endl;
+            exit(1);
+        }
+    }
+    for (int t = 0; t < _numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+}
+
+
+void JaccardMatrix::Run() {
+    int numFiles = (int)_files.size();
+    _sets.resize(numFiles);
+    RunThreads(true);
+    AssignChromIds();
+
+    int numTiles = (numFiles + TILE_SIZE - 1) / TILE_SIZE;
+    for (int r = 0; r < numTiles; r++) {
+        for (int c = r; c < numTiles; c++) {
+            _tiles.push_back(make_pair(r, c));
+        }
+    }
+    _matrix.assign((size_t)numFiles * numFiles, 0);
+    RunThreads(false);
+    Report();
+}
+
+
+void JaccardMatrix::Report() {
+    int numFiles = (int)_sets.size();
+    cout << "file";
+    for (int j = 0; j < numFiles; j++)
+        cout << "\t" << _names[j];
+    cout << endl;
+
+    char buf[64];
+    for (int i = 0; i < numFiles; i++) {
+        cout << _names[i];
+        for (int j = 0; j < numFiles; j++) {
+            double val = _matrix[(size_t)i * numFiles + j];
+            if (_stat == JACCARD) {
+                cout << "\t" << (float)val;
+            }
+            else if (_stat == OVERLAPS) {
+                cout << "\t" << (uint64_t)val;
+            }
+            else {
+                snprintf(buf, sizeof(buf), "%.5g", val);
+                cout << "\t" << buf;
+            }
+        }
+        cout << "\n";
+    }
+}
@@ -0,0 +1,97 @@
+/*****************************************************************************
+  jaccardMatrix.h
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#ifndef JACCARDMATRIX_H
+#define JACCARDMATRIX_H
+
+#include "bedFile.h"
+#include "GenomeFile.h"
+
+#include <vector>
+#include <iostream>
+#include <map>
+#include <string>
+#include <pthread.h>
+using namespace std;
+
+
+struct MatrixInterval {
+    CHRPOS start;
+    CHRPOS end;
+    bool operator<(const MatrixInterval &other) const {
+        if (start != other.start) return start < other.start;
+        return end < other.end;
+    }
+};
+
+// one chrom's worth of a file's merged intervals.
+struct MatrixChrom {
+    int chromId;
+    size_t begin;
+    size_t end;
+    bool operator<(const MatrixChrom &other) const {
+        return chromId < other.chromId;
+    }
+};
+
+// a file, merged, as one array of intervals sorted by chrom, then start.
+struct MatrixFile {
+    vector<MatrixInterval> intervals;
+    vector<MatrixChrom> chroms;
+    vector<string> chromNames; // until the chroms get global ids.
+    uint64_t bases;
+};
+
+
+//************************************************
+// Class methods and elements
+//************************************************
+class JaccardMatrix {
+
+public:
+
+    enum Statistic { JACCARD, FISHER, OVERLAPS };
+
+    // constructor
+    JaccardMatrix(vector<string> &files, vector<string> &names,
+                  Statistic stat, string &genomeFile, int numThreads);
+
+    // destructor
+    ~JaccardMatrix(void);
+
+    // load every file, compare every pair and print the matrix.
+    void Run();
+
+    // run by each thread: files, then tiles of the matrix, are
+    // taken from a shared counter until there are none left.
+    void RunThread(bool loading);
+
+private:
+
+    vector<string> _files;
+    vector<string> _names;
+    Statistic _stat;
+    int _numThreads;
+    uint64_t _genomeSize;
+
+    vector<MatrixFile> _sets;
+    vector<double> _matrix;
+
+    // the matrix is computed in square tiles of files, so that
+    // the tile's files stay in cache while they're compared.
+    vector<pair<int, int> > _tiles;
+    size_t _nextJob;
+    pthread_mutex_t _jobLock;
+
+    bool NextJob(size_t numJobs, size_t &job);
+    void RunThreads(bool loading);
+    void LoadFile(int fileNum);
+    void AssignChromIds();
+    void CompareTile(int rowTile, int colTile);
+    double Compare(const MatrixFile &a, const MatrixFile &b);
+    void Report();
+};
+
+#endif /* JACCARDMATRIX_H */
@@ -0,0 +1,251 @@
+/*****************************************************************************
+  jaccardMatrixMain.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#include "jaccardMatrix.h"
+#include "version.h"
+#include "ParseTools.h"
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+// define our program name
+#define PROGRAM_NAME "bedtools jaccardmatrix"
+
+
+// define our parameter checking macro
+#define PARAMETER_CHECK(param, paramLen, actualLen) (strncmp(argv[i], param, min(actualLen, paramLen))== 0) && (actualLen == paramLen)
+
+// function declarations
+void jaccardmatrix_help(void);
+
+int jaccardmatrix_main(int argc, char* argv[]) {
+
+    // our configuration variables
+    bool showHelp = false;
+
+    // input files
+    vector<string> inputFiles;
+    vector<string> inputTitles;
+    string listFile;
+    string genomeFile;
+
+    // input arguments
+    bool haveList   = false;
+    bool haveTitles = false;
+    bool haveGenome = false;
+    int numThreads  = 1;
+    JaccardMatrix::Statistic stat = JaccardMatrix::JACCARD;
+
+    // check to see if we should print out some help
+    if(argc <= 1) showHelp = true;
+
+    for(int i = 1; i < argc; i++) {
+        int parameterLength = (int)strlen(argv[i]);
+
+        if((PARAMETER_CHECK("-h", 2, parameterLength)) ||
+        (PARAMETER_CHECK("--help", 5, parameterLength))) {
+            showHelp = true;
+        }
+    }
+
+    if(showHelp) jaccardmatrix_help();
+
+    // do some parsing (all of these parameters require 2 strings)
+    for(int i = 1; i < argc; i++) {
+
+        int parameterLength = (int)strlen(argv[i]);
+
+        if(PARAMETER_CHECK("-i", 2, parameterLength)) {
+            if ((i+1) < argc) {
+                i = i+1;
+                string file = argv[i];
+                while (file[0] != '-' && i < argc) {
+                    inputFiles.push_back(file);
+                    i++;
+                    if (i < argc)
+                        file = argv[i];
+                }
+                i--;
+            }
+        }
+        else if(PARAMETER_CHECK("-list", 5, parameterLength)) {
+            if ((i+1) < argc) {
+                haveList = true;
+                listFile = argv[i + 1];
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-names", 6, parameterLength)) {
+            if ((i+1) < argc) {
+                haveTitles = true;
+                i = i+1;
+                string title = argv[i];
+                while (title[0] != '-' && i < argc) {
+                    inputTitles.push_back(title);
+                    i++;
+                    if (i < argc)
+                        title = argv[i];
+                }
+                i--;
+            }
+        }
+        else if(PARAMETER_CHECK("-g", 2, parameterLength)) {
+            if ((i+1) < argc) {
+                haveGenome = true;
+                genomeFile = argv[i + 1];
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-threads", 8, parameterLength)) {
+            if ((i+1) < argc) {
+                numThreads = parseNumThreads(argv[i + 1]);
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-stat", 5, parameterLength)) {
+            if ((i+1) < argc) {
+                string statName = argv[i + 1];
+                if (statName == "jaccard")
+                    stat = JaccardMatrix::JACCARD;
+                else if (statName == "fisher")
+                    stat = JaccardMatrix::FISHER;
+                else if (statName == "overlaps")
+                    stat = JaccardMatrix::OVERLAPS;
+                else {
+                    cerr << endl << "*****ERROR: Unrecognized statistic: "
+                         << statName << " *****" << endl << endl;
+                    showHelp = true;
+                }
+                i++;
+            }
+        }
+        else {
+            cerr << endl
+                 << "*****ERROR: Unrecognized parameter: "
+                 << argv[i]
+                 << " *****"
+                 << endl << endl;
+            showHelp = true;
+        }
+    }
+
+    // the list file has one file name per line.
+    if (haveList) {
+        ifstream list(listFile.c_str());
+        if (!list.good()) {
+            cerr << "Error: The requested list file (" << listFile
+                 << ") could not be opened. Exiting!" << endl;
+            exit(1);
+        }
+        string file;
+        while (getline(list, file)) {
+            if (!file.empty())
+                inputFiles.push_back(file);
+        }
+    }
+
+    // make sure we have all of the input files
+    if (inputFiles.empty()) {
+        cerr << endl
+             << "*****"
+             << endl
+             << "*****ERROR: Need -i or -list files. "
+             << endl
+             << "*****"
+             << endl;
+        showHelp = true;
+    }
+    if (haveTitles && inputTitles.size() != inputFiles.size()) {
+        cerr << endl
+             << "*****"
+             << endl
+             << "*****ERROR: The number of file names (-names) does not match the number of files. "
+             << endl
+             << "*****"
+             << endl;
+        showHelp = true;
+    }
+    if (stat == JaccardMatrix::FISHER && !haveGenome) {
+        cerr << endl
+             << "*****"
+             << endl
+             << "*****ERROR: -stat fisher needs a -g genome file. "
+             << endl
+             << "*****"
+             << endl;
+        showHelp = true;
+    }
+    if (numThreads < 1) {
+        cerr << endl
+             << "*****"
+             << endl
+             << "*****ERROR: -threads must be a number greater than zero. "
+             << endl
+             << "*****"
+             << endl;
+        showHelp = true;
+    }
+
+    if (!showHelp) {
+        if (!haveTitles)
+            inputTitles = inputFiles;
+
+        JaccardMatrix *jm = new JaccardMatrix(inputFiles, inputTitles, stat,
+                                              genomeFile, numThreads);
+        jm->Run();
+        delete jm;
+        return 0;
+    }
+    else {
+        jaccardmatrix_help();
+        return 0;
+    }
+}
+
+void jaccardmatrix_help(void) {
+
+    cerr << "\nTool:    bedtools jaccardmatrix" << endl;
+    cerr << "Version: " << VERSION << "\n";
+    cerr << "Summary: Compare every pair of many feature files, and report"
+         << endl
+         << "\t the Jaccard statistic (or another) of each pair as a matrix."
+         << endl << endl;
+
+    cerr << "Usage:   "
+         << PROGRAM_NAME
+         << " [OPTIONS] -i FILE1 FILE2 .. FILEn" << endl;
+    cerr << "\t Requires that each file be in BED format. The files need not be sorted."
+         << endl << endl;
+
+    cerr << "Options: " << endl;
+
+    cerr << "\t-list\t"     << "A file listing the files to compare, one per line." << endl;
+    cerr                    << "\t\tFor use in place of, or with, -i." << endl << endl;
+
+    cerr << "\t-names\t"    << "A list of names (one/file) to describe each file in -i." << endl;
+    cerr                    << "\t\tThese names label the rows and columns of the matrix." << endl;
+    cerr                    << "\t\tBy default, the file names are used." << endl << endl;
+
+    cerr << "\t-stat\t"     << "The statistic to report for each pair:" << endl;
+    cerr                    << "\t\t- jaccard: as reported by bedtools jaccard (default)." << endl;
+    cerr                    << "\t\t- fisher: the right-tailed p-value that" << endl;
+    cerr                    << "\t\t  bedtools fisher -m reports. Requires -g." << endl;
+    cerr                    << "\t\t- overlaps: the number of overlaps b/w the" << endl;
+    cerr                    << "\t\t  merged files (jaccard's n_intersections)." << endl << endl;
+
+    cerr << "\t-g\t"        << "The genome file, for -stat fisher." << endl << endl;
+
+    cerr << "\t-threads\t"  << "Number of threads to load and compare the files with. Default is 1." << endl << endl;
+
+    cerr << "Notes: " << endl;
+    cerr << "\t(1) Each file is loaded once and merged, as bedtools jaccard does." << endl;
+    cerr << "\t(2) Unlike bedtools jaccard, every feature in both files counts" << endl;
+    cerr << "\t    toward the union, so the matrix is symmetric." << endl << endl;
+
+    // end the program here
+    exit(1);
+
+}
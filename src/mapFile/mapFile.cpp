@@ -8,11 +8,36 @@
 #include "mapFile.h"
 
 MapFile::MapFile(ContextMap *context)
-: IntersectFile(context)
+: IntersectFile(context),
+  _parallelOps(NULL)
 {
 
 }
 
+MapFile::~MapFile()
+{
+	delete _parallelOps;
+	_parallelOps = NULL;
+}
+
+bool MapFile::init()
+{
+	if (!IntersectFile::init()) {
+		return false;
+	}
+	int numThreads = _context->getNumThreads();
+	if (numThreads > 1) {
+		//the sweep deletes records from every file as it passes them, so
+		//those deletes must wait for the groups still being worked on.
+		vector<FileRecordMgr *> files;
+		for (int i=0; i < _context->getNumInputFiles(); i++) {
+			files.push_back(_context->getFile(i));
+		}
+		_parallelOps = new ParallelKeyListOps(*_context->getKeyListOps(), numThreads - 1, files);
+	}
+	return true;
+}
+
 bool MapFile::findNext(RecordKeyVector &hits)
 {
 	if (nextSortedFind(hits)) {
@@ -24,6 +49,31 @@ bool MapFile::findNext(RecordKeyVector &hits)
 
 void MapFile::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits)
 {
+	if (_parallelOps != NULL) {
+		_parallelOps->add(hits);
+		printDone(outputMgr);
+		return;
+	}
 	outputMgr->printRecord(hits.getKey(), _context->getColumnOpsVal(hits));
 }
 
+void MapFile::giveFinalReport(RecordOutputMgr *outputMgr)
+{
+	if (_parallelOps != NULL) {
+		_parallelOps->finish();
+		printDone(outputMgr);
+	}
+}
+
+void MapFile::printDone(RecordOutputMgr *outputMgr)
+{
+	while (_parallelOps->nextDone(_doneHits)) {
+		if (!_parallelOps->getWarning().empty()) {
+			cerr << _parallelOps->getWarning() << endl;
+		}
+		outputMgr->printRecord(_doneHits.getKey(), _parallelOps->getOpVals());
+		//the sweep has already deleted these records.
+		_doneHits.clearAll();
+	}
+}
+
@@ -10,16 +10,25 @@
 
 #include "intersectFile.h"
 #include "ContextMap.h"
+#include "ParallelKeyListOps.h"
 
 class MapFile : public IntersectFile {
 
 public:
     MapFile(ContextMap *context);
+    virtual ~MapFile();
+	virtual bool init();
 	virtual bool findNext(RecordKeyVector &hits);
  	virtual void processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits);
+	virtual void giveFinalReport(RecordOutputMgr *outputMgr);
 
 protected:
 	virtual ContextMap *upCast(ContextBase *context) { return static_cast<ContextMap *>(context); }
+
+	//with -threads, the column operations are computed here.
+	ParallelKeyListOps *_parallelOps;
+	RecordKeyVector _doneHits;
+	void printDone(RecordOutputMgr *outputMgr);
 };
 
 
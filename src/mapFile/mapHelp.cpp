@@ -21,6 +21,9 @@ void map_help(void) {
 
     KeyListOpsHelp();
 
+    cerr << "\t-threads\t"      << "With more than one thread, the operations are computed on" << endl;
+    cerr                        << "\t\tthe others while B is swept." << endl << endl;
+
     IntersectCommonHelp();
     allToolsCommonHelp();
 
@@ -22,6 +22,9 @@
 using namespace std;
 
 
+const CHRPOS MultiIntersectBed::NO_EVENT;
+
+
 MultiIntersectBed::MultiIntersectBed(std::ostream& _output,
                             const vector<string>& _filenames,
                             const vector<string>& _titles,
@@ -31,6 +34,7 @@ MultiIntersectBed::MultiIntersectBed(std::ostream& _output,
     filenames(_filenames),
     titles(_titles),
     output(_output),
+    file_list_dirty(true),
     current_non_zero_inputs(0),
     print_empty_regions(_print_empty_regions),
     haveTitles(false),
@@ -103,34 +107,30 @@ void MultiIntersectBed::PrintCoverage(CHRPOS start, CHRPOS end) {
         << start << "\t"
         << end   << "\t"
         << current_non_zero_inputs << "\t";
-    
-    ostringstream file_list_string;
-    ostringstream file_bool_string;
-    int depth_count = 0;
-    for (size_t i = 0; i < current_depth.size(); ++i)
-    {
-        if (current_depth[i] > 0) {
-            if (depth_count < current_non_zero_inputs - 1) {
-                if (!haveTitles)
-                    file_list_string << i+1 << ",";
-                else 
-                    file_list_string << titles[i] << ",";
-            }
-            else {
-                if (!haveTitles)
-                    file_list_string << i+1;
-                else 
-                    file_list_string << titles[i];
+
+    if (current_non_zero_inputs > 0) {
+        if (file_list_dirty) {
+            ostringstream file_list_string;
+            int depth_count = 0;
+            for (size_t i = 0; i < current_depth.size(); ++i)
+            {
+                if (current_depth[i] > 0) {
+                    if (!haveTitles)
+                        file_list_string << i+1;
+                    else
+                        file_list_string << titles[i];
+                    if (depth_count < current_non_zero_inputs - 1)
+                        file_list_string << ",";
+                    depth_count++;
+                }
             }
-            depth_count++;
+            file_list = file_list_string.str();
+            file_list_dirty = false;
         }
-        file_bool_string << "\t" << current_depth[i];
-    }
-    if (current_non_zero_inputs > 0) {
-        cout << file_list_string.str() << file_bool_string.str() << endl;
+        output << file_list << depth_columns << '\n';
     }
     else {
-        cout << "none" << file_bool_string.str() << endl;
+        output << "none" << depth_columns << '\n';
     }
 }
 
@@ -144,7 +144,55 @@ void MultiIntersectBed::PrintEmptyCoverage(CHRPOS start, CHRPOS end) {
     for (size_t i=0;i<current_depth.size();++i)
         output << "\t0";
 
-    output << endl;
+    output << '\n';
+}
+
+
+void MultiIntersectBed::SetDepth(int index, int depth) {
+    current_depth[index] = depth;
+    depth_columns[2 * index + 1] = (depth > 0) ? '1' : '0';
+    file_list_dirty = true;
+}
+
+
+void MultiIntersectBed::InitEvents() {
+    vector<CHRPOS> keys(input_files.size());
+    for (size_t i = 0; i < input_files.size(); ++i)
+        keys[i] = NextEvent(i);
+    events.init(keys, NO_EVENT);
+}
+
+
+CHRPOS MultiIntersectBed::NextEvent(int index) {
+    if (in_interval[index])
+        return interval_end[index];
+
+    //This file has no more intervals, or the next one belongs to a different chrom
+    const BED &bed(current_item[index]);
+    if (bed.chrom.empty() || bed.chrom != current_chrom)
+        return NO_EVENT;
+
+    return bed.start;
+}
+
+
+void MultiIntersectBed::UpdateInformation(int index) {
+    if (!in_interval[index]) {
+        // START: the pending interval becomes the current one.
+        interval_end[index] = current_item[index].end;
+        in_interval[index] = true;
+        SetDepth(index, 1);
+        current_non_zero_inputs++;
+
+        //Read the next interval from this file
+        LoadNextItem(index);
+    }
+    else {
+        // END
+        in_interval[index] = false;
+        SetDepth(index, 0);
+        current_non_zero_inputs--;
+    }
 }
 
 
@@ -193,8 +241,11 @@ void MultiIntersectBed::OpenFiles() {
         file->Open();
         input_files.push_back(file);
         current_depth.push_back(0);
+        depth_columns += "\t0";
     }
     current_item.resize(filenames.size());
+    in_interval.resize(filenames.size(), false);
+    interval_end.resize(filenames.size(), 0);
 }
 
 
@@ -216,45 +267,38 @@ void MultiIntersectBed::MultiIntersect() {
         LoadNextItem(i);
 
     // Chromosome loop - once per chromosome
-    Point curr_point;
+    CHRPOS curr_coord = 0;
     do {
         // Find the first chromosome to use
         current_chrom = DetermineNextChrom();
 
-        // Populate the queue with initial values from all files
+        // Populate the event tree with initial values from all files
         // (if they belong to the correct chromosome)
-        for(size_t i = 0; i < input_files.size(); ++i)
-            AddInterval(i);
+        InitEvents();
 
         CHRPOS prev_start    = 0;
-        do {
-            // get the current point in the queue
-            curr_point    = queue.top();
+        while (events.winnerKey() != NO_EVENT) {
+            // get the next coordinate at which any file changes
+            curr_coord = events.winnerKey();
             // if we have moved, report the interval
-            if (curr_point.coord > prev_start) {
-                PrintCoverage(prev_start, curr_point.coord);
-            }
-            // update depending on the type of interval we encountered.
-            if (curr_point.coord_type == START) {
-                current_depth[curr_point.source_index] = 1;
-                current_non_zero_inputs++;
-            }
-            else {
-                //Read the next interval from this file
-                AddInterval(curr_point.source_index);
-                current_depth[curr_point.source_index] = 0;
-                current_non_zero_inputs--;
+            if (curr_coord > prev_start) {
+                PrintCoverage(prev_start, curr_coord);
             }
+            // update every file with an event at this coordinate.
+            do {
+                int index = events.winner();
+                UpdateInformation(index);
+                events.update(index, NextEvent(index));
+            } while (events.winnerKey() == curr_coord);
             // reset for the next point
-            prev_start = curr_point.coord;
-            queue.pop();
-        } while (!queue.empty());
+            prev_start = curr_coord;
+        }
 
         // want empty regions, and the last coordinate is not the last coordinate of the chromosome
         if (print_empty_regions) {
             CHRPOS chrom_size = genome_sizes->getChromSize(current_chrom);
-            if (curr_point.coord < chrom_size)
-                PrintEmptyCoverage(curr_point.coord, chrom_size);
+            if (curr_coord < chrom_size)
+                PrintEmptyCoverage(curr_coord, chrom_size);
         }
     } while (!AllFilesDone());
 }
@@ -284,7 +328,7 @@ void MultiIntersectBed::Cluster() {
             // get the current point in the queue
             curr_point = queue.top();
             if (curr_point.coord_type == START) {
-                current_depth[curr_point.source_index] = 1;
+                SetDepth(curr_point.source_index, 1);
                 current_non_zero_inputs++;
                 // reset for the next point
                 prev_start = curr_point.coord;
@@ -296,7 +340,7 @@ void MultiIntersectBed::Cluster() {
                 }
                 //Read the next interval from this file
                 AddInterval(curr_point.source_index);
-                current_depth[curr_point.source_index] = 0;
+                SetDepth(curr_point.source_index, 0);
                 current_non_zero_inputs--;
                 last_direction = -1;
             }
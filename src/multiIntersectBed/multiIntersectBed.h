@@ -19,6 +19,7 @@
 #include "bedFile.h"
 #include "GenomeFile.h"
 #include "Point.h"
+#include "LoserTree.h"
 
 class MultiIntersectBed
 {
@@ -31,9 +32,25 @@ private:
     vector<int>        current_depth;
     vector<BED>        current_item;
 
+    // per-file state of the merge: is the file inside an interval,
+    // and if so, where does that interval end?
+    vector<bool>       in_interval;
+    vector<CHRPOS>     interval_end;
+
     std::ostream    &output;
 
-    POINT_PQUEUE queue;
+    POINT_PQUEUE queue; // used by Cluster()
+
+    // k-way merge over the next event (start or end coordinate) of each file.
+    LoserTree<CHRPOS>        events;
+    static const CHRPOS      NO_EVENT = UINT_MAX;
+
+    // cached output columns. the per-file 0/1 columns have a fixed width,
+    // so they are updated in place; the list of files with coverage is
+    // rebuilt only when a depth has changed since the last row.
+    std::string              depth_columns;
+    std::string              file_list;
+    bool                     file_list_dirty;
     std::string              current_chrom;
     map<int, bool>           files_with_coverage;
     int                      current_non_zero_inputs;
@@ -81,6 +98,27 @@ private:
      */
     void AddInterval(int index);
 
+    /*
+       Build the event tree for the current chromosome from the next
+       event of each file.
+     */
+    void InitEvents();
+
+    /*
+       Returns the coordinate of the next event (the end of the current
+       interval, or the start of the next one) for file 'index', or
+       NO_EVENT if the file has no more intervals on the current chromosome.
+     */
+    CHRPOS NextEvent(int index);
+
+    /*
+       Updates the coverage information of file 'index' at its next event,
+       which is either a START coordinate or an END coordiante.
+     */
+    void UpdateInformation(int index);
+
+    void SetDepth(int index, int depth);
+
     /*
        Loads the next interval from Bed file 'index'.
        Stores it in 'current_bed_item' vector.
@@ -107,8 +145,6 @@ private:
        prints chrom/start/end and the ZERO depth coverage values of all the files.
      */
     void PrintEmptyCoverage(CHRPOS start, CHRPOS end);
-
-    void DebugPrintQueue();
 };
 
 
@@ -50,6 +50,7 @@ BedIntersectPE::BedIntersectPE(string bedAFilePE, string bedBFile, float overlap
 
     _bedA = new BedFilePE(bedAFilePE);
     _bedB = new BedFile(bedBFile);
+    _bIndex = NULL;
 
     if (_bamInput == false)
         IntersectBedPE();
@@ -63,16 +64,17 @@ BedIntersectPE::BedIntersectPE(string bedAFilePE, string bedBFile, float overlap
 */
 
 BedIntersectPE::~BedIntersectPE(void) {
+    delete _bIndex;
 }
 
 
 
-void BedIntersectPE::FindOverlaps(const BEDPE &a, vector<BED> &hits1, vector<BED> &hits2, const string &type) {
+void BedIntersectPE::FindOverlaps(const BEDPE &a, vector<size_t> &hits1, vector<size_t> &hits2, const string &type) {
 
     // list of hits on each end of BEDPE
     // that exceed the requested overlap fraction
-    vector<BED> qualityHits1;
-    vector<BED> qualityHits2;
+    vector<size_t> qualityHits1;
+    vector<size_t> qualityHits2;
 
     // count of hits on each end of BEDPE
     // that exceed the requested overlap fraction
@@ -82,15 +84,14 @@ void BedIntersectPE::FindOverlaps(const BEDPE &a, vector<BED> &hits1, vector<BED
     // make sure we have a valid chromosome before we search
     if (a.chrom1 != ".") {
         // Find the quality hits between ***end1*** of the BEDPE and the B BED file
-        _bedB->allHits(a.chrom1, a.start1, a.end1, a.strand1, 
-                       hits1, _sameStrand, _diffStrand, 0.0, false);
+        _bIndex->allHits(a.chrom1, a.start1, a.end1, a.strand1, 
+                         hits1, _sameStrand, _diffStrand, 0.0, false);
 
-        vector<BED>::const_iterator h = hits1.begin();
-        vector<BED>::const_iterator hitsEnd = hits1.end();
-        for (; h != hitsEnd; ++h) {
+        for (size_t i = 0; i < hits1.size(); ++i) {
+            const BED &h = _bIndex->Get(hits1[i]);
 
-            int s = max(a.start1, h->start);
-            int e = min(a.end1, h->end);
+            int s = max(a.start1, h.start);
+            int e = min(a.end1, h.end);
             int overlapBases = (e - s);             // the number of overlapping bases b/w a and b
             int aLength = (a.end1 - a.start1);      // the length of a in b.p.
 
@@ -100,10 +101,10 @@ void BedIntersectPE::FindOverlaps(const BEDPE &a, vector<BED> &hits1, vector<BED
 
                 if (type == "either") {
                     _bedA->reportBedPETab(a);
-                    _bedB->reportBedNewLine(*h);
+                    _bedB->reportBedNewLine(h);
                 }
                 else {
-                    qualityHits1.push_back(*h);
+                    qualityHits1.push_back(hits1[i]);
                 }
             }
         }
@@ -113,15 +114,14 @@ void BedIntersectPE::FindOverlaps(const BEDPE &a, vector<BED> &hits1, vector<BED
     // make sure we have a valid chromosome before we search
     if (a.chrom2 != ".") {
         // Now find the quality hits between ***end2*** of the BEDPE and the B BED file
-        _bedB->allHits(a.chrom2, a.start2, a.end2, a.strand2, 
-                       hits2, _sameStrand, _diffStrand, 0.0, false);
+        _bIndex->allHits(a.chrom2, a.start2, a.end2, a.strand2, 
+                         hits2, _sameStrand, _diffStrand, 0.0, false);
 
-        vector<BED>::const_iterator h = hits2.begin();
-        vector<BED>::const_iterator hitsEnd = hits2.end();
-        for (; h != hitsEnd; ++h) {
+        for (size_t i = 0; i < hits2.size(); ++i) {
+            const BED &h = _bIndex->Get(hits2[i]);
 
-            int s = max(a.start2, h->start);
-            int e = min(a.end2, h->end);
+            int s = max(a.start2, h.start);
+            int e = min(a.end2, h.end);
             int overlapBases = (e - s);             // the number of overlapping bases b/w a and b
             int aLength = (a.end2 - a.start2);      // the length of a in b.p.
 
@@ -131,10 +131,10 @@ void BedIntersectPE::FindOverlaps(const BEDPE &a, vector<BED> &hits1, vector<BED
 
                 if (type == "either") {
                     _bedA->reportBedPETab(a);
-                    _bedB->reportBedNewLine(*h);
+                    _bedB->reportBedNewLine(h);
                 }
                 else {
-                    qualityHits2.push_back(*h);
+                    qualityHits2.push_back(hits2[i]);
                 }
             }
         }
@@ -151,41 +151,41 @@ void BedIntersectPE::FindOverlaps(const BEDPE &a, vector<BED> &hits1, vector<BED
             _bedA->reportBedPENewLine(a);
         }
         else if ( (numOverlapsEnd1 > 0) && (numOverlapsEnd2 == 0) ) {
-            for (vector<BED>::iterator q = qualityHits1.begin(); q != qualityHits1.end(); ++q) {
+            for (vector<size_t>::iterator q = qualityHits1.begin(); q != qualityHits1.end(); ++q) {
                 _bedA->reportBedPETab(a);
-                _bedB->reportBedNewLine(*q);
+                _bedB->reportBedNewLine(_bIndex->Get(*q));
             }
         }
         else if ( (numOverlapsEnd1 == 0) && (numOverlapsEnd2 > 0) ) {
-            for (vector<BED>::iterator q = qualityHits2.begin(); q != qualityHits2.end(); ++q) {
+            for (vector<size_t>::iterator q = qualityHits2.begin(); q != qualityHits2.end(); ++q) {
                 _bedA->reportBedPETab(a);
-                _bedB->reportBedNewLine(*q);
+                _bedB->reportBedNewLine(_bIndex->Get(*q));
             }
         }
     }
     else if (type == "xor") {
         if ( (numOverlapsEnd1 > 0) && (numOverlapsEnd2 == 0) ) {
-            for (vector<BED>::iterator q = qualityHits1.begin(); q != qualityHits1.end(); ++q) {
+            for (vector<size_t>::iterator q = qualityHits1.begin(); q != qualityHits1.end(); ++q) {
                 _bedA->reportBedPETab(a);
-                _bedB->reportBedNewLine(*q);
+                _bedB->reportBedNewLine(_bIndex->Get(*q));
             }
         }
         else if ( (numOverlapsEnd1 == 0) && (numOverlapsEnd2 > 0) ) {
-            for (vector<BED>::iterator q = qualityHits2.begin(); q != qualityHits2.end(); ++q) {
+            for (vector<size_t>::iterator q = qualityHits2.begin(); q != qualityHits2.end(); ++q) {
                 _bedA->reportBedPETab(a);
-                _bedB->reportBedNewLine(*q);
+                _bedB->reportBedNewLine(_bIndex->Get(*q));
             }
         }
     }
     else if (type == "both") {
         if ( (numOverlapsEnd1 > 0) && (numOverlapsEnd2 > 0) ) {
-            for (vector<BED>::iterator q = qualityHits1.begin(); q != qualityHits1.end(); ++q) {
+            for (vector<size_t>::iterator q = qualityHits1.begin(); q != qualityHits1.end(); ++q) {
                 _bedA->reportBedPETab(a);
-                _bedB->reportBedNewLine(*q);
+                _bedB->reportBedNewLine(_bIndex->Get(*q));
             }
-            for (vector<BED>::iterator q = qualityHits2.begin(); q != qualityHits2.end(); ++q) {
+            for (vector<size_t>::iterator q = qualityHits2.begin(); q != qualityHits2.end(); ++q) {
                 _bedA->reportBedPETab(a);
-                _bedB->reportBedNewLine(*q);
+                _bedB->reportBedNewLine(_bIndex->Get(*q));
             }
         }
     }
@@ -201,8 +201,8 @@ bool BedIntersectPE::FindOneOrMoreOverlaps(const BEDPE &a, const string &type) {
 
     // Look for overlaps in end 1 assuming we have an aligned chromosome.
     if (a.chrom1 != ".") {
-        end1Found = _bedB->anyHits(a.chrom1, a.start1, a.end1, a.strand1,
-                                   _sameStrand, _diffStrand, _overlapFraction, false);
+        end1Found = _bIndex->anyHits(a.chrom1, a.start1, a.end1, a.strand1,
+                                     _sameStrand, _diffStrand, _overlapFraction, false);
 
         // can we bail out without checking end2?
         if ((type == "either") && (end1Found == true)) return true;
@@ -213,8 +213,8 @@ bool BedIntersectPE::FindOneOrMoreOverlaps(const BEDPE &a, const string &type) {
 
     // Now look for overlaps in end 2 assuming we have an aligned chromosome.
     if (a.chrom2 != ".") {
-        end2Found = _bedB->anyHits(a.chrom2, a.start2, a.end2, a.strand2,
-                                   _sameStrand, _diffStrand, _overlapFraction, false);
+        end2Found = _bIndex->anyHits(a.chrom2, a.start2, a.end2, a.strand2,
+                                     _sameStrand, _diffStrand, _overlapFraction, false);
 
         if ((type == "either") && (end2Found == true)) return true;
         else if ((type == "neither") && (end2Found == true)) return false;
@@ -247,7 +247,7 @@ bool BedIntersectPE::FindOneOrMoreOverlaps(const BEDPE &a, const string &type) {
 }
 
 
-void BedIntersectPE::FindSpanningOverlaps(const BEDPE &a, vector<BED> &hits, const string &type) {
+void BedIntersectPE::FindSpanningOverlaps(const BEDPE &a, vector<size_t> &hits, const string &type) {
 
     // count of hits on _between_ end of BEDPE
     // that exceed the requested overlap fraction
@@ -275,15 +275,14 @@ void BedIntersectPE::FindSpanningOverlaps(const BEDPE &a, vector<BED> &hits, con
     spanLength = spanEnd - spanStart;
 
     // get the hits for the span
-    _bedB->allHits(a.chrom1, spanStart, spanEnd, a.strand1, 
-                   hits, _sameStrand, _diffStrand, 0.0, false);
+    _bIndex->allHits(a.chrom1, spanStart, spanEnd, a.strand1, 
+                     hits, _sameStrand, _diffStrand, 0.0, false);
 
-    vector<BED>::const_iterator h = hits.begin();
-    vector<BED>::const_iterator hitsEnd = hits.end();
-    for (; h != hitsEnd; ++h) {
+    for (size_t i = 0; i < hits.size(); ++i) {
+        const BED &h = _bIndex->Get(hits[i]);
 
-        int s = max(spanStart, h->start);
-        int e = min(spanEnd, h->end);
+        int s = max(spanStart, h.start);
+        int e = min(spanEnd, h.end);
         int overlapBases = (e - s);                     // the number of overlapping bases b/w a and b
         int spanLength = (spanEnd - spanStart);     // the length of a in b.p.
 
@@ -292,7 +291,7 @@ void BedIntersectPE::FindSpanningOverlaps(const BEDPE &a, vector<BED> &hits, con
             numOverlaps++;
             if ((type == "ispan") || (type == "ospan")) {
                 _bedA->reportBedPETab(a);
-                _bedB->reportBedNewLine(*h);
+                _bedB->reportBedNewLine(h);
             }
         }
     }
@@ -328,8 +327,8 @@ bool BedIntersectPE::FindOneOrMoreSpanningOverlaps(const BEDPE &a, const string
     }
     spanLength = spanEnd - spanStart;
 
-    overlapFound = _bedB->anyHits(a.chrom1, spanStart, spanEnd, a.strand1,
-                                  _sameStrand, _diffStrand, _overlapFraction, false);
+    overlapFound = _bIndex->anyHits(a.chrom1, spanStart, spanEnd, a.strand1,
+                                    _sameStrand, _diffStrand, _overlapFraction, false);
 
     return overlapFound;
 }
@@ -337,12 +336,12 @@ bool BedIntersectPE::FindOneOrMoreSpanningOverlaps(const BEDPE &a, const string
 
 void BedIntersectPE::IntersectBedPE() {
 
-    // load the "B" bed file into a map so
+    // load the "B" bed file into an index so
     // that we can easily compare "A" to it for overlaps
-    _bedB->loadBedFileIntoMap();
+    _bIndex = new BedIndex(_bedB);
 
     int lineNum = 0;                    // current input line number
-    vector<BED> hits, hits1, hits2;     // vector of potential hits
+    vector<size_t> hits, hits1, hits2;     // vector of potential hits
 
     // reserve some space
     hits.reserve(100);
@@ -376,9 +375,9 @@ void BedIntersectPE::IntersectBedPE() {
 
 void BedIntersectPE::IntersectBamPE(string bamFile) {
 
-    // load the "B" bed file into a map so
+    // load the "B" bed file into an index so
     // that we can easily compare "A" to it for overlaps
-    _bedB->loadBedFileIntoMap();
+    _bIndex = new BedIndex(_bedB);
 
     // open the BAM file
     BamReader reader;
@@ -445,7 +444,7 @@ void BedIntersectPE::IntersectBamPE(string bamFile) {
 void BedIntersectPE::ProcessBamBlock (const BamAlignment &bam1, const BamAlignment &bam2,
                                       const RefVector &refs, BamWriter &writer) {
 
-    vector<BED> hits, hits1, hits2;         // vector of potential hits
+    vector<size_t> hits, hits1, hits2;         // vector of potential hits
     hits.reserve(1000);                     // reserve some space
     hits1.reserve(1000);
     hits2.reserve(1000);
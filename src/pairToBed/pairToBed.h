@@ -19,6 +19,7 @@ using namespace BamTools;
 
 #include "bedFile.h"
 #include "bedFilePE.h"
+#include "bedIndex.h"
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -47,11 +48,11 @@ public:
     // destructor
     ~BedIntersectPE(void);
 
-    void FindOverlaps(const BEDPE &, vector<BED> &hits1, vector<BED> &hits2, const string &type);
+    void FindOverlaps(const BEDPE &, vector<size_t> &hits1, vector<size_t> &hits2, const string &type);
 
     bool FindOneOrMoreOverlaps(const BEDPE &, const string &type);
 
-    void FindSpanningOverlaps(const BEDPE &a, vector<BED> &hits, const string &type);
+    void FindSpanningOverlaps(const BEDPE &a, vector<size_t> &hits, const string &type);
     bool FindOneOrMoreSpanningOverlaps(const BEDPE &a, const string &type);
 
     void IntersectBedPE();
@@ -77,6 +78,8 @@ private:
 
     // instance of a bed file class.
     BedFile *_bedB;
+    // B, indexed for searching.
+    BedIndex *_bIndex;
 
     inline
     void ConvertBamToBedPE(const BamAlignment &bam1, const BamAlignment &bam2, const RefVector &refs, BEDPE &a) {
@@ -45,9 +45,9 @@ PairToPair::~PairToPair(void) {
 
 void PairToPair::IntersectPairs() {
 
-    // load the "B" bed file into a map so
+    // load the "B" bed file into an index so
     // that we can easily compare "A" to it for overlaps
-    _bedB->loadBedPEFileIntoMap();
+    _bedB->loadBedPEFileIntoIndex();
 
     int lineNum = 0;
     BedLineStatus bedStatus;
@@ -69,7 +69,7 @@ void PairToPair::IntersectPairs() {
 
 void PairToPair::FindOverlaps(const BEDPE &a) {
     //
-    vector<MATE> hitsA1B1, hitsA1B2, hitsA2B1, hitsA2B2;
+    vector<size_t> hitsA1B1, hitsA1B2, hitsA2B1, hitsA2B2;
 
     // add the appropriate slop to the starts and ends
     int start1 = a.start1;
@@ -81,11 +81,11 @@ void PairToPair::FindOverlaps(const BEDPE &a) {
         if (a.strand1 == "+")
             end1   += _slop;
         else
-            start1 -= _slop;
+            (start1 - _slop) >= 0 ? start1 -= _slop : start1 = 0;
         if (a.strand2 == "+")
             end2   += _slop;
         else
-            start2 -= _slop;
+            (start2 - _slop) >= 0 ? start2 -= _slop : start2 = 0;
     }
     else {
         (start1 - _slop) >= 0 ? start1 -= _slop : start1 = 0;
@@ -95,10 +95,10 @@ void PairToPair::FindOverlaps(const BEDPE &a) {
     }
 
     // Find the _potential_ hits between each end of A and B
-    _bedB->FindOverlapsPerBin(1, a.chrom1, start1, end1, a.name, a.strand1, hitsA1B1, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A1 & B1
-    _bedB->FindOverlapsPerBin(1, a.chrom2, start2, end2, a.name, a.strand2, hitsA2B1, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A2 & B1
-    _bedB->FindOverlapsPerBin(2, a.chrom1, start1, end1, a.name, a.strand1, hitsA1B2, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A1 & B2
-    _bedB->FindOverlapsPerBin(2, a.chrom2, start2, end2, a.name, a.strand2, hitsA2B2, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A2 & B2
+    _bedB->FindOverlapsInIndex(1, a.chrom1, start1, end1, a.name, a.strand1, hitsA1B1, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A1 & B1
+    _bedB->FindOverlapsInIndex(1, a.chrom2, start2, end2, a.name, a.strand2, hitsA2B1, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A2 & B1
+    _bedB->FindOverlapsInIndex(2, a.chrom1, start1, end1, a.name, a.strand1, hitsA1B2, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A1 & B2
+    _bedB->FindOverlapsInIndex(2, a.chrom2, start2, end2, a.name, a.strand2, hitsA2B2, _overlapFraction, !(_ignoreStrand), _reqDiffNames);   // hits b/w A2 & B2
 
     unsigned int matchCount1 = (hitsA1B1.size() + hitsA2B2.size());
     unsigned int matchCount2 = (hitsA2B1.size() + hitsA1B2.size());
@@ -133,27 +133,34 @@ void PairToPair::FindOverlaps(const BEDPE &a) {
 }
 
 
-bool PairToPair::FindHitsOnBothEnds(const BEDPE &a, const vector<MATE> &qualityHitsEnd1,
-                                    const vector<MATE> &qualityHitsEnd2) {
+void PairToPair::GroupHitsByEntry(const vector<size_t> &qualityHitsEnd1,
+                                  const vector<size_t> &qualityHitsEnd2,
+                                  map<size_t, vector<const MATE *> > &hitsMap) {
 
-    map<unsigned int, vector<MATE>, less<unsigned int> > hitsMap;
-
-    for (vector<MATE>::const_iterator h = qualityHitsEnd1.begin(); h != qualityHitsEnd1.end(); ++h) {
-        hitsMap[h->lineNum].push_back(*h);
+    // the two ends of a B entry share an index.
+    for (vector<size_t>::const_iterator h = qualityHitsEnd1.begin(); h != qualityHitsEnd1.end(); ++h) {
+        hitsMap[*h].push_back(&_bedB->mates1[*h]);
     }
-    for (vector<MATE>::const_iterator h = qualityHitsEnd2.begin(); h != qualityHitsEnd2.end(); ++h) {
-        hitsMap[h->lineNum].push_back(*h);
+    for (vector<size_t>::const_iterator h = qualityHitsEnd2.begin(); h != qualityHitsEnd2.end(); ++h) {
+        hitsMap[*h].push_back(&_bedB->mates2[*h]);
     }
+}
+
+
+bool PairToPair::FindHitsOnBothEnds(const BEDPE &a, const vector<size_t> &qualityHitsEnd1,
+                                    const vector<size_t> &qualityHitsEnd2) {
 
+    map<size_t, vector<const MATE *> > hitsMap;
+    GroupHitsByEntry(qualityHitsEnd1, qualityHitsEnd2, hitsMap);
 
     bool bothFound = false;
-    for (map<unsigned int, vector<MATE>, less<unsigned int> >::iterator m = hitsMap.begin(); m != hitsMap.end(); ++m) {
+    for (map<size_t, vector<const MATE *> >::iterator m = hitsMap.begin(); m != hitsMap.end(); ++m) {
         
         // hits on both sides
         if (m->second.size() >= 2) {
             bothFound = true;
-            MATE b1 = m->second[0];
-            MATE b2 = m->second[1];
+            const MATE &b1 = *m->second[0];
+            const MATE &b2 = *m->second[1];
 
             if (_searchType == "both") {
                 _bedA->reportBedPETab(a);
@@ -171,24 +178,18 @@ bool PairToPair::FindHitsOnBothEnds(const BEDPE &a, const vector<MATE> &qualityH
 }
 
 
-void PairToPair::FindHitsOnEitherEnd(const BEDPE &a, const vector<MATE> &qualityHitsEnd1,
-                                    const vector<MATE> &qualityHitsEnd2) {
+void PairToPair::FindHitsOnEitherEnd(const BEDPE &a, const vector<size_t> &qualityHitsEnd1,
+                                    const vector<size_t> &qualityHitsEnd2) {
 
-    map<unsigned int, vector<MATE>, less<unsigned int> > hitsMap;
-
-    for (vector<MATE>::const_iterator h = qualityHitsEnd1.begin(); h != qualityHitsEnd1.end(); ++h) {
-        hitsMap[h->lineNum].push_back(*h);
-    }
-    for (vector<MATE>::const_iterator h = qualityHitsEnd2.begin(); h != qualityHitsEnd2.end(); ++h) {
-        hitsMap[h->lineNum].push_back(*h);
-    }
+    map<size_t, vector<const MATE *> > hitsMap;
+    GroupHitsByEntry(qualityHitsEnd1, qualityHitsEnd2, hitsMap);
 
-    for (map<unsigned int, vector<MATE>, less<unsigned int> >::iterator m = hitsMap.begin(); m != hitsMap.end(); ++m) {
+    for (map<size_t, vector<const MATE *> >::iterator m = hitsMap.begin(); m != hitsMap.end(); ++m) {
         if (m->second.size() >= 1) {
 
             if ((m->second.size()) == 2) {
-                MATE b1 = m->second[0];
-                MATE b2 = m->second[1];
+                const MATE &b1 = *m->second[0];
+                const MATE &b2 = *m->second[1];
 
                 _bedA->reportBedPETab(a);
                 printf("%s\t%d\t%d\t%s\t%d\t%d\t%s\t%s\t%s\t%s", b1.bed.chrom.c_str(), b1.bed.start, b1.bed.end,
@@ -200,7 +201,7 @@ void PairToPair::FindHitsOnEitherEnd(const BEDPE &a, const vector<MATE> &quality
                 printf("\n");
             }
             else {
-                MATE b1 = m->second[0];
+                const MATE &b1 = *m->second[0];
 
                 _bedA->reportBedPETab(a);
                 printf("%s\t%d\t%d\t%s\t%d\t%d\t%s\t%s\t%s\t%s", b1.bed.chrom.c_str(), b1.bed.start, b1.bed.end,
@@ -65,11 +65,16 @@ private:
     void FindQualityHitsBetweenEnds(CHRPOS start, CHRPOS end,
         const vector<MATE> &hits, vector<MATE> &qualityHits, int &numOverlaps);
 
-    bool FindHitsOnBothEnds(const BEDPE &a, const vector<MATE> &qualityHitsEnd1,
-        const vector<MATE> &qualityHitsEnd2);
+    // the hits on end1 and end2 of B, as indexes into its mates1 and mates2.
+    bool FindHitsOnBothEnds(const BEDPE &a, const vector<size_t> &qualityHitsEnd1,
+        const vector<size_t> &qualityHitsEnd2);
 
-    void FindHitsOnEitherEnd(const BEDPE &a, const vector<MATE> &qualityHitsEnd1,
-        const vector<MATE> &qualityHitsEnd2);
+    void FindHitsOnEitherEnd(const BEDPE &a, const vector<size_t> &qualityHitsEnd1,
+        const vector<size_t> &qualityHitsEnd2);
+
+    void GroupHitsByEntry(const vector<size_t> &qualityHitsEnd1,
+        const vector<size_t> &qualityHitsEnd2,
+        map<size_t, vector<const MATE *> > &hitsMap);
 
 };
 
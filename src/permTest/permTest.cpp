@@ -0,0 +1,288 @@
+/*****************************************************************************
+  permTest.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#include "permTest.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <pthread.h>
+
+
+PermTest::PermTest(string &bedAFile, string &bedBFile,
+                   string &genomeFile, string &excludeFile,
+                   bool haveExclude, Statistic stat, int numPerms,
+                   uint64_t seed, int numThreads, bool sameChrom,
+                   bool printNull)
+: _bedAFile(bedAFile),
+  _bedBFile(bedBFile),
+  _stat(stat),
+  _numPerms(numPerms),
+  _seed(seed),
+  _numThreads(numThreads),
+  _sameChrom(sameChrom),
+  _printNull(printNull),
+  _observed(0)
+{
+    _genome = new GenomeFile(genomeFile);
+    _chroms = _genome->getChromList();
+    for (size_t i = 0; i < _chroms.size(); i++) {
+        _chromIds[_chroms[i]] = (int)i;
+    }
+
+    LoadIntervals(_bedAFile, _a);
+    LoadIntervals(_bedBFile, _b);
+
+    // -b never moves, so merge it once.
+    sort(_b.begin(), _b.end());
+    vector<PermInterval> merged;
+    for (size_t i = 0; i < _b.size(); i++) {
+        if (!merged.empty() && merged.back().chromId == _b[i].chromId &&
+            _b[i].start <= merged.back().end)
+        {
+            merged.back().end = max(merged.back().end, _b[i].end);
+        }
+        else {
+            merged.push_back(_b[i]);
+        }
+    }
+    _b.swap(merged);
+
+    BuildAllowedSpace(excludeFile, haveExclude);
+}
+
+
+PermTest::~PermTest(void) {
+    delete _genome;
+}
+
+
+int PermTest::GetChromId(string &chrom) {
+    // chroms that aren't in the genome file still get an id, so
+    // that the observed statistic counts them.
+    map<string, int>::const_iterator id = _chromIds.find(chrom);
+    if (id != _chromIds.end())
+        return id->second;
+    int newId = (int)_chromIds.size();
+    _chromIds[chrom] = newId;
+    return newId;
+}
+
+
+void PermTest::LoadIntervals(string &bedFile, 
+                             vector<PermInterval> &intervals) 
+{
+    BedFile bed(bedFile);
+    BED bedEntry;
+    PermInterval interval;
+    bed.Open();
+    while (bed.GetNextBed(bedEntry)) {
+        if (bed._status == BED_VALID) {
+            interval.chromId = GetChromId(bedEntry.chrom);
+            interval.start   = bedEntry.start;
+            interval.end     = bedEntry.end;
+            intervals.push_back(interval);
+        }
+    }
+    bed.Close();
+}
+
+
+void PermTest::BuildAllowedSpace(string &excludeFile, bool haveExclude) {
+
+    int numChroms = (int)_chroms.size();
+    vector< vector< pair<CHRPOS, CHRPOS> > > excluded(numChroms);
+    if (haveExclude) {
+        BedFile exclude(excludeFile);
+        BED bedEntry;
+        exclude.Open();
+        while (exclude.GetNextBed(bedEntry)) {
+            if (exclude._status != BED_VALID)
+                continue;
+            map<string, int>::const_iterator id = _chromIds.find(bedEntry.chrom);
+            if (id != _chromIds.end() && id->second < numChroms)
+                excluded[id->second].push_back(make_pair(bedEntry.start, 
+                                                         bedEntry.end));
+        }
+        exclude.Close();
+    }
+    if (_sameChrom)
+        _allowedByChrom.resize(numChroms);
+    for (int c = 0; c < numChroms; c++) {
+        CHRPOS chromSize = _genome->getChromSize(_chroms[c]);
+        if (_sameChrom)
+            _allowedByChrom[c].addChrom(c, chromSize, excluded[c], false);
+        _allowed.addChrom(c, chromSize, excluded[c], false);
+    }
+    _allowed.prepare();
+    for (int c = 0; c < (int)_allowedByChrom.size(); c++)
+        _allowedByChrom[c].prepare();
+
+    // every -a feature has to fit somewhere, or the permutations
+    // would quietly test a smaller set than the observed one.
+    int chromId;
+    CHRPOS start;
+    for (size_t i = 0; i < _a.size(); i++) {
+        AllowedSpace *space = &_allowed;
+        if (_sameChrom) {
+            space = (_a[i].chromId < numChroms) ? 
+                    &_allowedByChrom[_a[i].chromId] : NULL;
+        }
+        if (space == NULL || 
+            !space->choose(_a[i].end - _a[i].start, 0, chromId, start))
+        {
+            cerr << "Error: feature " << i + 1 << " in " << _bedAFile
+                 << " can't be placed anywhere in the genome"
+                 << (haveExclude ? " outside of -excl." : ".") << endl;
+            exit(1);
+        }
+    }
+}
+
+
+void PermTest::Shuffle(uint64_t perm, vector<PermInterval> &shuffled) {
+    // each permutation has its own stream, so the null
+    // distribution doesn't depend on how many threads ran it.
+    RandomStream rng(_seed, perm);
+    shuffled.resize(_a.size());
+    for (size_t i = 0; i < _a.size(); i++) {
+        CHRPOS length = _a[i].end - _a[i].start;
+        AllowedSpace &space = _sameChrom ? 
+                              _allowedByChrom[_a[i].chromId] : _allowed;
+        space.choose(length, rng.next(), shuffled[i].chromId, 
+                     shuffled[i].start);
+        shuffled[i].end = shuffled[i].start + length;
+    }
+}
+
+
+double PermTest::Evaluate(vector<PermInterval> &a) {
+
+    sort(a.begin(), a.end());
+    size_t j = 0;
+
+    if (_stat == OVERLAPS) {
+        // -a features that overlap -b by at least 1bp.
+        // -b is merged, so only the first one that ends
+        // after a feature starts can overlap it.
+        size_t count = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            while (j < _b.size() && 
+                   (_b[j].chromId < a[i].chromId || 
+                    (_b[j].chromId == a[i].chromId && _b[j].end <= a[i].start)))
+                j++;
+            if (j < _b.size() && _b[j].chromId == a[i].chromId && 
+                _b[j].start < a[i].end)
+                count++;
+        }
+        return (double)count;
+    }
+
+    // JACCARD: as in "bedtools jaccard", the intersection of
+    // the merged sets over their union.
+    uint64_t intersection = 0, aLen = 0, bLen = 0;
+    for (size_t k = 0; k < _b.size(); k++)
+        bLen += _b[k].end - _b[k].start;
+    size_t i = 0;
+    while (i < a.size()) {
+        int chromId = a[i].chromId;
+        CHRPOS start = a[i].start;
+        CHRPOS end = a[i].end;
+        for (i++; i < a.size() && a[i].chromId == chromId && 
+                  a[i].start <= end; i++)
+            end = max(end, a[i].end);
+        aLen += end - start;
+
+        while (j < _b.size() && 
+               (_b[j].chromId < chromId || 
+                (_b[j].chromId == chromId && _b[j].end <= start)))
+            j++;
+        for (size_t k = j; k < _b.size() && _b[k].chromId == chromId && 
+                           _b[k].start < end; k++)
+            intersection += min(end, _b[k].end) - max(start, _b[k].start);
+    }
+    uint64_t unionLen = aLen + bLen - intersection;
+    return (unionLen > 0) ? (double)intersection / unionLen : 0;
+}
+
+
+void PermTest::RunPermutations(int threadNum) {
+    vector<PermInterval> shuffled;
+    for (int perm = threadNum; perm < _numPerms; perm += _numThreads) {
+        Shuffle(perm, shuffled);
+        _null[perm] = Evaluate(shuffled);
+    }
+}
+
+
+struct PermThread {
+    PermTest *permTest;
+    int threadNum;
+};
+
+static void *runPermThread(void *arg) {
+    PermThread *thread = (PermThread *)arg;
+    thread->permTest->RunPermutations(thread->threadNum);
+    return NULL;
+}
+
+
+void PermTest::Run() {
+    vector<PermInterval> a(_a);
+    _observed = Evaluate(a);
+
+    _null.assign(_numPerms, 0);
+    vector<pthread_t> threads(_numThreads);
+    vector<PermThread> args(_numThreads);
+    for (int t = 0; t < _numThreads; t++) {
+        args[t].permTest  = this;
+        args[t].threadNum = t;
+        if (pthread_create(&threads[t], NULL, runPermThread, &args[t]) != 0) {
+            cerr << "Error: unable to start thread " << t + 1 << "." << endl;
+            exit(1);
+        }
+    }
+    for (int t = 0; t < _numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    Report();
+}
+
+
+void PermTest::Report() {
+    const char *statName = (_stat == JACCARD) ? "jaccard" : "overlaps";
+
+    if (_printNull) {
+        cout << "perm\t" << statName << endl;
+        for (int perm = 0; perm < _numPerms; perm++)
+            cout << perm + 1 << "\t" << _null[perm] << endl;
+        return;
+    }
+
+    // sums are taken about the first value, so that a constant
+    // null has a mean that's exactly that value and an sd of 0.
+    double shift = _null[0];
+    double sum = 0, sumSq = 0;
+    int numGreater = 0, numLess = 0;
+    for (int perm = 0; perm < _numPerms; perm++) {
+        double diff = _null[perm] - shift;
+        sum   += diff;
+        sumSq += diff * diff;
+        if (_null[perm] >= _observed) numGreater++;
+        if (_null[perm] <= _observed) numLess++;
+    }
+    double mean = shift + sum / _numPerms;
+    double sd = 0;
+    if (_numPerms > 1)
+        sd = sqrt(max(0.0, (sumSq - sum * sum / _numPerms) / (_numPerms - 1)));
+
+    // the observed set counts as one of the permutations, so
+    // p is never 0.
+    cout << "statistic\tobserved\tnull_mean\tnull_sd\tn_perm\tp_greater\tp_less" 
+         << endl;
+    cout << statName << "\t" << _observed << "\t" << mean << "\t" << sd 
+         << "\t" << _numPerms 
+         << "\t" << (numGreater + 1.0) / (_numPerms + 1) 
+         << "\t" << (numLess + 1.0) / (_numPerms + 1) << endl;
+}
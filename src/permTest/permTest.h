@@ -0,0 +1,93 @@
+/*****************************************************************************
+  permTest.h
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#ifndef PERMTEST_H
+#define PERMTEST_H
+
+#include "bedFile.h"
+#include "GenomeFile.h"
+#include "allowedSpace.h"
+#include "RandomStream.h"
+
+#include <vector>
+#include <iostream>
+#include <map>
+#include <string>
+using namespace std;
+
+
+struct PermInterval {
+    int chromId;
+    CHRPOS start;
+    CHRPOS end;
+    bool operator<(const PermInterval &other) const {
+        if (chromId != other.chromId) return chromId < other.chromId;
+        if (start != other.start) return start < other.start;
+        return end < other.end;
+    }
+};
+
+
+//************************************************
+// Class methods and elements
+//************************************************
+class PermTest {
+
+public:
+
+    enum Statistic { JACCARD, OVERLAPS };
+
+    // constructor
+    PermTest(string &bedAFile, string &bedBFile,
+             string &genomeFile, string &excludeFile,
+             bool haveExclude, Statistic stat, int numPerms,
+             uint64_t seed, int numThreads, bool sameChrom,
+             bool printNull);
+
+    // destructor
+    ~PermTest(void);
+
+    // shuffle -a numPerms times and report the null
+    // distribution of the statistic.
+    void Run();
+
+    // run by each thread: permutations threadNum,
+    // threadNum + numThreads, ...
+    void RunPermutations(int threadNum);
+
+private:
+
+    string _bedAFile;
+    string _bedBFile;
+    Statistic _stat;
+    int _numPerms;
+    uint64_t _seed;
+    int _numThreads;
+    bool _sameChrom;
+    bool _printNull;
+
+    GenomeFile *_genome;
+    vector<string> _chroms;
+    map<string, int> _chromIds;
+
+    // -a as given, and -b merged and sorted.
+    vector<PermInterval> _a;
+    vector<PermInterval> _b;
+    // where -a may be shuffled to, genome-wide and by chrom.
+    AllowedSpace _allowed;
+    vector<AllowedSpace> _allowedByChrom;
+
+    double _observed;
+    vector<double> _null;
+
+    int GetChromId(string &chrom);
+    void LoadIntervals(string &bedFile, vector<PermInterval> &intervals);
+    void BuildAllowedSpace(string &excludeFile, bool haveExclude);
+    void Shuffle(uint64_t perm, vector<PermInterval> &shuffled);
+    double Evaluate(vector<PermInterval> &a);
+    void Report();
+};
+
+#endif /* PERMTEST_H */
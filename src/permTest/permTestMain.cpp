@@ -0,0 +1,232 @@
+/*****************************************************************************
+  permTestMain.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#include "permTest.h"
+#include "version.h"
+#include "ParseTools.h"
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+using namespace std;
+
+// define our program name
+#define PROGRAM_NAME "bedtools permtest"
+
+
+// define our parameter checking macro
+#define PARAMETER_CHECK(param, paramLen, actualLen) (strncmp(argv[i], param, min(actualLen, paramLen))== 0) && (actualLen == paramLen)
+
+// function declarations
+void permtest_help(void);
+
+int permtest_main(int argc, char* argv[]) {
+
+    // our configuration variables
+    bool showHelp = false;
+
+    // input files
+    string bedAFile;
+    string bedBFile;
+    string genomeFile;
+    string excludeFile;
+
+    // input arguments
+    bool haveBedA    = false;
+    bool haveBedB    = false;
+    bool haveGenome  = false;
+    bool haveExclude = false;
+    bool haveSeed    = false;
+    bool sameChrom   = false;
+    bool printNull   = false;
+    int numPerms     = 1000;
+    int numThreads   = 1;
+    uint64_t seed    = 0;
+    PermTest::Statistic stat = PermTest::JACCARD;
+
+    // check to see if we should print out some help
+    if(argc <= 1) showHelp = true;
+
+    for(int i = 1; i < argc; i++) {
+        int parameterLength = (int)strlen(argv[i]);
+
+        if((PARAMETER_CHECK("-h", 2, parameterLength)) ||
+        (PARAMETER_CHECK("--help", 5, parameterLength))) {
+            showHelp = true;
+        }
+    }
+
+    if(showHelp) permtest_help();
+
+    // do some parsing (all of these parameters require 2 strings)
+    for(int i = 1; i < argc; i++) {
+
+        int parameterLength = (int)strlen(argv[i]);
+
+        if(PARAMETER_CHECK("-a", 2, parameterLength)) {
+            if ((i+1) < argc) {
+                haveBedA = true;
+                bedAFile = argv[i + 1];
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-b", 2, parameterLength)) {
+            if ((i+1) < argc) {
+                haveBedB = true;
+                bedBFile = argv[i + 1];
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-g", 2, parameterLength)) {
+            if ((i+1) < argc) {
+                haveGenome = true;
+                genomeFile = argv[i + 1];
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-excl", 5, parameterLength)) {
+            if ((i+1) < argc) {
+                haveExclude = true;
+                excludeFile = argv[i + 1];
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-n", 2, parameterLength)) {
+            if ((i+1) < argc) {
+                numPerms = atoi(argv[i + 1]);
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-threads", 8, parameterLength)) {
+            if ((i+1) < argc) {
+                numThreads = parseNumThreads(argv[i + 1]);
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-seed", 5, parameterLength)) {
+            if ((i+1) < argc) {
+                haveSeed = true;
+                seed = strtoull(argv[i + 1], NULL, 10);
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-stat", 5, parameterLength)) {
+            if ((i+1) < argc) {
+                string statName = argv[i + 1];
+                if (statName == "jaccard")
+                    stat = PermTest::JACCARD;
+                else if (statName == "overlaps")
+                    stat = PermTest::OVERLAPS;
+                else {
+                    cerr << endl << "*****ERROR: Unrecognized statistic: " 
+                         << statName << " *****" << endl << endl;
+                    showHelp = true;
+                }
+                i++;
+            }
+        }
+        else if(PARAMETER_CHECK("-chrom", 6, parameterLength)) {
+            sameChrom = true;
+        }
+        else if(PARAMETER_CHECK("-null", 5, parameterLength)) {
+            printNull = true;
+        }
+        else {
+            cerr << endl 
+                 << "*****ERROR: Unrecognized parameter: " 
+                 << argv[i] 
+                 << " *****" 
+                 << endl << endl;
+            showHelp = true;
+        }
+    }
+
+    // make sure we have all of the input files
+    if (!haveBedA || !haveBedB || !haveGenome) {
+        cerr << endl 
+             << "*****" 
+             << endl 
+             << "*****ERROR: Need -a, -b and -g files. " 
+             << endl 
+             << "*****" 
+             << endl;
+        showHelp = true;
+    }
+    if (numPerms < 1 || numThreads < 1) {
+        cerr << endl 
+             << "*****" 
+             << endl 
+             << "*****ERROR: -n and -threads must be at least 1. " 
+             << endl 
+             << "*****" 
+             << endl;
+        showHelp = true;
+    }
+
+    if (!showHelp) {
+        if (!haveSeed)
+            seed = (uint64_t)time(0) + (uint64_t)getpid();
+
+        PermTest *pt = new PermTest(bedAFile, bedBFile, genomeFile,
+                                    excludeFile, haveExclude, stat,
+                                    numPerms, seed, numThreads,
+                                    sameChrom, printNull);
+        pt->Run();
+        delete pt;
+        return 0;
+    }
+    else {
+        permtest_help();
+        return 0;
+    }
+}
+
+void permtest_help(void) {
+
+    cerr << "\nTool:    bedtools permtest" << endl;
+    cerr << "Version: " << VERSION << "\n";    
+    cerr << "Summary: Compare a statistic b/w two feature files with the "
+         << "same statistic" << endl
+         << "\t after randomly shuffling the first file many times, "
+         << "and report" << endl
+         << "\t an empirical p-value."
+         << endl << endl;
+
+    cerr << "Usage:   " 
+         << PROGRAM_NAME 
+         << " [OPTIONS] -a <bed/gff/vcf> -b <bed/gff/vcf> -g <genome>" 
+         << endl << endl;
+
+    cerr << "Options: " << endl;
+
+    cerr << "\t-stat\t"     << "The statistic to compare:" << endl;
+    cerr                    << "\t\t- jaccard: as reported by bedtools jaccard (default)." << endl;
+    cerr                    << "\t\t- overlaps: the number of features in -a that" << endl;
+    cerr                    << "\t\t  overlap -b by at least 1bp." << endl << endl;
+
+    cerr << "\t-n\t"        << "Number of shuffles of -a. Default is 1000." << endl << endl;
+
+    cerr << "\t-threads\t"  << "Number of threads to run the shuffles with. Default is 1." << endl;
+    cerr                    << "\t\t- For a given -seed, the result is the same for any -threads." << endl << endl;
+
+    cerr << "\t-seed\t"     << "Supply an integer seed for the shuffling." << endl;
+    cerr                    << "\t\t- By default, the seed is chosen automatically." << endl << endl;
+
+    cerr << "\t-excl\t"     << "A BED/GFF/VCF file of coordinates in which features in -a" << endl;
+    cerr                    << "\t\tshould not be placed (e.g. gaps.bed)." << endl << endl;
+
+    cerr << "\t-chrom\t"    << "Keep features in -a on the same chromosome." << endl << endl;
+
+    cerr << "\t-null\t"     << "Instead of a summary, report the statistic for" << endl;
+    cerr                    << "\t\teach shuffle (the null distribution)." << endl << endl;
+
+    cerr << "Notes: " << endl;
+    cerr << "\tShuffled features stay within the chromosome ends. The p-values" << endl;
+    cerr << "\tcount the observed data as one of the shuffles, i.e. (k + 1) / (n + 1)." << endl << endl;
+
+    // end the program here
+    exit(1);
+
+}
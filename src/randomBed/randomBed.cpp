@@ -10,27 +10,28 @@
   Licenced under the GNU General Public License 2.0 license.
 ******************************************************************************/
 #include "randomBed.h"
+#include <cstdio>
+#include <pthread.h>
 
 
 BedRandom::BedRandom(string &genomeFile, uint32_t numToGenerate, int seed,
-                       bool haveSeed, uint32_t length) {
+                       bool haveSeed, uint32_t length, int numThreads) {
     _genomeFile        = genomeFile;
     _numToGenerate     = numToGenerate;
     _length            = length;
     _haveSeed          = haveSeed;
     _seed              = seed;
+    _numThreads        = numThreads;
 
     // use the supplied seed for the random
     // number generation if given.  else,
     // roll our own.
     if (_haveSeed) {
         _seed = seed;
-        srand(seed);
     }
     else {
         // thanks to Rob Long for the tip.
         _seed = (unsigned)time(0)+(unsigned)getpid();
-        srand(_seed);
     }
     Generate();
 }
@@ -40,9 +41,58 @@ BedRandom::~BedRandom(void)
 {}
 
 
+struct RandomBlockThread {
+    BedRandom *bedRandom;
+    uint32_t block;
+    string out;
+};
+
+static void *generateBlockThread(void *arg) {
+    RandomBlockThread *thread = (RandomBlockThread *)arg;
+    thread->bedRandom->GenerateBlock(thread->block, thread->out);
+    return NULL;
+}
+
+
 void BedRandom::Generate() 
 {
     _genome  = new GenomeFile(_genomeFile);
+
+    // each round, every thread makes a block, and the
+    // blocks are written in order.
+    uint32_t numBlocks = _numToGenerate / BLOCK_SIZE + 
+                         (_numToGenerate % BLOCK_SIZE != 0);
+    vector<RandomBlockThread> threads(_numThreads);
+    vector<pthread_t> threadIds(_numThreads);
+    for (uint32_t first = 0; first < numBlocks; first += _numThreads) 
+    {
+        int numRunning = 0;
+        for (int t = 0; t < _numThreads && first + t < numBlocks; t++) {
+            threads[t].bedRandom = this;
+            threads[t].block     = first + t;
+            threads[t].out.clear();
+            if (_numThreads == 1) {
+                GenerateBlock(threads[t].block, threads[t].out);
+            }
+            else if (pthread_create(&threadIds[t], NULL, 
+                                    generateBlockThread, &threads[t]) != 0) {
+                cerr << "Error: unable to start thread " << t + 1 << "." << endl;
+                exit(1);
+            }
+            numRunning++;
+        }
+        for (int t = 0; t < numRunning; t++) {
+            if (_numThreads > 1)
+                pthread_join(threadIds[t], NULL);
+            fwrite(threads[t].out.data(), 1, threads[t].out.size(), stdout);
+        }
+    }
+}
+
+
+void BedRandom::GenerateBlock(uint32_t block, string &out) 
+{
+    RandomStream rng(_seed, block);
     uint32_t genomeSize  = _genome->getGenomeSize();
     
     string chrom;
@@ -50,15 +100,14 @@ void BedRandom::Generate()
     uint32_t end;
     char strand;
     uint32_t chromSize;
-    uint32_t numGenerated = 0;
-    while (numGenerated < _numToGenerate)
+    uint32_t first = block * BLOCK_SIZE;
+    uint32_t last  = min(first + BLOCK_SIZE, _numToGenerate);
+    char line[1024];
+    for (uint32_t numGenerated = first + 1; numGenerated <= last; numGenerated++)
     {
         do 
         {
-            // we need to combine two consective calls to rand()
-            // because RAND_MAX is 2^31 (2147483648), whereas
-            // mammalian genomes are obviously much larger.
-            uint32_t randStart = ((((long) rand()) << 31) | rand()) % genomeSize;
+            uint32_t randStart = rng.below(genomeSize);
             // use the above randomStart (e.g., for human 0..3.1billion) 
             // to identify the chrom and start on that chrom.
             pair<string, int> location = _genome->projectOnGenome(randStart);
@@ -68,11 +117,11 @@ void BedRandom::Generate()
             chromSize = _genome->getChromSize(location.first);
         // keep looking if we have exceeded the end of the chrom.
         } while (end > chromSize);
-        numGenerated++;
+
         // flip a coin for strand
-        (rand() / double(RAND_MAX)) > 0.5 ? strand = '+' : strand = '-';
-        printf("%s\t%d\t%d\t%d\t%d\t%c\n", chrom.c_str(), start, end, numGenerated, end-start, strand);
+        (rng.uniform() >= 0.5) ? strand = '+' : strand = '-';
+        int len = snprintf(line, sizeof(line), "%s\t%d\t%d\t%d\t%d\t%c\n", 
+                           chrom.c_str(), start, end, numGenerated, end-start, strand);
+        out.append(line, min(len, (int)sizeof(line) - 1));
     }
 }
-
-
@@ -10,6 +10,8 @@
   Licenced under the GNU General Public License 2.0 license.
 ******************************************************************************/
 #include "GenomeFile.h"
+#include "RandomStream.h"
+#include <string>
 
 #include <vector>
 #include <iostream>
@@ -34,7 +36,7 @@ public:
 
     // constructor
     BedRandom(string &genomeFile, uint32_t numToGenerate, int seed,
-               bool haveSeed, uint32_t length);
+               bool haveSeed, uint32_t length, int numThreads);
 
     // destructor
     ~BedRandom(void);
@@ -48,7 +50,17 @@ private:
     GenomeFile *_genome;
     uint32_t _length;
     uint32_t _numToGenerate;
-    
+    int _numThreads;
+
+public:
+    // intervals are made in blocks, each from its own random
+    // stream, so a seed gives the same output for any -t.
+    static const uint32_t BLOCK_SIZE = 65536;
+
+    // print the intervals in a block into out.
+    void GenerateBlock(uint32_t block, string &out);
+
+private:
     // methods
     void Generate();
 
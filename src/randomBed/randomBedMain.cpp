@@ -11,6 +11,7 @@
 ******************************************************************************/
 #include "randomBed.h"
 #include "version.h"
+#include "ParseTools.h"
 
 using namespace std;
 
@@ -38,6 +39,7 @@ int random_main(int argc, char* argv[]) {
     int seed              = -1;
     int length            = 100;
     int numToGenerate     = 1000000;
+    int numThreads        = 1;
 
     for(int i = 1; i < argc; i++) {
         int parameterLength = (int)strlen(argv[i]);
@@ -81,6 +83,12 @@ int random_main(int argc, char* argv[]) {
                 i++;
             }
         }
+        else if(PARAMETER_CHECK("-threads", 8, parameterLength)) {
+            if ((i+1) < argc) {
+                numThreads = parseNumThreads(argv[i + 1]);
+                i++;
+            }
+        }
         else {
           cerr << endl << "*****ERROR: Unrecognized parameter: " << argv[i] << " *****" << endl << endl;
             showHelp = true;
@@ -93,8 +101,13 @@ int random_main(int argc, char* argv[]) {
       showHelp = true;
     }
 
+    if (numThreads < 1) {
+      cerr << endl << "*****" << endl << "*****ERROR: -threads must be a number greater than zero. " << endl << "*****" << endl;
+      showHelp = true;
+    }
+
     if (!showHelp) {
-        BedRandom *br = new BedRandom(genomeFile, numToGenerate, seed, haveSeed, length);
+        BedRandom *br = new BedRandom(genomeFile, numToGenerate, seed, haveSeed, length, numThreads);
         delete br;
         return 0;
     }
@@ -126,6 +139,10 @@ void random_help(void) {
     cerr                            << "\t\t- By default, the seed is chosen automatically." << endl;
     cerr                            << "\t\t- (INTEGER)" << endl << endl;
 
+    cerr << "\t-threads\t"          << "Number of threads to generate intervals with." << endl;
+    cerr                            << "\t\t- For a given -seed, the output is the same for any -threads." << endl;
+    cerr                            << "\t\t- Default = 1." << endl << endl;
+
     cerr << "Notes: " << endl;
     cerr << "\t(1)  The genome file should tab delimited and structured as follows:" << endl;
     cerr << "\t     <chromName><TAB><chromSize>" << endl << endl;
@@ -17,13 +17,22 @@
 */
 RelativeDistance::RelativeDistance(string bedAFile, 
                                    string bedBFile,
-                                   bool summary)
+                                   bool summary,
+                                   bool sortedInput)
 {
     _bedAFile  = bedAFile;
     _bedBFile  = bedBFile;
     _summary   = summary;
+    _sortedInput = sortedInput;
     _tot_queries = 0;
-    CalculateRelativeDistance();
+    // relative distances run from 0 to 0.5.
+    _reldists.resize(51, 0);
+    _haveNextB = false;
+    _prevBStart = 0;
+    if (_sortedInput)
+        SweepRelativeDistance();
+    else
+        CalculateRelativeDistance();
 }
 
 
@@ -41,6 +50,8 @@ void RelativeDistance::LoadMidpoints() {
     BED bed;    
     _bedB->Open();
     while (_bedB->GetNextBed(bed)) {
+        if (_bedB->_status != BED_VALID)
+            continue;
         CHRPOS midpoint = (int) (bed.end + bed.start) / 2;
         _db_midpoints[bed.chrom].push_back(midpoint);
     }
@@ -62,15 +73,15 @@ void RelativeDistance::ReportDistanceSummary()
          << "total\t"
          << "fraction\n";
     
-    map<float, size_t>::const_iterator freqItr = _reldists.begin();
-    map<float, size_t>::const_iterator freqEnd = _reldists.end();
-    for (; freqItr != freqEnd; ++freqItr)
+    for (size_t bin = 0; bin < _reldists.size(); ++bin)
     {
+        if (_reldists[bin] == 0)
+            continue;
         printf("%.2f\t%lu\t%lu\t%.3f\n", 
-               freqItr->first, 
-               freqItr->second,
+               (float) bin / 100, 
+               _reldists[bin],
                _tot_queries,
-               (float) freqItr->second / (float) _tot_queries);
+               (float) _reldists[bin] / (float) _tot_queries);
     }
 }
 
@@ -78,9 +89,54 @@ void RelativeDistance::ReportDistanceSummary()
 void RelativeDistance::UpdateDistanceSummary(float rel_dist)
 {
     _tot_queries++;
-    // round the relative distance to two decimal places.
-    float rounded_rel_dist = floorf(rel_dist * 100) / 100;
-    _reldists[rounded_rel_dist]++;
+    // round the relative distance down to two decimal places.
+    size_t bin = (size_t) floorf(rel_dist * 100);
+    if (bin >= _reldists.size())
+        _reldists.resize(bin + 1, 0);
+    _reldists[bin]++;
+}
+
+
+/*
+    Given the database midpoints left (< midpoint) and right (>= midpoint)
+    of a query's midpoint, compute its relative distance. Queries without
+    both flanks have none, unless the query's midpoint is a database
+    midpoint, which is a distance of 0 regardless.
+*/
+bool RelativeDistance::GetRelativeDistance(int midpoint, 
+                                           bool haveLeft, int left,
+                                           bool haveRight, int right,
+                                           float &rel_dist)
+{
+    if (!haveRight)
+        return false;
+    if (!haveLeft) {
+        if (right != midpoint)
+            return false;
+        rel_dist = 0;
+        return true;
+    }
+    // calculate the relative distance between the query's midpoint
+    // and the two nearest database midpoints.
+    size_t left_dist = abs(midpoint-left);
+    size_t right_dist = abs(midpoint-right);            
+    rel_dist = (float) min(left_dist, right_dist) 
+                / 
+               (float) (right-left);
+    return true;
+}
+
+
+void RelativeDistance::ReportRelativeDistance(BED &bed, float rel_dist)
+{
+    if (!_summary)
+    {
+        _bedA->reportBedTab(bed);
+        printf("%.3f\n", rel_dist);
+    }
+    else { 
+        UpdateDistanceSummary(rel_dist);
+    }
 }
 
 
@@ -88,8 +144,6 @@ void RelativeDistance::CalculateRelativeDistance()
 {
     LoadMidpoints();
     
-    vector<CHRPOS>::iterator low;
-    size_t low_idx, high_idx;
     float rel_dist;
     
     _bedA = new BedFile(_bedAFile);
@@ -101,52 +155,142 @@ void RelativeDistance::CalculateRelativeDistance()
         if (_bedA->_status != BED_VALID)
             continue;
 
-        vector<CHRPOS> *chrom_mids = &_db_midpoints[bed.chrom];
+        map<string, vector<CHRPOS> >::const_iterator chromItr = 
+            _db_midpoints.find(bed.chrom);
+        if (chromItr == _db_midpoints.end())
+            continue;
+        const vector<CHRPOS> &chrom_mids = chromItr->second;
         // binary search the current query's midpoint among
         // the database midpoints
         int midpoint = (int) (bed.end + bed.start) / 2;
-        low = lower_bound(chrom_mids->begin(), 
-                          chrom_mids->end(), 
-                          midpoint);
+        vector<CHRPOS>::const_iterator low = 
+            lower_bound(chrom_mids.begin(), chrom_mids.end(), (CHRPOS) midpoint);
         
-        // grab the indicies for the database midpoints that are left and
-        // right of the query's midpoint.
-        low_idx = low - chrom_mids->begin() - 1;
-        high_idx = low_idx + 1;
-        
-        // make sure we don't run off the boundaries of the database's
-        // midpoint vector
-        if (low_idx != chrom_mids->size() - 1) 
+        // the database midpoints that are left and right of
+        // the query's midpoint.
+        bool haveLeft = (low != chrom_mids.begin());
+        bool haveRight = (low != chrom_mids.end());
+        int left = haveLeft ? *(low - 1) : 0;
+        int right = haveRight ? *low : 0;
+
+        if (GetRelativeDistance(midpoint, haveLeft, left, 
+                                haveRight, right, rel_dist))
+            ReportRelativeDistance(bed, rel_dist);
+    }
+
+    // report the "histogram" of distances.
+    if (_summary)
+        ReportDistanceSummary();
+}
+
+
+void RelativeDistance::CheckSortOrder(const string &file, const BED &bed,
+                                      string &prevChrom, CHRPOS &prevStart)
+{
+    if (bed.chrom < prevChrom || 
+        (bed.chrom == prevChrom && bed.start < prevStart))
+    {
+        cerr << "Error: Sorted input specified, but the file " << file 
+             << " has the following out of order record" << endl
+             << bed.chrom << "\t" << bed.start << "\t" << bed.end << endl;
+        exit(1);
+    }
+    prevChrom = bed.chrom;
+    prevStart = bed.start;
+}
+
+
+bool RelativeDistance::NextDbRecord()
+{
+    while (_bedB->GetNextBed(_nextB)) {
+        if (_bedB->_status != BED_VALID)
+            continue;
+        CheckSortOrder(_bedBFile, _nextB, _prevBChrom, _prevBStart);
+        _haveNextB = true;
+        return true;
+    }
+    _haveNextB = false;
+    return false;
+}
+
+
+void RelativeDistance::AddDbMidpoint()
+{
+    // -b is sorted by start, not midpoint, so the window is kept
+    // in order by insertion.
+    CHRPOS midpoint = (int) (_nextB.end + _nextB.start) / 2;
+    _window.insert(upper_bound(_window.begin(), _window.end(), midpoint),
+                   midpoint);
+    NextDbRecord();
+}
+
+
+/*
+    With both files sorted by chrom, then start, sweep down them together.
+    A -b record can only flank queries whose midpoints are past its start,
+    so -b is read just far enough to find each query's flanks, and
+    midpoints are dropped once they're behind the query starts.
+*/
+void RelativeDistance::SweepRelativeDistance()
+{
+    float rel_dist;
+    string windowChrom;
+    string prevAChrom;
+    CHRPOS prevAStart = 0;
+
+    _bedA = new BedFile(_bedAFile);
+    _bedB = new BedFile(_bedBFile);
+    _bedA->Open();
+    _bedB->Open();
+    NextDbRecord();
+
+    BED bed;
+    while (_bedA->GetNextBed(bed)) {
+
+        if (_bedA->_status != BED_VALID)
+            continue;
+        CheckSortOrder(_bedAFile, bed, prevAChrom, prevAStart);
+
+        if (bed.chrom != windowChrom) {
+            _window.clear();
+            windowChrom = bed.chrom;
+        }
+        while (_haveNextB && _nextB.chrom < bed.chrom)
+            NextDbRecord();
+
+        // every -b midpoint left of the query's midpoint has been seen
+        // once the -b starts pass the query's midpoint...
+        int midpoint = (int) (bed.end + bed.start) / 2;
+        while (_haveNextB && _nextB.chrom == bed.chrom && 
+               _nextB.start <= (CHRPOS) midpoint)
+            AddDbMidpoint();
+
+        // ...and the nearest one right of it, once they pass that.
+        deque<CHRPOS>::iterator low = 
+            lower_bound(_window.begin(), _window.end(), (CHRPOS) midpoint);
+        while (_haveNextB && _nextB.chrom == bed.chrom &&
+               (low == _window.end() || _nextB.start < *low))
         {
-            // grab the database midpoints that are left and right of
-            // the query's midpoint.
-            int left = (*chrom_mids)[low_idx];
-            int right = (*chrom_mids)[high_idx];
-            
-            // ?
-            if (left > midpoint)
-                continue;
-            
-            // calculate the relative distance between the query's midpoint
-            // and the two nearest database midpoints.
-            size_t left_dist = abs(midpoint-left);
-            size_t right_dist = abs(midpoint-right);            
-            rel_dist = (float) min(left_dist, right_dist) 
-                        / 
-                       (float) (right-left);
-
-            if (!_summary)
-            {
-                _bedA->reportBedTab(bed);
-                printf("%.3f\n", rel_dist);
-            }
-            else { 
-                UpdateDistanceSummary(rel_dist);
-            }
+            AddDbMidpoint();
+            low = lower_bound(_window.begin(), _window.end(), (CHRPOS) midpoint);
         }
+
+        bool haveLeft = (low != _window.begin());
+        bool haveRight = (low != _window.end());
+        int left = haveLeft ? *(low - 1) : 0;
+        int right = haveRight ? *low : 0;
+        if (GetRelativeDistance(midpoint, haveLeft, left, 
+                                haveRight, right, rel_dist))
+            ReportRelativeDistance(bed, rel_dist);
+
+        // later queries start at or after this one, so of the midpoints
+        // before its start, only the last can still be a left flank.
+        deque<CHRPOS>::iterator keep = 
+            lower_bound(_window.begin(), _window.end(), (CHRPOS) bed.start);
+        if (keep != _window.begin())
+            _window.erase(_window.begin(), keep - 1);
     }
 
-    // report the "histogram" of distances.
     if (_summary)
         ReportDistanceSummary();
 }
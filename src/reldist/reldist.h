@@ -22,6 +22,7 @@ using namespace BamTools;
 
 
 #include <vector>
+#include <deque>
 #include <algorithm>
 #include <iostream>
 #include <fstream>
@@ -38,7 +39,8 @@ public:
     // constructor
     RelativeDistance(string bedAFile, 
                      string bedBFile,
-                     bool _summary);
+                     bool _summary,
+                     bool sortedInput);
 
     // destructor
     ~RelativeDistance(void);
@@ -52,18 +54,36 @@ private:
     string _bedBFile;
     
     map<string, vector<CHRPOS> > _db_midpoints;
-    map<float, size_t> _reldists;
+    // counts of the relative distances, in bins of 0.01.
+    vector<size_t> _reldists;
     size_t _tot_queries;
     
     // instance of a bed file class.
     BedFile *_bedA, *_bedB;
     bool _summary;
+    bool _sortedInput;
+
+    // with -sorted, only the -b midpoints on the current chrom
+    // that could still flank a query are kept, in order.
+    deque<CHRPOS> _window;
+    BED _nextB;
+    bool _haveNextB;
+    string _prevBChrom;
+    CHRPOS _prevBStart;
 
     //------------------------------------------------
     // private methods
     //------------------------------------------------
     void LoadMidpoints();
     void CalculateRelativeDistance();
+    void SweepRelativeDistance();
+    bool NextDbRecord();
+    void AddDbMidpoint();
+    void CheckSortOrder(const string &file, const BED &bed,
+                        string &prevChrom, CHRPOS &prevStart);
+    bool GetRelativeDistance(int midpoint, bool haveLeft, int left,
+                             bool haveRight, int right, float &rel_dist);
+    void ReportRelativeDistance(BED &bed, float rel_dist);
     void UpdateDistanceSummary(float rel_dist);
     void ReportDistanceSummary();
 
@@ -33,6 +33,7 @@ int reldist_main(int argc, char* argv[]) {
     string bedAFile;
     string bedBFile;
     bool summary = true;
+    bool sortedInput = false;
 
     // input arguments
     bool haveBedA           = false;
@@ -74,6 +75,9 @@ int reldist_main(int argc, char* argv[]) {
         else if(PARAMETER_CHECK("-detail", 7, parameterLength)) {
             summary = false;
         }
+        else if(PARAMETER_CHECK("-sorted", 7, parameterLength)) {
+            sortedInput = true;
+        }
         else {
             cerr << endl 
                  << "*****ERROR: Unrecognized parameter: " 
@@ -101,7 +105,8 @@ int reldist_main(int argc, char* argv[]) {
 
         RelativeDistance *rd = new RelativeDistance(bedAFile, 
                                                     bedBFile,
-                                                    summary);
+                                                    summary,
+                                                    sortedInput);
         delete rd;
         return 0;
     }
@@ -130,6 +135,10 @@ void reldist_help(void) {
     cerr << "\t-detail\t"       << "Instead of a summary, report the relative" 
                                 << "\t\t distance for each interval in A" 
                                 << endl << endl;
+
+    cerr << "\t-sorted\t"       << "Use the \"chromsweep\" algorithm for sorted (-k1,1 -k2,2n) input." << endl;
+    cerr                        << "\t\tOnly the -b midpoints near the current -a record are" << endl;
+    cerr                        << "\t\tkept in memory, rather than all of -b." << endl << endl;
     // end the program here
     exit(1);
 
@@ -1,20 +1,50 @@
 #include "sampleFile.h"
+#include <cmath>
 
 static bool SampleRecordLtFn(const Record *rec1, const Record *rec2) {
 	return (*rec1 < *rec2);
 }
 
+//a min-heap on the keys, moving the records along with them.
+static void siftDown(vector<double> &keys, vector<Record *> &records, size_t pos) {
+	size_t size = keys.size();
+	while (1) {
+		size_t smallest = pos;
+		size_t left = 2 * pos + 1;
+		size_t right = left + 1;
+		if (left < size && keys[left] < keys[smallest]) smallest = left;
+		if (right < size && keys[right] < keys[smallest]) smallest = right;
+		if (smallest == pos) return;
+		swap(keys[pos], keys[smallest]);
+		swap(records[pos], records[smallest]);
+		pos = smallest;
+	}
+}
+
+static void siftUp(vector<double> &keys, vector<Record *> &records, size_t pos) {
+	while (pos > 0) {
+		size_t parent = (pos - 1) / 2;
+		if (keys[parent] <= keys[pos]) return;
+		swap(keys[pos], keys[parent]);
+		swap(records[pos], records[parent]);
+		pos = parent;
+	}
+}
+
 SampleFile::SampleFile(ContextSample *context)
 : ToolBase(context),
 _inputFile(NULL),
 _numSamples(0),
-_numCurrSamples(0),
-_currRecordNum(0)
+_seed(0),
+_weighted(context->getWeighted()),
+_perChrom(context->getPerChrom()),
+_canSkip(false)
 {
 	_numSamples = context->getNumOutputRecords();
 	if (_numSamples == 0) {
 		_numSamples = DEFAULT_NUM_SAMPLES;
 	}
+	_canSkip = !_weighted && !_perChrom && !context->getSameStrand();
 }
 
 
@@ -27,26 +57,38 @@ SampleFile::~SampleFile()
  {
 	//we're only operating on one file, so the idx is zero.
 	_inputFile =  _context->getFile(0);
-	_samples.resize(_numSamples, NULL);
-
+	if (!_perChrom) {
+		_reservoirs.resize(1);
+	}
 
-	//Context object takes care of the seed, either user given or randomly
-	//generated, and seeds the call to srand with it, so we don't have to
-	//here.
-	if (!_context->hasConstantSeed()) {
-		_context->getUnspecifiedSeed();
+	//the seed is either user given or randomly generated.
+	if (_context->hasConstantSeed()) {
+		_seed = _context->getConstantSeed();
+	} else {
+		_seed = _context->getUnspecifiedSeed();
 	}
+	_rng.reset(_seed, 0);
 	return true;
  }
 
 
  bool SampleFile::findNext(RecordKeyVector &hits) {
+	if (_canSkip) {
+		Reservoir &reservoir = _reservoirs[0];
+		while (reservoir._numSeen < reservoir._nextKeep) {
+			if (_inputFile->eof()) {
+				return false;
+			}
+			if (_inputFile->skipRecord()) {
+				reservoir._numSeen++;
+			}
+		}
+	}
 	while (!_inputFile->eof()) {
 		Record *record = _inputFile->getNextRecord();
 		if (record == NULL) {
 			continue;
 		} else {
-			_currRecordNum++;
 			if (!keepRecord(record)) {
 				_inputFile->deleteRecord(record);
 			}
@@ -57,19 +99,23 @@ SampleFile::~SampleFile()
 }
 
 void  SampleFile::giveFinalReport(RecordOutputMgr *outputMgr) {
-	if (_currRecordNum < _numSamples) {
+	if (!_perChrom && _reservoirs[0]._records.size() < _numSamples) {
 		//die with error;
 		cerr << "\n***** ERROR: Input file has fewer records than the requested number of output records. *****" << endl << endl;
 		exit(1);
  	}
 
+	vector<Record *> samples;
+	for (size_t i = 0; i < _reservoirs.size(); i++) {
+		samples.insert(samples.end(), _reservoirs[i]._records.begin(), _reservoirs[i]._records.end());
+	}
 	//If the output type is BAM, must sort the output records.
 	if (_context->getOutputFileType() == FileRecordTypeChecker::BAM_FILE_TYPE) {
-		sort(_samples.begin(), _samples.end(), SampleRecordLtFn);
+		sort(samples.begin(), samples.end(), SampleRecordLtFn);
 	}
 	// Now output all the kept records, then do cleanup.
-	for (size_t i=0; i < _numSamples; i++) {
-		outputMgr->printRecord(_samples[i]);
+	for (size_t i=0; i < samples.size(); i++) {
+		outputMgr->printRecord(samples[i]);
 	}
 }
 
@@ -78,26 +124,96 @@ bool SampleFile::keepRecord(Record *record)
 	if (!strandComplies(record)) {
 		return false;
 	}
-	if (_numCurrSamples < _numSamples) {
-		_samples[_numCurrSamples] = record;
-		_numCurrSamples++;
-		return true;
+	Reservoir &reservoir = getReservoir(record);
+	if (_weighted) {
+		return keepWeighted(reservoir, record);
+	}
+	return keepUniform(reservoir, record);
+}
+
+SampleFile::Reservoir &SampleFile::getReservoir(const Record *record)
+{
+	if (!_perChrom) {
+		return _reservoirs[0];
+	}
+	const QuickString &chrom = record->getChrName();
+	if (!_reservoirs.empty() && _reservoirs.back()._chrom == chrom) {
+		return _reservoirs.back();
 	}
+	map<QuickString, size_t>::iterator iter = _chromReservoirs.find(chrom);
+	if (iter != _chromReservoirs.end()) {
+		return _reservoirs[iter->second];
+	}
+	_chromReservoirs[chrom] = _reservoirs.size();
+	_reservoirs.resize(_reservoirs.size() + 1);
+	_reservoirs.back()._chrom = chrom;
+	return _reservoirs.back();
+}
 
+bool SampleFile::keepUniform(Reservoir &reservoir, Record *record)
+{
+	size_t recordNum = reservoir._numSeen;
+	reservoir._numSeen++;
+	if (reservoir._records.size() < _numSamples) {
+		reservoir._records.push_back(record);
+		if (reservoir._records.size() == _numSamples) {
+			reservoir._w = exp(log(_rng.uniformPositive()) / _numSamples);
+			reservoir._nextKeep = recordNum;
+			advanceUniform(reservoir);
+		}
+		return true;
+	}
+	if (recordNum < reservoir._nextKeep) {
+		return false;
+	}
+	//replace a random kept record with this new one.
+	size_t idx = _rng.below(_numSamples);
+	_inputFile->deleteRecord(reservoir._records[idx]);
+	reservoir._records[idx] = record;
+	reservoir._w *= exp(log(_rng.uniformPositive()) / _numSamples);
+	advanceUniform(reservoir);
+	return true;
+}
 
-	// We need a random number in the range [0, _currRecordNum].
-	// Must combine two consective calls to rand()
-    // because RAND_MAX is 2^31 (2147483648), whereas
-    // the number of input records could be far larger.
-    size_t idx = ((((long) rand()) << 31) | rand()) % _currRecordNum;
+void SampleFile::advanceUniform(Reservoir &reservoir)
+{
+	//the number of records to pass over is geometric.
+	double skip = floor(log(_rng.uniformPositive()) / log1p(-reservoir._w));
+	if (!(skip < 1e18)) {
+		skip = 1e18;
+	}
+	reservoir._nextKeep += (size_t)skip + 1;
+}
 
-    if (idx < _numSamples) {
-    	//replace old record at idx with this new one.
-    	_inputFile->deleteRecord(_samples[idx]);
-    	_samples[idx] = record;
-    	return true;
-    }
-    return false;
+bool SampleFile::keepWeighted(Reservoir &reservoir, Record *record)
+{
+	const QuickString &score = record->getScore();
+	char *end = NULL;
+	double weight = strtod(score.c_str(), &end);
+	if (score.empty() || *end != '\0') {
+		cerr << "\n***** ERROR: -w needs numeric scores, but found \"" << score << "\". *****" << endl << endl;
+		exit(1);
+	}
+	reservoir._numSeen++;
+	//records that can't be chosen don't count towards -n.
+	if (!(weight > 0)) {
+		return false;
+	}
+	double key = log(_rng.uniformPositive()) / weight;
+	if (reservoir._records.size() < _numSamples) {
+		reservoir._records.push_back(record);
+		reservoir._keys.push_back(key);
+		siftUp(reservoir._keys, reservoir._records, reservoir._keys.size() - 1);
+		return true;
+	}
+	if (key <= reservoir._keys[0]) {
+		return false;
+	}
+	_inputFile->deleteRecord(reservoir._records[0]);
+	reservoir._records[0] = record;
+	reservoir._keys[0] = key;
+	siftDown(reservoir._keys, reservoir._records, 0);
+	return true;
 }
 
 bool SampleFile::strandComplies(const Record * record) {
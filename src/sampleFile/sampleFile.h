@@ -10,6 +10,7 @@
 
 #include "ToolBase.h"
 #include "ContextSample.h"
+#include "RandomStream.h"
 
 class SampleFile : public ToolBase {
 
@@ -25,15 +26,39 @@ public:
 
 
 protected:
+	//One reservoir per stratum: the whole file, or a chrom with -perChrom.
+	//Uniform samples use Algorithm L (Li, 1994), which works out how many
+	//records to pass over before the next one it keeps. Weighted ones keep
+	//the records with the largest keys u^(1/weight) (Efraimidis & Spirakis),
+	//held as log(u)/weight in a min-heap.
+	class Reservoir {
+	public:
+		Reservoir() : _numSeen(0), _nextKeep(0), _w(0) {}
+		QuickString _chrom;
+		vector<Record *> _records;
+		vector<double> _keys; //weighted only, a heap in step with _records.
+		size_t _numSeen; //records offered so far.
+		size_t _nextKeep; //uniform only, index of the next record to keep.
+		double _w;
+	};
+
 	FileRecordMgr *_inputFile;
-	vector<Record *> _samples;
+	vector<Reservoir> _reservoirs;
+	map<QuickString, size_t> _chromReservoirs;
 	size_t _numSamples; //the number of samples we ultimately want
-	size_t _numCurrSamples; //the number of samples kept so far.
-	size_t _currRecordNum;
 	int _seed;
+	RandomStream _rng;
+	bool _weighted;
+	bool _perChrom;
+	//without -s, -w or -perChrom, records we won't keep are never parsed.
+	bool _canSkip;
 
 	static const int DEFAULT_NUM_SAMPLES = 1000000;
 	bool keepRecord(Record *record);
+	bool keepUniform(Reservoir &reservoir, Record *record);
+	bool keepWeighted(Reservoir &reservoir, Record *record);
+	void advanceUniform(Reservoir &reservoir);
+	Reservoir &getReservoir(const Record *record);
 	bool strandComplies(const Record * record);
 
 	virtual ContextSample *upCast(ContextBase *context) { return static_cast<ContextSample *>(context); }
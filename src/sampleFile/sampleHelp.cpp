@@ -15,8 +15,8 @@ void sample_help(void) {
 
     cerr << "Usage:   " << "bedtools sample" << " [OPTIONS] -i <bed/gff/vcf/bam>" << endl << endl;
 
-    cerr << "WARNING:\tThe current sample algorithm will hold all requested sample records in memory prior to output." << endl;
-    cerr << "\t\tThe user must ensure that there is adequate memory for this." << endl << endl;
+    cerr << "WARNING:\tThe sample is made in one pass, holding only the requested sample records in memory" << endl;
+    cerr << "\t\t(-n per chromosome with -perChrom). The user must ensure that there is adequate memory for this." << endl << endl;
     cerr << "Options: " << endl;
 
     cerr << "\t-n\t"                << "The number of records to generate." << endl;
@@ -35,6 +35,12 @@ void sample_help(void) {
     cerr						<< "\t\tfor forward or reverse strand records, respectively." << endl;
     cerr                        << "\t\t- By default, records are reported without respect to strand." << endl << endl;
 
+    cerr << "\t-w\t"            << "Weighted sampling. Records are chosen with probability in proportion" << endl;
+    cerr                        << "\t\tto their score, and records with a score of zero or less are never chosen." << endl << endl;
+
+    cerr << "\t-perChrom\t"     << "Sample -n records from each chromosome, rather than from the whole file." << endl;
+    cerr                        << "\t\tChromosomes with fewer than -n records give all of them." << endl << endl;
+
     cerr << "\t-header\t"       << "Print the header from the input file prior to results." << endl << endl;
 
     allToolsCommonHelp();
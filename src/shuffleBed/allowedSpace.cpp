@@ -0,0 +1,99 @@
+/*****************************************************************************
+  allowedSpace.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#include "allowedSpace.h"
+#include <algorithm>
+
+
+void AllowedSpace::addChrom(int chromId, CHRPOS chromSize,
+                            vector< pair<CHRPOS, CHRPOS> > &excluded, 
+                            bool openEnd) {
+    sort(excluded.begin(), excluded.end());
+    Gap gap;
+    gap.chromId = chromId;
+    CHRPOS pos = 0;
+    for (size_t i = 0; i <= excluded.size(); i++) {
+        CHRPOS gapEnd = chromSize;
+        if (i < excluded.size())
+            gapEnd = min(excluded[i].first, chromSize);
+        if (gapEnd > pos) {
+            gap.start = pos;
+            gap.len   = gapEnd - pos;
+            if (i == excluded.size() && openEnd)
+                _openGaps.push_back(gap);
+            else
+                _gaps.push_back(gap);
+        }
+        // excluded intervals may overlap, so this merges them.
+        if (i < excluded.size())
+            pos = max(pos, excluded[i].second);
+    }
+    _sorted = false;
+}
+
+
+void AllowedSpace::prepare() {
+    if (_sorted)
+        return;
+    // stable, so that a seed gives the same loci everywhere.
+    stable_sort(_gaps.begin(), _gaps.end());
+    _cumLen.assign(1, 0);
+    for (size_t i = 0; i < _gaps.size(); i++)
+        _cumLen.push_back(_cumLen.back() + _gaps[i].len);
+    _openCumLen.assign(1, 0);
+    for (size_t i = 0; i < _openGaps.size(); i++)
+        _openCumLen.push_back(_openCumLen.back() + _openGaps[i].len);
+    _sorted = true;
+}
+
+
+bool AllowedSpace::choose(CHRPOS length, uint64_t random, 
+                          int &chromId, CHRPOS &start) {
+    prepare();
+    // zero-length intervals still need a base to sit on.
+    uint64_t slack = (length > 0) ? length - 1 : 0;
+
+    // the first k gaps are long enough.
+    size_t lo = 0, hi = _gaps.size();
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (_gaps[mid].len > slack)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    size_t k = lo;
+    uint64_t closedStarts = _cumLen[k] - k * slack;
+    uint64_t openStarts = _openCumLen.back();
+    if (closedStarts + openStarts == 0)
+        return false;
+
+    uint64_t r = random % (closedStarts + openStarts);
+    const Gap *gap;
+    if (r < openStarts) {
+        size_t i = upper_bound(_openCumLen.begin(), _openCumLen.end(), r) 
+                   - _openCumLen.begin() - 1;
+        gap = &_openGaps[i];
+        r  -= _openCumLen[i];
+    }
+    else {
+        // the first gap whose starts, summed with those before it, pass r.
+        r -= openStarts;
+        lo = 1;
+        hi = k;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (_cumLen[mid] - mid * slack > r)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        gap = &_gaps[lo - 1];
+        r  -= _cumLen[lo - 1] - (lo - 1) * slack;
+    }
+    chromId = gap->chromId;
+    start   = gap->start + (CHRPOS) r;
+    return true;
+}
@@ -0,0 +1,58 @@
+/*****************************************************************************
+  allowedSpace.h
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#ifndef ALLOWEDSPACE_H
+#define ALLOWEDSPACE_H
+
+#include "bedFile.h"
+
+#include <vector>
+#include <utility>
+using namespace std;
+
+//************************************************
+// The parts of the genome that shuffled intervals may
+// land in, i.e., the gaps between excluded intervals.
+//
+// Gaps are sorted by decreasing length, so the ones
+// that can hold an interval of length L are a prefix,
+// and the first i of them hold cumLen[i] - i * (L - 1)
+// start positions. A draw is a single binary search
+// rather than a retry loop.
+//************************************************
+class AllowedSpace {
+
+public:
+    AllowedSpace() : _sorted(false) {}
+
+    // add the gaps a chrom's excluded intervals (sorted here,
+    // overlaps allowed) leave. with openEnd, the last gap runs
+    // to the chrom end and any start in it is fine.
+    void addChrom(int chromId, CHRPOS chromSize,
+                  vector< pair<CHRPOS, CHRPOS> > &excluded, bool openEnd);
+    // sort the gaps. choose() does this on first use, but
+    // space shared between threads must be prepared first.
+    void prepare();
+    // choose a start for an interval of the given length
+    // uniformly among the positions where it avoids every
+    // excluded region, given a random 64-bit value.
+    // false if there aren't any.
+    bool choose(CHRPOS length, uint64_t random, int &chromId, CHRPOS &start);
+
+private:
+    struct Gap {
+        int chromId;
+        CHRPOS start;
+        CHRPOS len;
+        bool operator<(const Gap &other) const { return len > other.len; }
+    };
+    vector<Gap> _gaps;
+    vector<Gap> _openGaps;
+    vector<uint64_t> _cumLen;      // _cumLen[i] = total length of _gaps[0..i)
+    vector<uint64_t> _openCumLen;
+    bool _sorted;
+};
+
+#endif /* ALLOWEDSPACE_H */
@@ -38,19 +38,25 @@ BedShuffle::BedShuffle(string &bedFile, string &genomeFile,
     _noOverlapping   = noOverlapping;
     _preventExceedingChromEnd = preventExceedingChromEnd;
     _cumLen          = 0;
+    // -excl alone is sampled directly from the space it leaves.
+    // overlapping output (-noOverlapping) changes that space as we
+    // go, and partial overlaps (-f) or unweighted chroms (-chromFirst)
+    // need the old draw-and-check loop.
+    _useAllowedSpace = (haveExclude && !haveInclude && !isBedpe &&
+                        !noOverlapping && overlapFraction <= 1E-9 &&
+                        (!chooseChrom || sameChrom));
 
     // use the supplied seed for the random
     // number generation if given.  else,
     // roll our own.
     if (_haveSeed) {
         _seed = seed;
-        srand(seed);
     }
     else {
         // thanks to Rob Long for the tip.
         _seed = (unsigned)time(0)+(unsigned)getpid();
-        srand(_seed);
     }
+    _rng.reset(_seed, 0);
     
     if (_isBedpe == false)
         _bed         = new BedFile(bedFile);
@@ -64,7 +70,10 @@ BedShuffle::BedShuffle(string &bedFile, string &genomeFile,
 
     if (_haveExclude) {
         _exclude = new BedFile(excludeFile);
-        _exclude->loadBedFileIntoMap();
+        if (_useAllowedSpace)
+            BuildAllowedSpace();
+        else
+            _exclude->loadBedFileIntoMap();
     }
     else if (_noOverlapping) {
         // create an empty map that we add to as we iterate.
@@ -146,7 +155,18 @@ void BedShuffle::ShuffleWithExclusions() {
         BED bedEntry;
         _bed->Open();
         while (_bed->GetNextBed(bedEntry)) {
-            if (_bed->_status == BED_VALID) {
+            if (_bed->_status == BED_VALID && _useAllowedSpace) {
+                if (ChooseAllowedLocus(bedEntry)) {
+                    _bed->reportBedNewLine(bedEntry);
+                }
+                else {
+                    cerr << "Error, line " << _bed->_lineNum 
+                         << ": no locus for entry avoids the "
+                         << "excluded regions.  Ignoring entry and moving on." 
+                         << endl;
+                }
+            }
+            else if (_bed->_status == BED_VALID) {
                 // keep looking as long as the chosen
                 // locus happens to overlap with regions
                 // that the user wishes to exclude.
@@ -331,11 +351,7 @@ void BedShuffle::ChooseLocus(BED &bedEntry) {
         do 
         {
 
-            // we need to combine two consecutive calls to rand()
-            // because RAND_MAX is 2^31 (2147483648), whereas
-            // mammalian genomes are obviously much larger.
-            uint32_t randStart = ((((long) rand()) << 31) | rand()) % 
-                                 _genomeSize;
+            uint32_t randStart = _rng.below(_genomeSize);
             // use the above randomStart (e.g., for human 0..3.1billion) 
             // to identify the chrom and start on that chrom.
             pair<string, int> location = _genome->projectOnGenome(randStart);
@@ -370,16 +386,16 @@ void BedShuffle::ChooseLocus(BED &bedEntry) {
         do 
         {
             if (_sameChrom == false) {
-                randomChrom    = _chroms[rand() % _numChroms];
+                randomChrom    = _chroms[_rng.below(_numChroms)];
                 chromSize      = _genome->getChromSize(randomChrom);
-                randomStart    = rand() % chromSize;
+                randomStart    = _rng.below(chromSize);
                 bedEntry.chrom = randomChrom;
                 bedEntry.start = randomStart;
                 bedEntry.end   = randomStart + length;
             }
             else {
                 chromSize      = _genome->getChromSize(chrom);
-                randomStart    = rand() % chromSize;
+                randomStart    = _rng.below(chromSize);
                 bedEntry.start = randomStart;
                 bedEntry.end   = randomStart + length;
             }
@@ -396,6 +412,63 @@ void BedShuffle::ChooseLocus(BED &bedEntry) {
 }
 
 
+void BedShuffle::BuildAllowedSpace() {
+
+    for (int i = 0; i < _numChroms; i++) {
+        _chromIds[_chroms[i]] = i;
+    }
+    if (_sameChrom)
+        _allowedByChrom.resize(_numChroms);
+
+    // gather the excluded intervals by chrom.
+    _exclude->loadBedFileIntoVector();
+    vector< vector< pair<CHRPOS, CHRPOS> > > excluded(_numChroms);
+    for (size_t i = 0; i < _exclude->bedList.size(); i++) {
+        const BED &bed = _exclude->bedList[i];
+        map<string, int>::const_iterator id = _chromIds.find(bed.chrom);
+        if (id != _chromIds.end())
+            excluded[id->second].push_back(make_pair(bed.start, bed.end));
+    }
+    _exclude->bedList.clear();
+
+    // the gaps between them are what's left.
+    for (int c = 0; c < _numChroms; c++) {
+        CHRPOS chromSize = _genome->getChromSize(_chroms[c]);
+        if (_sameChrom)
+            _allowedByChrom[c].addChrom(c, chromSize, excluded[c],
+                                        !_preventExceedingChromEnd);
+        _allowed.addChrom(c, chromSize, excluded[c],
+                          !_preventExceedingChromEnd);
+    }
+}
+
+
+bool BedShuffle::ChooseAllowedLocus(BED &bedEntry) {
+
+    CHRPOS length = bedEntry.end - bedEntry.start;
+    AllowedSpace *space = &_allowed;
+    if (_sameChrom) {
+        map<string, int>::const_iterator id = _chromIds.find(bedEntry.chrom);
+        if (id == _chromIds.end())
+            return false;
+        space = &_allowedByChrom[id->second];
+    }
+
+    int chromId;
+    CHRPOS start;
+    if (!space->choose(length, _rng.next(), chromId, start))
+        return false;
+    bedEntry.chrom = _chroms[chromId];
+    bedEntry.start = start;
+    bedEntry.end   = start + length;
+    // only possible in the last gap, with -allowBeyondChromEnd.
+    CHRPOS chromSize = _genome->getChromSize(bedEntry.chrom);
+    if (bedEntry.end > chromSize)
+        bedEntry.end = chromSize;
+    return true;
+}
+
+
 void BedShuffle::ChoosePairedLocus(BEDPE &b) {
     
     CHRPOS foot1_len = b.end1 - b.start1;
@@ -407,8 +480,7 @@ void BedShuffle::ChoosePairedLocus(BEDPE &b) {
         CHRPOS chromSize;
         do 
         {
-            uint32_t randStart = ((((long) rand()) << 31) | rand()) % 
-                                 _genomeSize;
+            uint32_t randStart = _rng.below(_genomeSize);
             pair<string, int> location = _genome->projectOnGenome(randStart);
             b.chrom1  = location.first;
             b.chrom2  = location.first;
@@ -427,10 +499,8 @@ void BedShuffle::ChoosePairedLocus(BEDPE &b) {
         CHRPOS chromSize1, chromSize2;
         do 
         {
-            uint32_t rand1Start = ((((long) rand()) << 31) | rand()) %
-                                  _genomeSize;
-            uint32_t rand2Start = ((((long) rand()) << 31) | rand()) % 
-                                  _genomeSize;
+            uint32_t rand1Start = _rng.below(_genomeSize);
+            uint32_t rand2Start = _rng.below(_genomeSize);
             pair<string, int> location1 = _genome->projectOnGenome(rand1Start);
             pair<string, int> location2 = _genome->projectOnGenome(rand2Start);
             
@@ -465,11 +535,11 @@ void BedShuffle::ChooseLocusFromInclusionFile(BED &bedEntry) {
     bool nohit = true;
     while(nohit){
       
-      includeInterval = _include->bedList[rand() % _include->bedList.size()];
+      includeInterval = _include->bedList[_rng.below(_include->bedList.size())];
       
       double prop = double(includeInterval.end
 			   - includeInterval.start) / _cumLen;
-      double runif =((double)rand()/(double)RAND_MAX);
+      double runif = _rng.uniform();
 
       if(runif < prop){
 	nohit = false;
@@ -481,7 +551,7 @@ void BedShuffle::ChooseLocusFromInclusionFile(BED &bedEntry) {
     }
 
     bedEntry.chrom = includeInterval.chrom;
-    randomStart    = includeInterval.start + rand() % (includeInterval.size());
+    randomStart    = includeInterval.start + _rng.below(includeInterval.size());
     bedEntry.start = randomStart;
     bedEntry.end   = randomStart + length;
 }
@@ -12,6 +12,8 @@
 #include "bedFile.h"
 #include "bedFilePE.h"
 #include "GenomeFile.h"
+#include "allowedSpace.h"
+#include "RandomStream.h"
 
 #include <vector>
 #include <iostream>
@@ -53,6 +55,7 @@ private:
     string _includeFile;
     float  _overlapFraction;
     int _seed;
+    RandomStream _rng;
     bool _sameChrom;
     bool _haveExclude;
     bool _haveInclude;
@@ -81,6 +84,13 @@ private:
 
     // include length sum
     long double _cumLen;
+
+    // the complement of -excl, genome-wide and by chrom,
+    // when the draws can be made from it directly.
+    bool _useAllowedSpace;
+    AllowedSpace _allowed;
+    vector<AllowedSpace> _allowedByChrom;
+    map<string, int> _chromIds;
     
     // methods
     void Shuffle();
@@ -89,6 +99,8 @@ private:
     void ShuffleWithInclusionsAndExclusions();
 
     void ChooseLocus(BED &);
+    bool ChooseAllowedLocus(BED &);
+    void BuildAllowedSpace();
     void ChooseLocusFromInclusionFile(BED &);
     
     void ChoosePairedLocus(BEDPE &b);
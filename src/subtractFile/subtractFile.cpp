@@ -1,5 +1,5 @@
 #include "subtractFile.h"
-#include <numeric>
+#include <algorithm>
 
 SubtractFile::SubtractFile(ContextSubtract *context)
 : IntersectFile(context),
@@ -24,6 +24,12 @@ bool SubtractFile::findNext(RecordKeyVector &hits)
 	return false;
 }
 
+void SubtractFile::findShared(RecordKeyVector &sharedHits, RecordKeyVector &hits)
+{
+	IntersectFile::findShared(sharedHits, hits);
+	subtractHits(hits);
+}
+
 void SubtractFile::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits)
 {
 	if (!_dontReport) {
@@ -32,13 +38,13 @@ void SubtractFile::processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits
 	_dontReport = false;
 }
 
-void SubtractFile::cleanupHits(RecordKeyVector &hits)
+void SubtractFile::releaseHits(RecordKeyVector &hits)
 {
 	if (_deleteTmpBlocks) {
 	    _tmpBlocksMgr->deleteBlocks(hits);
 	    _deleteTmpBlocks = false;
 	}
-	IntersectFile::cleanupHits(hits);
+	IntersectFile::releaseHits(hits);
 }
 
 void SubtractFile::subtractHits(RecordKeyVector &hits) {
@@ -58,18 +64,16 @@ void SubtractFile::subtractHits(RecordKeyVector &hits) {
 		return;
 	}
 
-	//loop through hits. Track which bases in query were covered
+	//loop through hits. Track which stretches of the query were covered
 	const Record *keyRec = hits.getKey();
 	int keyStart = keyRec->getStartPos();
 	int keyEnd = keyRec->getEndPos();
+	int keyLen = keyEnd - keyStart;
 
-	//this vector of bools will represent the bases of the query.
-	//for each base, true means uncovered, false means covered.
-	//they begin as all uncovered.
-	vector<bool> keyBases(keyEnd - keyStart, true);
-
-	//now loop through the hits, and cover corresponding query bases
-	//by setting them to false.
+	//collect the covered stretches, relative to the query's start.
+	//Sorting and sweeping them costs O(hits log hits), however long
+	//the query is.
+	_coveredRanges.clear();
 	bool basesRemoved = false;
 	for (RecordKeyVector::const_iterator_type iter = hits.begin(); iter != hits.end(); iter = hits.next()) {
 		const Record *hitRec = *iter;
@@ -79,13 +83,13 @@ void SubtractFile::subtractHits(RecordKeyVector &hits) {
 		int startIdx = max(keyStart, hitStart) - keyStart;
 		int endIdx = min(keyEnd, hitEnd) - keyStart;
 
-		int keyLen = keyEnd - keyStart;
 		int coveredLen = endIdx - startIdx;
 		float coveragePct = (float)coveredLen / (float)keyLen;
-		//for each base in the hit, set the base in the query to false.
-		//this effectively "erases" the covered bits. Only do
+		//only hits covering enough of the query erase their bases from it.
 		if (upCast(_context)->getRemoveSum() || coveragePct >= upCast(_context)->getSubtractFraction()) {
-			std::fill(keyBases.begin() + startIdx, keyBases.begin() + endIdx, false);
+			if (startIdx < endIdx) {
+				_coveredRanges.push_back(make_pair(startIdx, endIdx));
+			}
 			basesRemoved = true;
 		}
 	}
@@ -99,11 +103,27 @@ void SubtractFile::subtractHits(RecordKeyVector &hits) {
 		_dontReport = true;
 		return;
 	}
+
+	//merge the covered stretches. What lies between them is uncovered.
+	sort(_coveredRanges.begin(), _coveredRanges.end());
+	_uncoveredRanges.clear();
+	int numBasesUncovered = 0;
+	int pos = 0;
+	for (size_t i = 0; i < _coveredRanges.size(); i++) {
+		if (_coveredRanges[i].first > pos) {
+			_uncoveredRanges.push_back(make_pair(pos, _coveredRanges[i].first));
+			numBasesUncovered += _coveredRanges[i].first - pos;
+		}
+		pos = max(pos, _coveredRanges[i].second);
+	}
+	if (pos < keyLen) {
+		_uncoveredRanges.push_back(make_pair(pos, keyLen));
+		numBasesUncovered += keyLen - pos;
+	}
+
 	// if the -N option is used ( removeSum), do not report if the percentage of
 	// uniquely covered bases exceeds the overlap fraction.
 	if (upCast(_context)->getRemoveSum()) {
-		//determine how many bases are left uncovered.
-		int numBasesUncovered = std::accumulate(keyBases.begin(), keyBases.end(), 0);
 		//determine percentage that are covered.
 		float pctCovered = 1.0 - (float)numBasesUncovered / (float)(keyEnd - keyStart);
 		if (pctCovered > upCast(_context)->getSubtractFraction()) {
@@ -119,16 +139,10 @@ void SubtractFile::subtractHits(RecordKeyVector &hits) {
 	//now make "blocks" out of the query's remaining stretches of
 	//uncovered bases.
 	hits.clearVector();
-    for (int i = 0; i < (int)keyBases.size(); i++) {
-        if (keyBases[i] == true) {
-            int blockStart = keyStart + i;
-            while (keyBases[i] == true && i < (int)keyBases.size()) {
-                i++;
-            }
-            int blockEnd = min(keyStart + i, keyEnd);
-            hits.push_back(_tmpBlocksMgr->allocateAndAssignRecord(keyRec, blockStart, blockEnd));
-        }
-    }
+	for (size_t i = 0; i < _uncoveredRanges.size(); i++) {
+		hits.push_back(_tmpBlocksMgr->allocateAndAssignRecord(keyRec,
+				keyStart + _uncoveredRanges[i].first, keyStart + _uncoveredRanges[i].second));
+	}
     _deleteTmpBlocks = true;
 
 }
@@ -20,12 +20,16 @@ public:
 
 	virtual bool findNext(RecordKeyVector &hits);
 	virtual void processHits(RecordOutputMgr *outputMgr, RecordKeyVector &hits);
-	virtual void cleanupHits(RecordKeyVector &hits);
+	virtual void findShared(RecordKeyVector &sharedHits, RecordKeyVector &hits);
+	virtual void releaseHits(RecordKeyVector &hits);
 
 protected:
 	BlockMgr *_tmpBlocksMgr;
 	bool _deleteTmpBlocks;
 	bool _dontReport;
+	//scratch space for subtractHits, as offsets into the query.
+	vector<pair<int, int> > _coveredRanges;
+	vector<pair<int, int> > _uncoveredRanges;
 
 	virtual ContextSubtract *upCast(ContextBase *context) { return static_cast<ContextSubtract *>(context); }
 	void subtractHits(RecordKeyVector &hits);
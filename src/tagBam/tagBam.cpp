@@ -16,7 +16,8 @@
 TagBam::TagBam(const string &bamFile, const vector<string> &annoFileNames,
             const vector<string> &annoLables, const string &tag,
             bool useNames, bool useScores, bool useIntervals, 
-            bool sameStrand, bool diffStrand, float overlapFraction):
+            bool sameStrand, bool diffStrand, float overlapFraction,
+            bool sortedInput):
 
     _bamFile(bamFile),
     _annoFileNames(annoFileNames),
@@ -27,21 +28,23 @@ TagBam::TagBam(const string &bamFile, const vector<string> &annoFileNames,
     _useIntervals(useIntervals),
     _sameStrand(sameStrand),
     _diffStrand(diffStrand),
-    _overlapFraction(overlapFraction)
+    _overlapFraction(overlapFraction),
+    _sortedInput(sortedInput)
 {}
 
 
 // destroy and delete the open file pointers
 TagBam::~TagBam(void) {
     CloseAnnoFiles();
+    CloseSortedAnnoFiles();
 }
 
 
 void TagBam::OpenAnnoFiles() {
     for (size_t i=0; i < _annoFileNames.size(); ++i) {
         BedFile *file = new BedFile(_annoFileNames[i]);
-        file->loadBedFileIntoMap();
         _annoFiles.push_back(file);
+        _annoIndexes.push_back(new BedIndex(file));
     }
 }
 
@@ -51,12 +54,19 @@ void TagBam::CloseAnnoFiles() {
         BedFile *file = _annoFiles[i];
         delete file;
         _annoFiles[i] = NULL;
+        delete _annoIndexes[i];
+        _annoIndexes[i] = NULL;
     }
 }
 
 
 void TagBam::Tag() {
 
+    if (_sortedInput) {
+        TagSorted();
+        return;
+    }
+
     // open the annotations files for processing;
     OpenAnnoFiles();
 
@@ -81,7 +91,7 @@ void TagBam::Tag() {
 
     // rip through the BAM file and test for overlaps with each annotation file.
     BamAlignment al;
-    vector<BED> hits;
+    vector<size_t> hits;
 
     while (reader.GetNextAlignment(al)) {
         if (al.IsMapped() == true) {
@@ -97,7 +107,7 @@ void TagBam::Tag() {
             for (size_t i = 0; i < _annoFiles.size(); ++i) 
             {
                 // grab the current annotation file.
-                BedFile *anno = _annoFiles[i];
+                const BedIndex *anno = _annoIndexes[i];
                 
                 if (!_useNames && !_useScores && !_useIntervals) {
                     // add the label for this annotation file to tag if there is overlap
@@ -112,7 +122,7 @@ void TagBam::Tag() {
                     anno->allHits(a.chrom, a.start, a.end, a.strand, 
                                   hits, _sameStrand, _diffStrand, _overlapFraction, false);
                     for (size_t i = 0; i < hits.size(); ++i) {
-                        annotations << hits[i].score;
+                        annotations << anno->Get(hits[i]).score;
                         if (i < hits.size() - 1) annotations << ",";
                     }
                     if (hits.size() > 0) annotations << ";";
@@ -123,7 +133,7 @@ void TagBam::Tag() {
                     anno->allHits(a.chrom, a.start, a.end, a.strand, 
                                   hits, _sameStrand, _diffStrand, _overlapFraction, false);
                     for (size_t j = 0; j < hits.size(); ++j) {
-                        annotations << hits[j].name;
+                        annotations << anno->Get(hits[j]).name;
                         if (j < hits.size() - 1) annotations << ",";
                     }
                     if (hits.size() > 0) annotations << ";";
@@ -134,13 +144,14 @@ void TagBam::Tag() {
                     anno->allHits(a.chrom, a.start, a.end, a.strand, 
                                   hits, _sameStrand, _diffStrand,  _overlapFraction, false);
                     for (size_t j = 0; j < hits.size(); ++j) {
+                        const BED &hit = anno->Get(hits[j]);
                         annotations << _annoLabels[i]  << ":" << 
-                                        hits[j].chrom  << ":" <<
-                                        hits[j].start  << "-" <<
-                                        hits[j].end    << "," <<
-                                        hits[j].name   << "," <<
-                                        hits[j].score  << "," <<
-                                        hits[j].strand;
+                                        hit.chrom      << ":" <<
+                                        hit.start      << "-" <<
+                                        hit.end        << "," <<
+                                        hit.name       << "," <<
+                                        hit.score      << "," <<
+                                        hit.strand;
                         if (j < hits.size() - 1) annotations << ",";
                     }
                     if (hits.size() > 0) annotations << ";";
@@ -159,3 +170,255 @@ void TagBam::Tag() {
     // close the annotations files;
     CloseAnnoFiles();
 }
+
+
+/*
+    Sorted mode.
+
+    Rather than loading every annotation file into a bin map and
+    calling allHits for each alignment, we sweep through each annotation
+    file alongside the (coordinate sorted) BAM file. Each annotation file
+    keeps a small cache of the records that may still overlap upcoming
+    alignments, so memory is bounded by the depth of the annotations
+    rather than by their size.
+
+    The annotation files must be sorted by start position, with their
+    chromosomes in the same order as the BAM header.
+*/
+void TagBam::OpenSortedAnnoFiles(const RefVector &refs) {
+    for (size_t i = 0; i < refs.size(); ++i) {
+        _refIds[refs[i].RefName] = (int)i;
+    }
+    for (size_t i = 0; i < _annoFileNames.size(); ++i) {
+        FileRecordMgr *frm = new FileRecordMgr(_annoFileNames[i]);
+        frm->setFileIdx((int)i);
+        frm->setIsSorted(true);
+        if (!frm->open()) {
+            cerr << "Error: Unable to open annotation file " << _annoFileNames[i] << endl;
+            exit(1);
+        }
+        _annoFRMs.push_back(frm);
+        _nextAnnos.push_back(frm->getNextRecord());
+        _annoCaches.push_back(vector<const Record *>());
+        _cacheRefIds.push_back(-1);
+        _prevAnnoRefIds.push_back(-1);
+    }
+}
+
+
+void TagBam::CloseSortedAnnoFiles() {
+    for (size_t i = 0; i < _annoFRMs.size(); ++i) {
+        FileRecordMgr *frm = _annoFRMs[i];
+        for (size_t j = 0; j < _annoCaches[i].size(); ++j) {
+            frm->deleteRecord(_annoCaches[i][j]);
+        }
+        _annoCaches[i].clear();
+        frm->deleteRecord(_nextAnnos[i]);
+        _nextAnnos[i] = NULL;
+        frm->close();
+        delete frm;
+        _annoFRMs[i] = NULL;
+    }
+    _annoFRMs.clear();
+}
+
+
+// returns the BAM RefID for an annotation record's chrom, or -1 if
+// the chrom is not in the BAM header (and thus can't overlap anything).
+int TagBam::AnnoRefId(const Record *anno) {
+    map<string, int>::const_iterator iter = _refIds.find(anno->getChrName().str());
+    if (iter == _refIds.end()) {
+        return -1;
+    }
+    return iter->second;
+}
+
+
+// read from annotation file fileIdx until its next record starts at or
+// after the end of the current alignment, caching any records that may
+// overlap this alignment or a later one.
+void TagBam::AdvanceAnnoFile(size_t fileIdx, int refId, CHRPOS start, CHRPOS end) {
+    FileRecordMgr *frm = _annoFRMs[fileIdx];
+    vector<const Record *> &cache = _annoCaches[fileIdx];
+
+    if (_cacheRefIds[fileIdx] != refId) {
+        // new chromosome: nothing cached for the previous one can overlap.
+        for (size_t j = 0; j < cache.size(); ++j) {
+            frm->deleteRecord(cache[j]);
+        }
+        cache.clear();
+        _cacheRefIds[fileIdx] = refId;
+    }
+
+    while (_nextAnnos[fileIdx] != NULL) {
+        Record *anno = _nextAnnos[fileIdx];
+        int annoRefId = AnnoRefId(anno);
+        if (annoRefId != -1) {
+            if (annoRefId < _prevAnnoRefIds[fileIdx]) {
+                cerr << "Error: Sorted input specified, but the chromosome order of the file " << _annoFileNames[fileIdx]
+                     << " differs from the BAM header of " << _bamFile << ". Record was:" << endl << *anno << endl;
+                exit(1);
+            }
+            _prevAnnoRefIds[fileIdx] = annoRefId;
+        }
+        if (annoRefId > refId || (annoRefId == refId && (CHRPOS)anno->getStartPos() >= end)) {
+            // ahead of the current alignment; leave it for later.
+            break;
+        }
+        if (annoRefId == refId && (CHRPOS)anno->getEndPos() > start) {
+            cache.push_back(anno);
+        } else {
+            // behind the current alignment, or on a chrom absent from the BAM.
+            frm->deleteRecord(anno);
+        }
+        _nextAnnos[fileIdx] = frm->getNextRecord();
+    }
+}
+
+
+// orders the hits of one annotation file as BedIndex::allHits returns
+// them. the hits start out in file order, so a stable sort keeps that
+// order within a bin.
+struct BinSearchOrder {
+    bool operator()(const Record *a, const Record *b) const {
+        return binSearchLess(getBin(a->getStartPos(), a->getEndPos()),
+                             getBin(b->getStartPos(), b->getEndPos()));
+    }
+};
+
+
+// collect the cached records from annotation file fileIdx that overlap
+// the alignment, in the order the unsorted path reports them. cached records
+// that end before the alignment starts can't overlap later alignments either,
+// so they are retired.
+void TagBam::SweepHits(size_t fileIdx, const BED &a, int refId, vector<const Record *> &hits) {
+    AdvanceAnnoFile(fileIdx, refId, a.start, a.end);
+
+    FileRecordMgr *frm = _annoFRMs[fileIdx];
+    vector<const Record *> &cache = _annoCaches[fileIdx];
+    CHRPOS aLength = (a.end - a.start);
+    size_t kept = 0;
+    for (size_t j = 0; j < cache.size(); ++j) {
+        const Record *anno = cache[j];
+        CHRPOS annoStart = anno->getStartPos();
+        CHRPOS annoEnd = anno->getEndPos();
+        if (annoEnd <= a.start) {
+            frm->deleteRecord(anno);
+            continue;
+        }
+        cache[kept++] = anno;
+        if (annoStart >= a.end) continue;
+
+        // same criteria as BedFile::allHits
+        CHRPOS s = max(a.start, annoStart);
+        CHRPOS e = min(a.end, annoEnd);
+        int overlapBases = (e - s);
+        if ((float) overlapBases / (float) aLength >= _overlapFraction) {
+            bool strands_are_same = (anno->getStrand() == a.strand);
+            if ( (_sameStrand == false && _diffStrand == false)
+                 ||
+                 (_sameStrand == true && strands_are_same == true)
+                 ||
+                 (_diffStrand == true && strands_are_same == false)
+               )
+            {
+                hits.push_back(anno);
+            }
+        }
+    }
+    cache.resize(kept);
+    stable_sort(hits.begin(), hits.end(), BinSearchOrder());
+}
+
+
+void TagBam::AddTags(BamAlignment &al, const BED &a, int refId) {
+    ostringstream annotations;
+    vector<const Record *> hits;
+    for (size_t i = 0; i < _annoFRMs.size(); ++i) {
+        SweepHits(i, a, refId, hits);
+        if (hits.empty()) continue;
+
+        if (!_useNames && !_useScores && !_useIntervals) {
+            annotations << _annoLabels[i] << ";";
+        }
+        else {
+            for (size_t j = 0; j < hits.size(); ++j) {
+                const Record *hit = hits[j];
+                if (_useScores) {
+                    annotations << hit->getScore();
+                }
+                else if (_useNames) {
+                    annotations << hit->getName();
+                }
+                else {
+                    annotations << _annoLabels[i]  << ":" <<
+                                   hit->getChrName()  << ":" <<
+                                   hit->getStartPos() << "-" <<
+                                   hit->getEndPos()   << "," <<
+                                   hit->getName()     << "," <<
+                                   hit->getScore()    << "," <<
+                                   hit->getStrand();
+                }
+                if (j < hits.size() - 1) annotations << ",";
+            }
+            annotations << ";";
+        }
+        hits.clear();
+    }
+    // were there any overlaps with which to make a tag?
+    if (annotations.str().size() > 0) {
+        al.AddTag(_tag, "Z", annotations.str().substr(0, annotations.str().size() - 1)); // get rid of the last ";"
+    }
+}
+
+
+void TagBam::TagSorted() {
+
+    // open the BAM file
+    BamReader reader;
+    BamWriter writer;
+    if (!reader.Open(_bamFile)) {
+        cerr << "Failed to open BAM file " << _bamFile << endl;
+        exit(1);
+    }
+
+    // get header & reference information
+    string bamHeader  = reader.GetHeaderText();
+    RefVector refs = reader.GetReferenceData();
+
+    // open the annotations files for sweeping
+    OpenSortedAnnoFiles(refs);
+
+    writer.SetCompressionMode(BamWriter::Compressed);
+    writer.Open("stdout", bamHeader, refs);
+
+    BamAlignment al;
+    int prevRefId = -1;
+    int prevPos = -1;
+    while (reader.GetNextAlignment(al)) {
+        if (al.IsMapped() == true && al.RefID >= 0) {
+            // unmapped reads are placed at the end of a sorted BAM,
+            // so only the mapped ones need to be in order.
+            if (al.RefID < prevRefId || (al.RefID == prevRefId && al.Position < prevPos)) {
+                cerr << "Error: Sorted input specified, but the BAM file " << _bamFile
+                     << " has the following out of order alignment: " << al.Name << endl;
+                exit(1);
+            }
+            prevRefId = al.RefID;
+            prevPos = al.Position;
+
+            BED a;
+            a.chrom = refs.at(al.RefID).RefName;
+            a.start = al.Position;
+            a.end   = al.GetEndPosition(false, false);
+            a.strand = "+";
+            if (al.IsReverseStrand()) a.strand = "-";
+
+            AddTags(al, a, al.RefID);
+        }
+        writer.SaveAlignment(al);
+    }
+    reader.Close();
+    writer.Close();
+    CloseSortedAnnoFiles();
+}
@@ -13,6 +13,7 @@
 #define TAGBAM_H
 
 #include "bedFile.h"
+#include "bedIndex.h"
 
 #include "api/BamReader.h"
 #include "api/BamWriter.h"
@@ -20,6 +21,8 @@
 #include "BamAncillary.h"
 using namespace BamTools;
 
+#include "FileRecordMgr.h"
+
 #include "bedFile.h"
 #include <vector>
 #include <algorithm>
@@ -41,7 +44,7 @@ public:
     TagBam(const string &bamFile, const vector<string> &annoFileNames,
                 const vector<string> &annoLabels, const string &tag, 
                 bool useNames, bool useScores, bool useIntervals, bool sameStrand, 
-                bool diffStrand, float overlapFraction);
+                bool diffStrand, float overlapFraction, bool sortedInput = false);
 
     // destructor
     ~TagBam(void);
@@ -60,6 +63,8 @@ private:
 
     // instance of a bed file class.
     vector<BedFile*> _annoFiles;
+    // and each one, indexed for searching.
+    vector<BedIndex*> _annoIndexes;
 
     // should we use the name field from the annotation files?
     bool _useNames;
@@ -71,6 +76,19 @@ private:
     bool _diffStrand;
     float _overlapFraction;
 
+    // are the BAM and the annotation files coordinate sorted?
+    // if so, we sweep through the annotations rather than
+    // loading each of them into memory.
+    bool _sortedInput;
+
+    // members for the sorted (sweep) mode.
+    vector<FileRecordMgr *> _annoFRMs;
+    vector<Record *> _nextAnnos;               // the next, not yet cached record from each file
+    vector<vector<const Record *> > _annoCaches; // records that may still overlap upcoming alignments
+    vector<int> _cacheRefIds;                  // the BAM RefID of each cache's records
+    vector<int> _prevAnnoRefIds;               // for enforcing the BAM header's chrom order
+    map<string, int> _refIds;                  // chrom name -> BAM RefID
+
     // private function for reporting coverage information
     void ReportAnnotations();
 
@@ -78,5 +96,14 @@ private:
 
     void CloseAnnoFiles();
 
+    // sorted (sweep) mode
+    void TagSorted();
+    void OpenSortedAnnoFiles(const RefVector &refs);
+    void CloseSortedAnnoFiles();
+    int AnnoRefId(const Record *anno);
+    void AdvanceAnnoFile(size_t fileIdx, int refId, CHRPOS start, CHRPOS end);
+    void SweepHits(size_t fileIdx, const BED &a, int refId, vector<const Record *> &hits);
+    void AddTags(BamAlignment &al, const BED &a, int refId);
+
 };
 #endif /* TAGBAM_H */
@@ -44,6 +44,7 @@ int tagbam_main(int argc, char* argv[]) {
     bool haveBam          = false;
     bool haveFiles        = false;
     bool haveLabels       = false;
+    bool sortedInput      = false;
 
 
     // list of annotation files / names
@@ -119,6 +120,9 @@ int tagbam_main(int argc, char* argv[]) {
         else if (PARAMETER_CHECK("-S", 2, parameterLength)) {
             diffStrand = true;
         }
+        else if (PARAMETER_CHECK("-sorted", 7, parameterLength)) {
+            sortedInput = true;
+        }
         else if(PARAMETER_CHECK("-f", 2, parameterLength)) {
             if ((i+1) < argc) {
                 haveFraction = true;
@@ -186,7 +190,7 @@ int tagbam_main(int argc, char* argv[]) {
         TagBam *ba = new TagBam(bamFile, inputFiles, inputLabels, 
                                 tag, useNames, useScores,  
                                 useIntervals, sameStrand, diffStrand, 
-                                overlapFraction);
+                                overlapFraction, sortedInput);
         ba->Tag();
         delete ba;
         return 0;
@@ -229,6 +233,12 @@ void tagbam_help(void) {
 
     cerr << "\t-intervals\t"    << "Use the full interval (including name, score, and strand) to populate tags." << endl;
     cerr                        << "\t\t\tRequires the -labels option to identify from which file the interval came." << endl << endl;    
+
+    cerr << "\t-sorted\t"       << "Use the \"chromsweep\" algorithm for sorted input." << endl;
+    cerr                        << "\t\tThe BAM must be coordinate sorted, and the annotation files" << endl;
+    cerr                        << "\t\tsorted by chrom in the order of the BAM header, then by start." << endl;
+    cerr                        << "\t\tThis is often not the order sort -k1,1 -k2,2n gives." << endl;
+    cerr                        << "\t\tAnnotations are streamed rather than loaded into memory." << endl << endl;
     
     exit(1);
 }
@@ -22,6 +22,9 @@
 using namespace std;
 
 
+const CHRPOS UnionBedGraphs::NO_EVENT;
+
+
 UnionBedGraphs::UnionBedGraphs(std::ostream& _output,
                             const vector<string>& _filenames,
                             const vector<string>& _titles,
@@ -31,6 +34,7 @@ UnionBedGraphs::UnionBedGraphs(std::ostream& _output,
     filenames(_filenames),
     titles(_titles),
     output(_output),
+    depth_columns_dirty(true),
     current_non_zero_inputs(0),
     print_empty_regions(_print_empty_regions),
     genome_sizes(NULL),
@@ -65,10 +69,9 @@ void UnionBedGraphs::Union() {
         // Find the first chromosome to use
         current_chrom = DetermineNextChrom();
 
-        // Populate the queue with initial values from all files
+        // Populate the event tree with initial values from all files
         // (if they belong to the correct chromosome)
-        for(size_t i=0;i<bedgraph_files.size();++i)
-            AddInterval(i);
+        InitEvents();
 
         CHRPOS current_start = ConsumeNextCoordinate();
 
@@ -77,11 +80,11 @@ void UnionBedGraphs::Union() {
             PrintEmptyCoverage(0,current_start);
 
         // Intervals loop - until all intervals (of current chromosome) from all files are used.
-        do {
-            CHRPOS current_end = queue.top().coord;
+        while (events.winnerKey() != NO_EVENT) {
+            CHRPOS current_end = events.winnerKey();
             PrintCoverage(current_start, current_end);
             current_start = ConsumeNextCoordinate();
-        } while (!queue.empty());
+        }
 
         // User wanted empty regions, and the last coordinate is not the last coordinate of the chromosome
             // print a dummy empty coverage
@@ -95,38 +98,69 @@ void UnionBedGraphs::Union() {
 }
 
 
+void UnionBedGraphs::InitEvents() {
+    vector<CHRPOS> keys(bedgraph_files.size());
+    for (size_t i=0;i<bedgraph_files.size();++i)
+        keys[i] = NextEvent(i);
+    events.init(keys, NO_EVENT);
+}
+
+
+CHRPOS UnionBedGraphs::NextEvent(int index) {
+    if (in_interval[index])
+        return interval_end[index];
+
+    //This file has no more intervals, or the next one belongs to a different chrom
+    const BEDGRAPH_STR &bg(current_bedgraph_item[index]);
+    if (bg.chrom.empty() || bg.chrom != current_chrom)
+        return NO_EVENT;
+
+    return bg.start;
+}
+
+
 CHRPOS UnionBedGraphs::ConsumeNextCoordinate() {
-    assert(!queue.empty());
+    assert(events.winnerKey() != NO_EVENT);
 
-    CHRPOS new_position = queue.top().coord;
+    CHRPOS new_position = events.winnerKey();
     do {
-        PointWithDepth item = queue.top();
-        UpdateInformation(item);
-        queue.pop();
-    } while (!queue.empty() && queue.top().coord == new_position);
+        int index = events.winner();
+        UpdateInformation(index);
+        events.update(index, NextEvent(index));
+    } while (events.winnerKey() == new_position);
 
     return new_position;
 }
 
 
-void UnionBedGraphs::UpdateInformation(const PointWithDepth &item) {
+void UnionBedGraphs::UpdateInformation(int index) {
     // Update the depth coverage for this file
 
     // Which coordinate is it - start or end?
-    switch (item.coord_type)
-    {
-    case START:
-        current_depth[item.source_index] = item.depth;
+    if (!in_interval[index]) {
+        // START: the pending interval becomes the current one.
+        const BEDGRAPH_STR &bg(current_bedgraph_item[index]);
+        SetDepth(index, bg.depth);
+        interval_end[index] = bg.end;
+        in_interval[index] = true;
         current_non_zero_inputs++;
-        break;
-    case END:
+
         //Read the next interval from this file
-        AddInterval(item.source_index);
-        current_depth[item.source_index] = no_coverage_value;
+        LoadNextBedgraphItem(index);
+    }
+    else {
+        // END
+        SetDepth(index, no_coverage_value);
+        in_interval[index] = false;
         current_non_zero_inputs--;
-        break;
-    default:
-        assert(0);
+    }
+}
+
+
+void UnionBedGraphs::SetDepth(int index, const std::string &depth) {
+    if (current_depth[index] != depth) {
+        current_depth[index] = depth;
+        depth_columns_dirty = true;
     }
 }
 
@@ -143,26 +177,29 @@ void UnionBedGraphs::PrintCoverage(CHRPOS start, CHRPOS end) {
     if ( current_non_zero_inputs == 0 && ! print_empty_regions )
         return ;
 
+    // only re-assemble the depth columns if one of them has changed
+    // since the last row.
+    if (depth_columns_dirty) {
+        depth_columns.clear();
+        for (size_t i=0;i<current_depth.size();++i) {
+            depth_columns += '\t';
+            depth_columns += current_depth[i];
+        }
+        depth_columns_dirty = false;
+    }
+
     output << current_chrom << "\t"
         << start << "\t"
-        << end;
-
-    for (size_t i=0;i<current_depth.size();++i)
-        output << "\t" << current_depth[i] ;
-
-    output << endl;
+        << end
+        << depth_columns << '\n';
 }
 
 
 void UnionBedGraphs::PrintEmptyCoverage(CHRPOS start, CHRPOS end) {
     output << current_chrom << "\t"
         << start << "\t"
-        << end;
-
-    for (size_t i=0;i<current_depth.size();++i)
-        output << "\t" << no_coverage_value ;
-
-    output << endl;
+        << end
+        << empty_columns << '\n';
 }
 
 
@@ -209,29 +246,6 @@ string UnionBedGraphs::DetermineNextChrom() {
 }
 
 
-void UnionBedGraphs::AddInterval(int index) {
-    assert(static_cast<unsigned int>(index) < bedgraph_files.size());
-
-    //This file has no more intervals
-    if (current_bedgraph_item[index].chrom.empty())
-        return ;
-
-    //If the next interval belongs to a different chrom, don't add it
-    if (current_bedgraph_item[index].chrom!=current_chrom)
-        return ;
-
-    const BEDGRAPH_STR &bg(current_bedgraph_item[index]);
-
-    PointWithDepth start_item(index, START, bg.start, bg.depth);
-    PointWithDepth end_item(index, END, bg.end, bg.depth);
-
-    queue.push(start_item);
-    queue.push(end_item);
-
-    LoadNextBedgraphItem(index);
-}
-
-
 void UnionBedGraphs::OpenBedgraphFiles() {
     for (size_t i=0;i<filenames.size();++i) {
         BedGraphFile *file = new BedGraphFile(filenames[i]);
@@ -239,8 +253,12 @@ void UnionBedGraphs::OpenBedgraphFiles() {
         bedgraph_files.push_back(file);
 
         current_depth.push_back(no_coverage_value);
+        empty_columns += '\t';
+        empty_columns += no_coverage_value;
     }
     current_bedgraph_item.resize(filenames.size());
+    in_interval.resize(filenames.size(), false);
+    interval_end.resize(filenames.size(), 0);
 }
 
 
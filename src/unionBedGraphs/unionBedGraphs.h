@@ -17,7 +17,7 @@
 #include <string>
 #include "bedGraphFile.h"
 #include "GenomeFile.h"
-#include "Point.h"
+#include "LoserTree.h"
 
 class UnionBedGraphs
 {
@@ -31,9 +31,21 @@ private:
     vector<BEDGRAPH_TYPE::DEPTH_TYPE>   current_depth;
     vector<BEDGRAPH_TYPE>               current_bedgraph_item;
 
+    // per-file state of the merge: is the file inside an interval,
+    // and if so, where does that interval end?
+    vector<bool>                        in_interval;
+    vector<CHRPOS>                      interval_end;
+
     std::ostream    &output;
 
-    POINTWITHDEPTH_PQUEUE queue;
+    // k-way merge over the next event (start or end coordinate) of each file.
+    LoserTree<CHRPOS>        events;
+    static const CHRPOS      NO_EVENT = UINT_MAX;
+
+    // the depth columns of the current row, rebuilt only when a depth changes.
+    std::string              depth_columns;
+    bool                     depth_columns_dirty;
+    std::string              empty_columns;
     std::string              current_chrom;
     int                      current_non_zero_inputs;
     bool                     print_empty_regions;
@@ -68,13 +80,17 @@ private:
     void CloseBedgraphFiles();
 
     /*
-       Add an interval from BedGraph file 'index' into the queue.
-       will only be added if it belongs to the current chromosome.
+       Build the event tree for the current chromosome from the next
+       event of each file.
+     */
+    void InitEvents();
 
-       If the interval was added (=consumed), the next interval will be read from the file
-       using 'LoadNextBedgraphItem'
+    /*
+       Returns the coordinate of the next event (the end of the current
+       interval, or the start of the next one) for BedGraph file 'index',
+       or NO_EVENT if the file has no more intervals on the current chromosome.
      */
-    void AddInterval(int index);
+    CHRPOS NextEvent(int index);
 
     /*
        Loads the next interval from BedGraph file 'index'.
@@ -94,17 +110,19 @@ private:
     bool        AllFilesDone();
 
     /*
-       Extract the next coordinate from the queue, and updates the current coverage information.
+       Extract the next coordinate from the event tree, and updates the current coverage information.
        If multiple interval share the same coordinate values, all of them are handled.
-       If an END coordinate is consumed, the next interval (from the corresponding file) is read.
+       If a START coordinate is consumed, the next interval (from the corresponding file) is read.
      */
     CHRPOS ConsumeNextCoordinate();
 
     /*
-       Updates the coverage information based on the given item.
-       Item can be a START coordinate or an END coordiante.
+       Updates the coverage information of file 'index' at its next event,
+       which is either a START coordinate or an END coordiante.
      */
-    void UpdateInformation(const PointWithDepth &item);
+    void UpdateInformation(int index);
+
+    void SetDepth(int index, const std::string &depth);
 
     /*
        prints chrom/start/end and the current depth coverage values of all the files.
@@ -115,8 +133,6 @@ private:
        prints chrom/start/end and the ZERO depth coverage values of all the files.
      */
     void PrintEmptyCoverage(CHRPOS start, CHRPOS end);
-
-    void DebugPrintQueue();
 };
 
 
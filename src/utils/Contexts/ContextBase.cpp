@@ -9,11 +9,13 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <cctype>
+#include <algorithm>
 
 ContextBase::ContextBase()
 :
   _program(UNSPECIFIED_PROGRAM),
   _allFilesOpened(false),
+  _filesShared(false),
   _genomeFile(NULL),
   _outputFileType(FileRecordTypeChecker::UNKNOWN_FILE_TYPE),
   _outputTypeDetermined(false),
@@ -23,6 +25,7 @@ ContextBase::ContextBase()
   _uncompressedBam(false),
   _useBufferedOutput(true),
   _ioBufSize(0),
+  _outBufSize(DEFAULT_OUTBUF_SIZE),
   _anyHit(false),
   _noHit(false),
   _writeA(false),
@@ -46,6 +49,11 @@ ContextBase::ContextBase()
   _printHeader(false),
   _printable(true),
    _explicitBedOutput(false),
+  _columnarOutput(false),
+  _bgzfOutput(false),
+  _gzipOutput(false),
+  _numThreads(1),
+  _tabixPreset(TabixIndexer::BED),
   _queryFileIdx(-1),
   _bamHeaderAndRefIdx(-1),
   _maxNumDatabaseFields(0),
@@ -83,6 +91,7 @@ ContextBase::ContextBase()
 	_programNames["coverage"] = COVERAGE;
 	_programNames["complement"] = COMPLEMENT;
 	_programNames["groupby"] = GROUP_BY;
+	_programNames["batch"] = BATCH;
 
 
 
@@ -104,8 +113,8 @@ ContextBase::~ContextBase()
 	}
 
 
-	//close all files and delete FRM objects.
-	for (int i=0; i < (int)_files.size(); i++) {
+	//close all files and delete FRM objects, unless they're another context's.
+	for (int i=0; !_filesShared && i < (int)_files.size(); i++) {
 		_files[i]->close();
 		delete _files[i];
 		_files[i] = NULL;
@@ -127,7 +136,24 @@ bool ContextBase::determineOutputType() {
 	if (_outputTypeDetermined) {
 		return true;
 	}
+	if (getColumnarOutput() && (getBgzfOutput() || getGzipOutput())) {
+		_errorMsg = "\n***** ERROR: -cbed can't be used with -obgz or -ogz. *****";
+		return false;
+	}
+	if (getBgzfOutput() && getGzipOutput()) {
+		_errorMsg = "\n***** ERROR: -obgz and -ogz can't be used together. *****";
+		return false;
+	}
+	if (!_tabixIndexFile.empty() && !getBgzfOutput()) {
+		_errorMsg = "\n***** ERROR: -tbi needs -obgz output. *****";
+		return false;
+	}
 	//test whether output should be BED or BAM.
+	if (getColumnarOutput()) {
+		setOutputFileType(FileRecordTypeChecker::COLUMNAR_FILE_TYPE);
+		_outputTypeDetermined = true;
+		return true;
+	}
 	//If the user explicitly requested BED, then it's BED.
 	if (getExplicitBedOutput()) {
 		setOutputFileType(FileRecordTypeChecker::SINGLE_LINE_DELIM_TEXT_FILE_TYPE);
@@ -199,6 +225,24 @@ bool ContextBase::parseCmdArgs(int argc, char **argv, int skipFirstArgs) {
         else if (strcmp(_argv[_i], "-bed") == 0) {
 			if (!handle_bed()) return false;
        }
+        else if (strcmp(_argv[_i], "-cbed") == 0) {
+			if (!handle_cbed()) return false;
+        }
+        else if (strcmp(_argv[_i], "-obgz") == 0) {
+			if (!handle_obgz()) return false;
+        }
+        else if (strcmp(_argv[_i], "-ogz") == 0) {
+			if (!handle_ogz()) return false;
+        }
+        else if (strcmp(_argv[_i], "-tbi") == 0) {
+			if (!handle_tbi()) return false;
+        }
+        else if (strcmp(_argv[_i], "-tbip") == 0) {
+			if (!handle_tbip()) return false;
+        }
+        else if (strcmp(_argv[_i], "-threads") == 0) {
+			if (!handle_threads()) return false;
+        }
         else if (strcmp(_argv[_i], "-ubam") == 0) {
 			if (!handle_ubam()) return false;
         }
@@ -214,6 +258,9 @@ bool ContextBase::parseCmdArgs(int argc, char **argv, int skipFirstArgs) {
         else if (strcmp(_argv[_i], "-iobuf") == 0) {
 			if (!handle_iobuf()) return false;
         }
+        else if (strcmp(_argv[_i], "-obuf") == 0) {
+			if (!handle_obuf()) return false;
+        }
         else if (strcmp(_argv[_i], "-prec") == 0) {
 			if (!handle_prec()) return false;
         }
@@ -292,6 +339,18 @@ bool ContextBase::isValidState()
 			_keyListOps->setPrecision(_reportPrecision);
 		}
 	}
+
+	//records need only copy out the columns the column operations read,
+	//from the files they read them from. Tools that read other columns
+	//themselves add those.
+	vector<int> opColumns;
+	if (hasColumnOpsMethods()) {
+		_keyListOps->getOpColumns(opColumns);
+	}
+	for (int i=0; i < (int)_files.size(); i++) {
+		bool isOpsFile = hasIntersectMethods() ? (find(_dbFileIdxs.begin(), _dbFileIdxs.end(), i) != _dbFileIdxs.end()) : i == 0;
+		_files[i]->addNeededColumns(isOpsFile ? opColumns : vector<int>());
+	}
 	return true;
 }
 
@@ -310,6 +369,12 @@ bool ContextBase::cmdArgsValid()
 	return retval;
 }
 
+void ContextBase::shareFiles(ContextBase *owner) {
+	_files = owner->_files;
+	_allFilesOpened = true;
+	_filesShared = true;
+}
+
 bool ContextBase::openFiles() {
 
 	//Make a vector of FileRecordMgr objects by going through the vector
@@ -377,7 +442,6 @@ int ContextBase::getUnspecifiedSeed()
 {
 	// thanks to Rob Long for the tip.
 	_seed = (unsigned)time(0)+(unsigned)getpid();
-	srand(_seed);
 	return _seed;
 }
 
@@ -388,6 +452,72 @@ bool ContextBase::handle_bed()
 	return true;
 }
 
+bool ContextBase::handle_cbed()
+{
+	setColumnarOutput(true);
+	setExplicitBedOutput(true);
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextBase::handle_obgz()
+{
+	setBgzfOutput(true);
+	setExplicitBedOutput(true);
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextBase::handle_ogz()
+{
+	setGzipOutput(true);
+	setExplicitBedOutput(true);
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextBase::handle_tbi()
+{
+	if (_argc <= _i+1) {
+		_errorMsg = "\n***** ERROR: -tbi option given, but no index file specified. *****";
+		return false;
+	}
+	_tabixIndexFile = _argv[_i+1];
+	markUsed(_i - _skipFirstArgs);
+	_i++;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextBase::handle_tbip()
+{
+	if (_argc <= _i+1 || !TabixIndexer::parsePreset(_argv[_i+1], _tabixPreset)) {
+		_errorMsg = "\n***** ERROR: -tbip must be followed by bed, gff or vcf. *****";
+		return false;
+	}
+	markUsed(_i - _skipFirstArgs);
+	_i++;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextBase::handle_threads()
+{
+	if (_argc <= _i+1) {
+		_errorMsg = "\n***** ERROR: -threads option given, but number of threads not specified. *****";
+		return false;
+	}
+	_numThreads = parseNumThreads(_argv[_i+1]);
+	if (_numThreads == 0) {
+		_errorMsg = "\n***** ERROR: -threads must be a number greater than zero. *****";
+		return false;
+	}
+	markUsed(_i - _skipFirstArgs);
+	_i++;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
 bool ContextBase::handle_fbam()
 {
 	setUseFullBamTags(true);
@@ -461,7 +591,20 @@ bool ContextBase::handle_iobuf()
 		_errorMsg = "\n***** ERROR: -iobuf option given, but size of input buffer not specified. *****";
 		return false;
 	}
-	if (!parseIoBufSize(_argv[_i + 1])) return false;
+	if (!parseBufSize(_argv[_i + 1], "-iobuf", _ioBufSize)) return false;
+	markUsed(_i - _skipFirstArgs);
+	_i++;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextBase::handle_obuf()
+{
+	if (_argc <= _i+1) {
+		_errorMsg = "\n***** ERROR: -obuf option given, but size of output buffer not specified. *****";
+		return false;
+	}
+	if (!parseBufSize(_argv[_i + 1], "-obuf", _outBufSize)) return false;
 	markUsed(_i - _skipFirstArgs);
 	_i++;
 	markUsed(_i - _skipFirstArgs);
@@ -476,7 +619,6 @@ bool ContextBase::handle_seed()
 	}
 	_hasConstantSeed = true;
 	_seed  = atoi(_argv[_i+1]);
-	srand(_seed);
 	markUsed(_i - _skipFirstArgs);
 	_i++;
 	markUsed(_i - _skipFirstArgs);
@@ -561,7 +703,6 @@ bool ContextBase::handle_prec()
 }
 
 
-
 // for col ops, -null is a NULL value assigned
 // when no overlaps are detected.
 bool ContextBase::handle_null()
@@ -641,10 +782,22 @@ FileRecordMgr *ContextBase::getNewFRM(const QuickString &filename, int fileIdx)
 	}
 }
 
-bool ContextBase::parseIoBufSize(QuickString bufStr)
+bool ContextBase::parseBufSize(QuickString bufStr, const char *option, int &bufSize)
+{
+	size_t size = 0;
+	if (!parseMemSize(bufStr, option, size)) return false;
+	bufSize = (int)size;
+	if (bufSize < MIN_ALLOWED_BUF_SIZE) {
+		_errorMsg = "\n***** ERROR: specified buffer size is too small. *****";
+		return false;
+	}
+	return true;
+}
+
+bool ContextBase::parseMemSize(QuickString bufStr, const char *option, size_t &size)
 {
 	char lastChar = bufStr[bufStr.size()-1];
-	int multiplier = 1;
+	size_t multiplier = 1;
 	if (!isdigit(lastChar)) {
 		switch (lastChar) {
 		case 'K':
@@ -667,14 +820,12 @@ bool ContextBase::parseIoBufSize(QuickString bufStr)
 		bufStr.resize(bufStr.size()-1);
 	}
 	if (!isNumeric(bufStr)) {
-		_errorMsg = "\n***** ERROR: argument passed to -iobuf is not numeric. *****";
-		return false;
-	}
-	_ioBufSize = str2chrPos(bufStr) * multiplier;
-	if (_ioBufSize < MIN_ALLOWED_BUF_SIZE) {
-		_errorMsg = "\n***** ERROR: specified buffer size is too small. *****";
+		_errorMsg = "\n***** ERROR: argument passed to ";
+		_errorMsg += option;
+		_errorMsg += " is not numeric. *****";
 		return false;
 	}
+	size = (size_t)str2chrPos(bufStr) * multiplier;
 	return true;
 }
 
@@ -25,6 +25,7 @@
 #include "api/BamReader.h"
 #include "api/BamAux.h"
 #include "KeyListOps.h"
+#include "TabixIndexer.h"
 
 
 class ContextBase {
@@ -38,10 +39,13 @@ public:
 	typedef enum {UNSPECIFIED_PROGRAM, INTERSECT, WINDOW, CLOSEST, COVERAGE, MAP, GENOMECOV, MERGE, CLUSTER,
 		COMPLEMENT, SUBTRACT, SLOP, FLANK, SORT, RANDOM, SAMPLE, SHUFFLE, ANNOTATE, MULTIINTER, UNIONBEDG, PAIRTOBED,
 		PAIRTOPAIR,BAMTOBED, BEDTOBAM, BEDTOFASTQ, BEDPETOBAM, BED12TOBED6, GETFASTA, MASKFASTA, NUC,
-		MULTICOV, TAG, JACCARD, OVERLAP, IGV, LINKS,MAKEWINDOWS, GROUPBY, EXPAND, SPACING, FISHER, GROUP_BY} PROGRAM_TYPE;
+		MULTICOV, TAG, JACCARD, OVERLAP, IGV, LINKS,MAKEWINDOWS, GROUPBY, EXPAND, SPACING, FISHER, GROUP_BY, BATCH} PROGRAM_TYPE;
 
 	PROGRAM_TYPE getProgram() const { return _program; }
 	FileRecordMgr *getFile(int fileIdx) { return _files[fileIdx]; }
+	//Use the files another context opened, rather than opening them again.
+	//Call before testCmdArgs. The owner closes them.
+	void shareFiles(ContextBase *owner);
 	void setProgram(PROGRAM_TYPE program) { _program = program; }
 
 	void addInputFile(const QuickString &inputFile) { _fileNames.push_back(inputFile); }
@@ -90,11 +94,28 @@ public:
     bool getExplicitBedOutput() const { return _explicitBedOutput; }
     void setExplicitBedOutput(bool val) { _explicitBedOutput = val; }
 
+    //columnar BED output (see ColumnarFormat.h) is BED, only binary.
+    bool getColumnarOutput() const { return _columnarOutput; }
+    void setColumnarOutput(bool val) { _columnarOutput = val; }
+
+    //BGZF or gzip compressed text output (see GzipWriter.h).
+    bool getBgzfOutput() const { return _bgzfOutput; }
+    void setBgzfOutput(bool val) { _bgzfOutput = val; }
+    bool getGzipOutput() const { return _gzipOutput; }
+    void setGzipOutput(bool val) { _gzipOutput = val; }
+    //from -threads. Compressed output is compressed on this many threads,
+    //and the tools that can split up their own work use it too.
+    int getNumThreads() const { return _numThreads; }
+    //with BGZF output, the file to write a tabix index to, if any.
+    const QuickString &getTabixIndexFile() const { return _tabixIndexFile; }
+    TabixIndexer::PRESET getTabixPreset() const { return _tabixPreset; }
+
     bool getUncompressedBam() const { return _uncompressedBam; }
     void setUncompressedBam(bool val) { _uncompressedBam = val; }
 
     bool getUseBufferedOutput() const { return _useBufferedOutput; }
     void setUseBufferedOutput(bool val) { _useBufferedOutput = val; }
+    int getOutBufSize() const { return _outBufSize; }
 
     virtual bool getSortedInput() const {return _sortedInput; }
     virtual void setSortedInput(bool val) { _sortedInput = val; }
@@ -126,11 +147,9 @@ public:
     virtual void setNumOutputRecords(int val) { _numOutputRecords = val; }
 
 	//SEED OPS FOR APPS WITH RANDOMNESS
-	//When a seed has been specified on the command line, srand
-	//will have been already been called during command line parsing.
-	//For reference, srand is the C function that initializes the
-	//psuedo-random number generator. If a seed has not been
-	//specifified, the user may call the
+	//The seed is for a RandomStream (see RandomStream.h), which
+	//unlike rand() gives the same numbers on every platform. If a
+	//seed has not been specified, getUnspecifiedSeed makes one up.
     virtual bool hasConstantSeed() const { return _hasConstantSeed; }
     virtual int getConstantSeed() const { return _seed; }
     virtual int getUnspecifiedSeed();
@@ -145,6 +164,7 @@ public:
     void setColumnOpsMethods(bool val);
     virtual bool hasColumnOpsMethods() const { return _hasColumnOpsMethods; }
     const QuickString &getColumnOpsVal(RecordKeyVector &keyList) const;
+    KeyListOps *getKeyListOps() const { return _keyListOps; }
     //methods applicable only to column operations.
     int getReportPrecision() const { return _reportPrecision; }
 
@@ -158,6 +178,7 @@ protected:
 	vector<QuickString> _fileNames;
 	vector<FileRecordMgr *> _files;
 	bool _allFilesOpened;
+	bool _filesShared;
 	map<QuickString, PROGRAM_TYPE> _programNames;
 	QuickString _origProgramName;
 
@@ -177,6 +198,7 @@ protected:
     bool _uncompressedBam;
     bool _useBufferedOutput;
     int _ioBufSize;
+    int _outBufSize;
 
 	bool _anyHit;
     bool _noHit;
@@ -201,6 +223,12 @@ protected:
     bool _printHeader;
     bool _printable;
     bool _explicitBedOutput;
+    bool _columnarOutput;
+    bool _bgzfOutput;
+    bool _gzipOutput;
+    int _numThreads;
+    QuickString _tabixIndexFile;
+    TabixIndexer::PRESET _tabixPreset;
     bool _runToQueryEnd;
     int _queryFileIdx;
     vector<int> _dbFileIdxs;
@@ -255,6 +283,7 @@ protected:
 	conventionType _fileHasLeadingZeroInChromNames;
 
 	static const int MIN_ALLOWED_BUF_SIZE = 8;
+	static const int DEFAULT_OUTBUF_SIZE = 4 << 20; //4 M
 	BlockMgr *_splitBlockInfo;
 
     testType _allFilesHaveChrInChromNames;
@@ -264,6 +293,12 @@ protected:
 
 
     virtual bool handle_bed();
+    virtual bool handle_cbed();
+    virtual bool handle_obgz();
+    virtual bool handle_ogz();
+    virtual bool handle_tbi();
+    virtual bool handle_tbip();
+    virtual bool handle_threads();
 	virtual bool handle_fbam();
 	virtual bool handle_g();
 	virtual bool handle_h();
@@ -272,6 +307,7 @@ protected:
 	virtual bool handle_n();
 	virtual bool handle_nobuf();
 	virtual bool handle_iobuf();
+	virtual bool handle_obuf();
 
 	virtual bool handle_seed();
 	virtual bool handle_split();
@@ -285,7 +321,9 @@ protected:
 	virtual bool handle_sortout();
 	virtual bool handle_nonamecheck();
 	bool handle_prec();
-	bool parseIoBufSize(QuickString bufStr);
+	bool parseBufSize(QuickString bufStr, const char *option, int &bufSize);
+	//as parseBufSize, for sizes that may pass 2G.
+	bool parseMemSize(QuickString bufStr, const char *option, size_t &size);
 
     testType fileHasChrInChromNames(int fileIdx);
     testType fileHasLeadingZeroInChromNames(int fileIdx);
@@ -0,0 +1,188 @@
+/*
+ * ContextBatch.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ContextBatch.h"
+#include <fstream>
+#include <sstream>
+
+ContextBatch::ContextBatch()
+{
+	// the shared sweep requires sorted input
+	setSortedInput(true);
+}
+
+ContextBatch::~ContextBatch()
+{
+
+}
+
+bool ContextBatch::isBatchTool(const QuickString &tool)
+{
+	return (tool == "intersect" || tool == "map" ||
+			tool == "coverage" || tool == "subtract");
+}
+
+bool ContextBatch::parseCmdArgs(int argc, char **argv, int skipFirstArgs) {
+	for (_i=_skipFirstArgs; _i < argc; _i++) {
+		if (isUsed(_i - _skipFirstArgs)) {
+			continue;
+		}
+		int firstArg = _i;
+		if (strcmp(_argv[_i], "-script") == 0) {
+			if (!handle_script()) return false;
+			continue;
+		}
+		else if ((strcmp(_argv[_i], "-h") == 0) || (strcmp(_argv[_i], "--help") == 0)) {
+			if (!handle_h()) return false;
+			continue;
+		}
+		// the rest are input options, which are passed on to every job.
+		else if (strcmp(_argv[_i], "-a") == 0) {
+			if (!handle_a()) return false;
+		}
+		else if (strcmp(_argv[_i], "-b") == 0) {
+			if (!handle_b()) return false;
+		}
+		else if (strcmp(_argv[_i], "-names") == 0) {
+			if (!handle_names()) return false;
+		}
+		else if (strcmp(_argv[_i], "-filenames") == 0) {
+			if (!handle_filenames()) return false;
+		}
+		else if (strcmp(_argv[_i], "-g") == 0) {
+			if (!handle_g()) return false;
+		}
+		else if (strcmp(_argv[_i], "-nonamecheck") == 0) {
+			if (!handle_nonamecheck()) return false;
+		}
+		else if (strcmp(_argv[_i], "-iobuf") == 0) {
+			if (!handle_iobuf()) return false;
+		}
+		else if (strcmp(_argv[_i], "-obuf") == 0) {
+			if (!handle_obuf()) return false;
+		}
+		else {
+			continue;
+		}
+		for (int j = firstArg; j <= _i; j++) {
+			_sharedArgs.push_back(_argv[j]);
+		}
+	}
+	return true;
+}
+
+bool ContextBatch::isValidState()
+{
+	if (!ContextIntersect::isValidState()) {
+		return false;
+	}
+	if (_scriptFile.empty()) {
+		_errorMsg = "\n***** ERROR: no script file given. Use -script. *****";
+		return false;
+	}
+	return readScript();
+}
+
+vector<char *> ContextBatch::getJobArgv(int idx)
+{
+	vector<char *> jobArgv;
+	vector<string> &args = _jobs[idx]._args;
+	for (int i = 0; i < (int)args.size(); i++) {
+		jobArgv.push_back(&(args[i][0]));
+	}
+	return jobArgv;
+}
+
+bool ContextBatch::handle_script()
+{
+	if (_argc <= _i+1) {
+		_errorMsg = "\n***** ERROR: -script option given, but no script file specified. *****";
+		return false;
+	}
+	_scriptFile = _argv[_i+1];
+	markUsed(_i - _skipFirstArgs);
+	_i++;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextBatch::readScript()
+{
+	ifstream script(_scriptFile.c_str());
+	if (!script.good()) {
+		_errorMsg = "\n***** ERROR: Unable to open script file ";
+		_errorMsg += _scriptFile;
+		_errorMsg += ". *****";
+		return false;
+	}
+
+	string line;
+	int lineNum = 0;
+	while (getline(script, line)) {
+		lineNum++;
+		istringstream tokens(line);
+		string token;
+		Job job;
+		bool haveOutput = false;
+		while (tokens >> token) {
+			if (token[0] == '#') {
+				break;
+			}
+			if (job._tool.empty()) {
+				job._tool = token;
+				job._args.push_back(token);
+				continue;
+			}
+			if (token[0] == '>') {
+				string outputFile = token.substr(1);
+				if (haveOutput || (outputFile.empty() && !(tokens >> outputFile))) {
+					return scriptError(lineNum, "expected a single output file after '>'");
+				}
+				job._outputFile = outputFile;
+				haveOutput = true;
+				continue;
+			}
+			if (haveOutput) {
+				return scriptError(lineNum, "options must come before the output file");
+			}
+			if (token == "-a" || token == "-abam" || token == "-b" || token == "-i") {
+				return scriptError(lineNum, "input files are given to batch, not to its jobs");
+			}
+			job._args.push_back(token);
+		}
+		if (job._tool.empty()) {
+			continue;
+		}
+		if (!isBatchTool(job._tool)) {
+			return scriptError(lineNum, "batch supports intersect, map, coverage and subtract");
+		}
+		if (!haveOutput) {
+			return scriptError(lineNum, "no output file given. End the line with '> file'");
+		}
+		job._args.insert(job._args.end(), _sharedArgs.begin(), _sharedArgs.end());
+		job._args.push_back("-sorted");
+		_jobs.push_back(job);
+	}
+	if (_jobs.empty()) {
+		_errorMsg = "\n***** ERROR: script file ";
+		_errorMsg += _scriptFile;
+		_errorMsg += " has no jobs. *****";
+		return false;
+	}
+	return true;
+}
+
+bool ContextBatch::scriptError(int lineNum, const char *msg)
+{
+	_errorMsg = "\n***** ERROR: ";
+	_errorMsg += _scriptFile;
+	_errorMsg += ", line ";
+	_errorMsg += lineNum;
+	_errorMsg += ": ";
+	_errorMsg += msg;
+	_errorMsg += ". *****";
+	return false;
+}
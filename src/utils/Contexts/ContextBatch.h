@@ -0,0 +1,55 @@
+/*
+ * ContextBatch.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef CONTEXTBATCH_H_
+#define CONTEXTBATCH_H_
+
+#include "ContextIntersect.h"
+
+// bedtools batch reads -a and -b once, and fans the hits of a single
+// sorted sweep out to several tools listed in a script. Each script line
+// is a tool invocation, minus the inputs, followed by its output file:
+//
+//	intersect -u > overlaps.bed
+//	coverage -hist > coverage.txt
+//	map -c 5 -o mean > means.bed
+//
+// The input options given to batch (-a, -b, -names, -g, etc.) are
+// appended to every job.
+class ContextBatch : public ContextIntersect {
+public:
+	ContextBatch();
+	virtual ~ContextBatch();
+	virtual bool parseCmdArgs(int argc, char **argv, int skipFirstArgs);
+	virtual bool isValidState();
+
+	int getNumJobs() const { return (int)_jobs.size(); }
+	const QuickString &getJobTool(int idx) const { return _jobs[idx]._tool; }
+	const QuickString &getJobOutputFile(int idx) const { return _jobs[idx]._outputFile; }
+
+	// argv for the job's own context: the tool name, the job's options,
+	// then the shared input options and -sorted.
+	vector<char *> getJobArgv(int idx);
+
+	static bool isBatchTool(const QuickString &tool);
+
+protected:
+	class Job {
+	public:
+		QuickString _tool;
+		QuickString _outputFile;
+		vector<string> _args;
+	};
+	vector<Job> _jobs;
+	vector<string> _sharedArgs;
+	QuickString _scriptFile;
+
+	bool handle_script();
+	bool readScript();
+	bool scriptError(int lineNum, const char *msg);
+};
+
+#endif /* CONTEXTBATCH_H_ */
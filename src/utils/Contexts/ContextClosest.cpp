@@ -12,6 +12,8 @@ ContextClosest::ContextClosest()
 	_ignoreOverlaps(false),
 	_ignoreUpstream(false),
 	_ignoreDownstream(false),
+	_forceUpstream(false),
+	_forceDownstream(false),
 	_reportDistance(false),
 	_signDistance(false),
 	_haveStrandedDistMode(false),
@@ -74,6 +76,9 @@ bool ContextClosest::parseCmdArgs(int argc, char **argv, int skipFirstArgs){
         else if (strcmp(_argv[_i], "-k") == 0) {
         	if (!handle_k()) return false;
         }
+        else if (strcmp(_argv[_i], "-unsorted") == 0) {
+        	if (!handle_unsorted()) return false;
+        }
 
 	}
 	return ContextIntersect::parseCmdArgs(argc, argv, _skipFirstArgs);
@@ -120,6 +125,11 @@ bool ContextClosest::isValidState(){
 		return false;
 	}
 
+	if (_numThreads > 1 && _sortedInput && !getBgzfOutput() && !getGzipOutput()) {
+		_errorMsg  = "\n*****\n*****ERROR: -threads is only for -unsorted input, or -obgz or -ogz output.\n*****\n";
+		return false;
+	}
+
 	if (_sortOutput && _reportDistance) {
 		_errorMsg  = "\n*****\n*****ERROR: -sortout (sorted output) is not valid with distance reporting.\n*****\n";
 		return false;
@@ -268,3 +278,12 @@ bool ContextClosest::handle_k()
 	return false;
 }
 
+
+bool ContextClosest::handle_unsorted()
+{
+	//load the database files into an index instead of sweeping.
+	setSortedInput(false);
+    markUsed(_i - _skipFirstArgs);
+    return true;
+}
+
@@ -67,6 +67,7 @@ private:
     bool handle_t();
     bool handle_mdb();
     bool handle_k();
+    bool handle_unsorted();
 };
 
 
@@ -10,7 +10,9 @@
 
 ContextGroupBy::ContextGroupBy()
 : _printFullCols(false),
-  _ignoreCase(false)
+  _ignoreCase(false),
+  _unsortedInput(false),
+  _maxMem(DEFAULT_MAX_MEM)
 {
 	setSortedInput(true);
 	_noEnforceCoordSort = true;
@@ -54,6 +56,12 @@ bool ContextGroupBy::parseCmdArgs(int argc, char **argv, int skipFirstArgs)
 		else if (strcmp(_argv[_i], "-ignorecase") == 0) {
 			if (!handle_ignorecase()) return false;
 		}
+		else if (strcmp(_argv[_i], "-unsorted") == 0) {
+			if (!handle_unsorted()) return false;
+		}
+		else if (strcmp(_argv[_i], "-mem") == 0) {
+			if (!handle_mem()) return false;
+		}
 	}
 	return ContextBase::parseCmdArgs(argc, argv, _skipFirstArgs);
 }
@@ -73,6 +81,12 @@ bool ContextGroupBy::isValidState()
 	//default grouping is cols 1,2,3
 	if (_groupStr.empty()) _groupStr = "1,2,3";
 
+	//-unsorted already sums up each group as it's read.
+	if (_unsortedInput && _numThreads > 1 && !getBgzfOutput() && !getGzipOutput()) {
+		_errorMsg = "\n***** ERROR: -threads is only for sorted input, or -obgz or -ogz output. *****";
+		return false;
+	}
+
 	return ContextBase::isValidState();
 }
 
@@ -122,6 +136,28 @@ bool ContextGroupBy::handle_ignorecase() {
 	return true;
 }
 
+bool ContextGroupBy::handle_unsorted() {
+	_unsortedInput = true;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
+bool ContextGroupBy::handle_mem() {
+	if (_argc <= _i+1) {
+		_errorMsg = "\n***** ERROR: -mem option given, but no amount of memory specified. *****";
+		return false;
+	}
+	if (!parseMemSize(_argv[_i + 1], "-mem", _maxMem)) return false;
+	if (_maxMem < MIN_MAX_MEM) {
+		_errorMsg = "\n***** ERROR: -mem must be at least 1K. *****";
+		return false;
+	}
+	markUsed(_i - _skipFirstArgs);
+	_i++;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
+
 const QuickString &ContextGroupBy::getDefaultHeader() {
 	//groupBy does not support multiple databases.
 	FileRecordMgr *frm = _files[0];
@@ -20,6 +20,11 @@ public:
 	bool printFullCols() const { return _printFullCols; }
 	const QuickString &getGroupCols() const { return _groupStr; }
 	bool ignoreCase() const { return _ignoreCase; }
+	//input need not be grouped; groups are gathered as they're found.
+	bool unsortedInput() const { return _unsortedInput; }
+	//with -unsorted, about how much memory the groups may take before
+	//those found after are spilled to disk.
+	size_t getMaxMem() const { return _maxMem; }
 	const QuickString &getDefaultHeader();
 
 protected:
@@ -27,6 +32,8 @@ protected:
 	QuickString _defaultHeader;
 	bool _printFullCols;
 	bool _ignoreCase;
+	bool _unsortedInput;
+	size_t _maxMem;
 
 	bool handle_g();
 	bool handle_inheader();
@@ -34,6 +41,11 @@ protected:
 	bool handle_header();
 	bool handle_full();
 	bool handle_ignorecase();
+	bool handle_unsorted();
+	bool handle_mem();
+
+	static const size_t DEFAULT_MAX_MEM = (size_t)1 << 30; //1 G
+	static const size_t MIN_MAX_MEM = 1 << 10; //1 K
 };
 
 
@@ -7,6 +7,8 @@
 #include "ContextSample.h"
 
 ContextSample::ContextSample()
+: _weighted(false),
+  _perChrom(false)
 {
 
 }
@@ -25,6 +27,12 @@ bool ContextSample::parseCmdArgs(int argc, char **argv, int skipFirstArgs) {
         else if (strcmp(_argv[_i], "-s") == 0) {
 			if (!handle_s()) return false;
         }
+        else if (strcmp(_argv[_i], "-w") == 0) {
+			if (!handle_w()) return false;
+        }
+        else if (strcmp(_argv[_i], "-perChrom") == 0) {
+			if (!handle_perChrom()) return false;
+        }
 	}
 	return ContextBase::parseCmdArgs(argc, argv, _skipFirstArgs);
 }
@@ -39,6 +47,10 @@ bool ContextSample::isValidState()
 		// Allow one and only input file for now
 		return false;
 	}
+	if (_weighted && !getFile(0)->recordsHaveScore()) {
+		_errorMsg = "\n***** ERROR: -w needs records with a score. *****";
+		return false;
+	}
 	return true;
 }
 
@@ -64,4 +76,16 @@ bool ContextSample::handle_s()
     return true;
 }
 
+bool ContextSample::handle_w()
+{
+	_weighted = true;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
 
+bool ContextSample::handle_perChrom()
+{
+	_perChrom = true;
+	markUsed(_i - _skipFirstArgs);
+	return true;
+}
@@ -22,9 +22,16 @@ public:
 	void setSameStrand(bool val) { _sameStrand = val; }
 	bool getForwardOnly() const { return _forwardOnly; }
 	bool getReverseOnly() const { return _reverseOnly; }
+	bool getWeighted() const { return _weighted; }
+	bool getPerChrom() const { return _perChrom; }
 
 private:
+	bool _weighted;
+	bool _perChrom;
+
 	virtual bool handle_s();
+	bool handle_w();
+	bool handle_perChrom();
 };
 
 
@@ -125,12 +125,40 @@ bool BufferedStreamMgr::getLine(QuickString &line)
 	//strip any whitespace characters, such as DOS newline characters or extra tabs,
 	//from the end of the line
 	int lastPos = line.size();
-	while (isspace(line[lastPos-1])) lastPos--;
+	while (lastPos > 0 && isspace(line[lastPos-1])) lastPos--;
 	line.resize(lastPos);
 
 	return retVal;
 }
 
+size_t BufferedStreamMgr::read(char *buf, size_t len)
+{
+	size_t numRead = 0;
+	while (numRead < len) {
+		if (_mainBufCurrStartPos >= _mainBufCurrLen) {
+			if (!_streamFinished && len - numRead >= (size_t)_useBufSize) {
+				//large request with an empty buffer. Skip the copy into the main buffer.
+				size_t want = len - numRead;
+				size_t got = _inputStreamMgr->read(buf + numRead, want);
+				if (got < want) {
+					_streamFinished = true;
+				}
+				numRead += got;
+				continue;
+			}
+			if (!readFileChunk()) {
+				_eof = true;
+				break;
+			}
+		}
+		size_t chunk = min(len - numRead, (size_t)(_mainBufCurrLen - _mainBufCurrStartPos));
+		memcpy(buf + numRead, _mainBuf + _mainBufCurrStartPos, chunk);
+		_mainBufCurrStartPos += chunk;
+		numRead += chunk;
+	}
+	return numRead;
+}
+
 bool BufferedStreamMgr::readFileChunk()
 {
 	if (eof()) {
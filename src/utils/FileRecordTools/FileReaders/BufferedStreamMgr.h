@@ -24,6 +24,8 @@ public:
 
 	bool eof() const { return _eof; }
 	bool getLine(QuickString &line);
+	//binary read of up to len bytes. Returns the number of bytes read.
+	size_t read(char *buf, size_t len);
 	BamTools::BamReader *getBamReader() { return _inputStreamMgr->getBamReader(); }
 	static const int DEFAULT_MAIN_BUF_READ_SIZE = 1023;
 	void setIoBufSize(int val) { _useBufSize = val; }
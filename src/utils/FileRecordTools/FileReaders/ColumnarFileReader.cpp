@@ -0,0 +1,247 @@
+/*
+ * ColumnarFileReader.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ColumnarFileReader.h"
+#include <iostream>
+#include <zlib.h>
+#include "BufferedStreamMgr.h"
+#include "ParseTools.h"
+
+ColumnarFileReader::ColumnarFileReader(int numFields)
+: SingleLineDelimTextFileReader(numFields),
+  _eof(false),
+  _blockChromId(-1),
+  _blockNumRecs(0),
+  _currRec(-1),
+  _posAsText(false),
+  _numTextCols(0)
+{
+}
+
+ColumnarFileReader::~ColumnarFileReader()
+{
+}
+
+bool ColumnarFileReader::open()
+{
+	if (!SingleLineDelimTextFileReader::open()) {
+		return false;
+	}
+	//skip past the file header. The type checker has already
+	//validated it, and used the sample.
+	char fixed[ColumnarFormat::MAGIC_LEN + 9];
+	if (!readBytes(fixed, sizeof(fixed))) {
+		formatError("is truncated");
+	}
+	_numFields = (int)ColumnarFormat::getUint32(fixed + ColumnarFormat::MAGIC_LEN + 1);
+	uint32_t headerLen = ColumnarFormat::getUint32(fixed + ColumnarFormat::MAGIC_LEN + 5);
+	_storedBlock.resize(headerLen + 1);
+	if (!readBytes(&_storedBlock[0], headerLen)) {
+		formatError("is truncated");
+	}
+	_header.assign(&_storedBlock[0], headerLen);
+	_fullHeaderFound = true;
+
+	uint32_t sampleLen = 0;
+	if (!readUint32(sampleLen)) {
+		formatError("is truncated");
+	}
+	_storedBlock.resize(sampleLen + 1);
+	if (!readBytes(&_storedBlock[0], sampleLen)) {
+		formatError("is truncated");
+	}
+	return true;
+}
+
+bool ColumnarFileReader::readEntry()
+{
+	if (_eof) {
+		return false;
+	}
+	_currRec++;
+	while (_currRec >= _blockNumRecs) {
+		if (!readBlock()) {
+			_eof = true;
+			return false;
+		}
+		_currRec = 0;
+	}
+	_lineNum++;
+	return true;
+}
+
+bool ColumnarFileReader::readBlock()
+{
+	while (1) {
+		char tag = 0;
+		if (!readBytes(&tag, 1)) {
+			formatError("is truncated");
+		}
+		if (tag == ColumnarFormat::END_TAG) {
+			return false;
+		} else if (tag == ColumnarFormat::CHROM_TAG) {
+			uint32_t nameLen = 0;
+			if (!readUint32(nameLen)) {
+				formatError("is truncated");
+			}
+			_storedBlock.resize(nameLen + 1);
+			if (!readBytes(&_storedBlock[0], nameLen)) {
+				formatError("is truncated");
+			}
+			QuickString name;
+			name.assign(&_storedBlock[0], nameLen);
+			_chromNames.push_back(name);
+		} else if (tag == ColumnarFormat::INDEX_TAG) {
+			//the index is for seeking. Reading straight through, it's skipped.
+			uint32_t numChroms = 0;
+			if (!readUint32(numChroms)) {
+				formatError("is truncated");
+			}
+			_storedBlock.resize(numChroms * 8 + 1);
+			if (!readBytes(&_storedBlock[0], numChroms * 8)) {
+				formatError("is truncated");
+			}
+		} else if (tag == ColumnarFormat::BLOCK_TAG) {
+			break;
+		} else {
+			formatError("is corrupt");
+		}
+	}
+
+	uint32_t chromId = 0, numRecs = 0, rawLen = 0, storedLen = 0;
+	char flags = 0;
+	if (!readUint32(chromId) || !readUint32(numRecs) || !readUint32(rawLen) || !readUint32(storedLen) ||
+			!readBytes(&flags, 1)) {
+		formatError("is truncated");
+	}
+	if (chromId >= _chromNames.size() || numRecs == 0 || rawLen == 0 || _numFields < 3) {
+		formatError("is corrupt");
+	}
+	_rawBlock.resize(rawLen);
+	if (storedLen == rawLen) {
+		if (!readBytes(&_rawBlock[0], rawLen)) {
+			formatError("is truncated");
+		}
+	} else {
+		_storedBlock.resize(storedLen + 1);
+		if (!readBytes(&_storedBlock[0], storedLen)) {
+			formatError("is truncated");
+		}
+		uLongf destLen = rawLen;
+		if (uncompress((Bytef *)&_rawBlock[0], &destLen, (const Bytef *)&_storedBlock[0], storedLen) != Z_OK ||
+				destLen != rawLen) {
+			formatError("has a block that can't be uncompressed");
+		}
+	}
+
+	//decode the columns.
+	const char *blockStart = &_rawBlock[0];
+	const char *pos = blockStart;
+	const char *end = blockStart + rawLen;
+	uint32_t val = 0;
+	_posAsText = (flags & ColumnarFormat::POSITIONS_AS_TEXT) != 0;
+	if (!_posAsText) {
+		_starts.resize(numRecs);
+		_ends.resize(numRecs);
+		uint32_t prevStart = 0;
+		for (uint32_t i = 0; i < numRecs; i++) {
+			if (!ColumnarFormat::getVarint(pos, end, val)) {
+				formatError("is corrupt");
+			}
+			prevStart += (uint32_t)ColumnarFormat::unzigzag(val);
+			_starts[i] = (int)prevStart;
+		}
+		for (uint32_t i = 0; i < numRecs; i++) {
+			if (!ColumnarFormat::getVarint(pos, end, val)) {
+				formatError("is corrupt");
+			}
+			_ends[i] = (int)((uint32_t)_starts[i] + (uint32_t)ColumnarFormat::unzigzag(val));
+		}
+	}
+	_numTextCols = _posAsText ? _numFields - 1 : _numFields - 3;
+	_fieldStarts.resize(numRecs * _numTextCols);
+	_fieldLens.resize(numRecs * _numTextCols);
+	for (int col = 0; col < _numTextCols; col++) {
+		for (uint32_t i = 0; i < numRecs; i++) {
+			if (!ColumnarFormat::getVarint(pos, end, val) || val > (uint32_t)(end - pos)) {
+				formatError("is corrupt");
+			}
+			_fieldStarts[i * _numTextCols + col] = (int)(pos - blockStart);
+			_fieldLens[i * _numTextCols + col] = (int)val;
+			pos += val;
+		}
+	}
+	_blockChromId = (int)chromId;
+	_blockNumRecs = (int)numRecs;
+	_currChromId = _blockChromId;
+	return true;
+}
+
+void ColumnarFileReader::getField(int fieldNum, QuickString &str) const {
+	str.clear();
+	appendField(fieldNum, str);
+}
+
+void ColumnarFileReader::getField(int fieldNum, int &val) {
+	if (fieldNum == 1 && !_posAsText) {
+		val = _starts[_currRec];
+	} else if (fieldNum == 2 && !_posAsText) {
+		val = _ends[_currRec];
+	} else {
+		getField(fieldNum, _tempChrPosStr);
+		val = str2chrPos(_tempChrPosStr.c_str());
+	}
+}
+
+void ColumnarFileReader::getField(int fieldNum, char &val) const {
+	int idx = textFieldIdx(fieldNum);
+	if (idx < 0) {
+		QuickString str;
+		appendField(fieldNum, str);
+		val = str[0];
+		return;
+	}
+	val = _fieldLens[idx] > 0 ? _rawBlock[_fieldStarts[idx]] : '\0';
+}
+
+void ColumnarFileReader::appendField(int fieldNum, QuickString &str) const {
+	if (fieldNum == 0) {
+		str.append(_chromNames[_blockChromId]);
+		return;
+	}
+	int idx = textFieldIdx(fieldNum);
+	if (idx >= 0) {
+		str.append(&_rawBlock[0] + _fieldStarts[idx], _fieldLens[idx]);
+	} else if (fieldNum == 1) {
+		int2str(_starts[_currRec], str, true);
+	} else {
+		int2str(_ends[_currRec], str, true);
+	}
+}
+
+bool ColumnarFileReader::readBytes(char *buf, size_t len)
+{
+	if (len == 0) {
+		return true;
+	}
+	return _bufStreamMgr->read(buf, len) == len;
+}
+
+bool ColumnarFileReader::readUint32(uint32_t &val)
+{
+	char buf[4];
+	if (!readBytes(buf, 4)) {
+		return false;
+	}
+	val = ColumnarFormat::getUint32(buf);
+	return true;
+}
+
+void ColumnarFileReader::formatError(const char *msg)
+{
+	cerr << "Error: columnar BED file " << _filename << " " << msg << "." << endl;
+	exit(1);
+}
@@ -0,0 +1,61 @@
+/*
+ * ColumnarFileReader.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef COLUMNARFILEREADER_H_
+#define COLUMNARFILEREADER_H_
+
+#include "SingleLineDelimTextFileReader.h"
+#include "ColumnarFormat.h"
+
+//Reads columnar BED files (see ColumnarFormat.h). Records are served a
+//block at a time from the decoded columns, through the same field
+//interface as delimited text, so the text record classes work unchanged.
+class ColumnarFileReader : public SingleLineDelimTextFileReader {
+public:
+	ColumnarFileReader(int numFields);
+	~ColumnarFileReader();
+
+	virtual bool open();
+	virtual bool eof() const { return _eof; }
+	virtual bool readEntry();
+	virtual void getField(int numField, QuickString &val) const;
+	virtual void getField(int numField, int &val);
+	virtual void getField(int fieldNum, char &val) const;
+	virtual void appendField(int fieldNum, QuickString &str) const;
+	virtual void appendFields(int firstField, QuickString &str, vector<int> &fieldEnds) const {
+		appendFieldsOneByOne(firstField, str, fieldEnds);
+	}
+
+private:
+	bool _eof;
+	vector<QuickString> _chromNames;
+
+	//the decoded block.
+	int _blockChromId;
+	int _blockNumRecs;
+	int _currRec;
+	bool _posAsText;
+	int _numTextCols;
+	vector<int> _starts;
+	vector<int> _ends;
+	vector<char> _storedBlock;
+	vector<char> _rawBlock;
+	vector<int> _fieldStarts; //record-major, _numTextCols per record.
+	vector<int> _fieldLens;
+
+	//index of a field that's stored as text, or -1 if it isn't.
+	int textFieldIdx(int fieldNum) const {
+		int col = _posAsText ? fieldNum - 1 : fieldNum - 3;
+		return col < 0 ? -1 : _currRec * _numTextCols + col;
+	}
+
+	bool readBytes(char *buf, size_t len);
+	bool readUint32(uint32_t &val);
+	bool readBlock();
+	void formatError(const char *msg);
+};
+
+#endif /* COLUMNARFILEREADER_H_ */
@@ -11,7 +11,8 @@ SingleLineDelimTextFileReader::SingleLineDelimTextFileReader(int numFields, char
   _fullHeaderFound(false),
   _currDataPos(0),
   _lineNum(0),
-  _inheader(false)
+  _inheader(false),
+  _allFieldsNeeded(true)
 {
 	_delimPositions = new int[numFields +1];
 }
@@ -105,6 +106,48 @@ void SingleLineDelimTextFileReader::appendField(int fieldNum, QuickString &str)
 	str.append(_sLine.c_str() + startPos, endPos - startPos);
 }
 
+void SingleLineDelimTextFileReader::appendFields(int firstField, QuickString &str, vector<int> &fieldEnds) const {
+	if (_delimChar != '\t') {
+		appendFieldsOneByOne(firstField, str, fieldEnds);
+		return;
+	}
+	//the fields are already tab separated, so take them in one piece.
+	int numFields = _numFields - firstField;
+	fieldEnds.resize(numFields);
+	if (numFields <= 0) {
+		return;
+	}
+	int startPos = _delimPositions[firstField] +1;
+	int offset = (int)str.size() - startPos;
+	for (int i=0; i < numFields; i++) {
+		fieldEnds[i] = _delimPositions[firstField + i + 1] + offset;
+	}
+	str.append(_sLine.c_str() + startPos, _delimPositions[_numFields] - startPos);
+}
+
+void SingleLineDelimTextFileReader::appendFieldsOneByOne(int firstField, QuickString &str, vector<int> &fieldEnds) const {
+	int numFields = _numFields - firstField;
+	fieldEnds.resize(numFields < 0 ? 0 : numFields);
+	for (int i=0; i < numFields; i++) {
+		if (i > 0) {
+			str.append('\t');
+		}
+		appendField(firstField + i, str);
+		fieldEnds[i] = str.size();
+	}
+}
+
+void SingleLineDelimTextFileReader::addNeededFields(const vector<int> &fieldNums) {
+	_allFieldsNeeded = false;
+	for (int i=0; i < (int)fieldNums.size(); i++) {
+		if (fieldNums[i] < 0) continue;
+		if (fieldNums[i] >= (int)_neededFields.size()) {
+			_neededFields.resize(fieldNums[i] +1, false);
+		}
+		_neededFields[fieldNums[i]] = true;
+	}
+}
+
 bool SingleLineDelimTextFileReader::detectAndHandleHeader()
 {
 	//not sure why the linker is giving me a hard time about
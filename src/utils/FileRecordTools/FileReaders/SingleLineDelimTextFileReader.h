@@ -28,10 +28,20 @@ public:
 	virtual void getField(int numField, int &val); //this signaiture isn't const because it operates on an internal QuickString for speed.
 	virtual void getField(int fieldNum, char &val) const;
 	virtual void appendField(int fieldNum, QuickString &str) const;
+	//Appends the fields from firstField on, tab separated, and sets
+	//fieldEnds to where each of them ends in str.
+	virtual void appendFields(int firstField, QuickString &str, vector<int> &fieldEnds) const;
 	virtual const QuickString &getHeader() const { return _header; }
 	virtual bool hasHeader() const { return _fullHeaderFound; }
 	virtual void setInHeader(bool val) { _inheader = val; }
 
+	//Records copy out every one of their fields until the tool names the
+	//ones it will read from them (see FileRecordMgr::addNeededColumns).
+	void addNeededFields(const vector<int> &fieldNums);
+	bool isFieldNeeded(int fieldNum) const {
+		return _allFieldsNeeded || (fieldNum < (int)_neededFields.size() && _neededFields[fieldNum]);
+	}
+
 protected:
 	int _numFields;
 	char _delimChar;
@@ -44,7 +54,10 @@ protected:
 	QuickString _tempChrPosStr;
 	int _lineNum;
 	bool _inheader;
+	bool _allFieldsNeeded;
+	vector<bool> _neededFields;
 	bool detectAndHandleHeader();
+	void appendFieldsOneByOne(int firstField, QuickString &str, vector<int> &fieldEnds) const;
 	bool findDelimiters();
 
 	//This is actually a very specialized function strictly for VCF
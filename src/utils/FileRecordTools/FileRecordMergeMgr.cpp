@@ -139,19 +139,28 @@ Record *FileRecordMergeMgr::getNextRecord(RecordKeyVector *recList)
 			continue; //get the next record
 		}
 		//ok, they're on the same chrom and in range, and the strand is good. Do a merge.
-		if (recList != NULL) recList->push_back(nextRecord);
 		madeComposite = true;
 		int nextEnd = nextRecord->getEndPos();
 		if (nextEnd > currEnd) {
 			currEnd = nextEnd;
 		}
+		//without a list to hand them back in, the merged records aren't needed anymore.
+		if (recList != NULL) {
+			recList->push_back(nextRecord);
+		} else {
+			deleteRecord(nextRecord);
+		}
 		nextRecord = NULL;
 	}
 	if (madeComposite) {
 		Record *newKey = _recordMgr->allocateRecord();
 		(*newKey) = (*startRecord);
 		newKey->setEndPos(currEnd);
-		if (recList != NULL) recList->setKey(newKey);
+		if (recList != NULL) {
+			recList->setKey(newKey);
+		} else {
+			deleteRecord(startRecord);
+		}
 		_totalMergedRecordLength += currEnd - newKey->getStartPos();
 		return newKey;
 	} else {
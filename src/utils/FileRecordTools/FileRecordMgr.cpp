@@ -27,7 +27,9 @@ FileRecordMgr::FileRecordMgr(const QuickString &filename)
   _genomeFile(NULL),
   _ioBufSize(0),
   _noEnforceCoordSort(false),
-  _isGroupBy(false)
+  _isGroupBy(false),
+  _deferDeletes(false),
+  _numDeferredDeletes(0)
  {
 }
 
@@ -60,10 +62,13 @@ bool FileRecordMgr::open(bool inheader){
 	_recordType = _bufStreamMgr->getTypeChecker().getRecordType();
 
 	//HACK: If groupBy and not Bam, over-ride file type.
+	//(columnar files keep their reader, which serves any field.)
 	if (_isGroupBy && _fileType != FileRecordTypeChecker::BAM_FILE_TYPE) {
-		_bufStreamMgr->getTypeChecker().setFileType(FileRecordTypeChecker::SINGLE_LINE_DELIM_TEXT_FILE_TYPE);
+		if (_fileType != FileRecordTypeChecker::COLUMNAR_FILE_TYPE) {
+			_bufStreamMgr->getTypeChecker().setFileType(FileRecordTypeChecker::SINGLE_LINE_DELIM_TEXT_FILE_TYPE);
+			_fileType = FileRecordTypeChecker::SINGLE_LINE_DELIM_TEXT_FILE_TYPE;
+		}
 		_bufStreamMgr->getTypeChecker().setRecordType(FileRecordTypeChecker::NO_POS_PLUS_RECORD_TYPE);
-		_fileType = FileRecordTypeChecker::SINGLE_LINE_DELIM_TEXT_FILE_TYPE;
 		_recordType = FileRecordTypeChecker::NO_POS_PLUS_RECORD_TYPE;
 	}
 	if (_fileType == FileRecordTypeChecker::UNKNOWN_FILE_TYPE || _recordType == FileRecordTypeChecker::UNKNOWN_RECORD_TYPE) {
@@ -206,9 +211,23 @@ void FileRecordMgr::sortError(const Record *record, bool genomeFileError)
 
 
 void FileRecordMgr::deleteRecord(const Record *record) {
+	if (_deferDeletes) {
+		_deferredDeletes.push_back(record);
+		_numDeferredDeletes++;
+		return;
+	}
 	_recordMgr->deleteRecord(record);
 }
 
+void FileRecordMgr::releaseDeferredDeletes(size_t numDeletes) {
+	//the number deferred before the oldest one still held.
+	size_t numReleased = _numDeferredDeletes - _deferredDeletes.size();
+	for (; numReleased < numDeletes && !_deferredDeletes.empty(); numReleased++) {
+		_recordMgr->deleteRecord(_deferredDeletes.front());
+		_deferredDeletes.pop_front();
+	}
+}
+
 void FileRecordMgr::deleteRecord(RecordKeyVector *keyList) {
 	_recordMgr->deleteRecord(keyList->getKey());
 }
@@ -223,6 +242,10 @@ void FileRecordMgr::allocateFileReader(bool inheader)
 		static_cast<SingleLineDelimTextFileReader *>(_fileReader)->setInHeader(inheader);
 		break;
 
+	case FileRecordTypeChecker::COLUMNAR_FILE_TYPE:
+		_fileReader = new ColumnarFileReader(_bufStreamMgr->getTypeChecker().getNumFields());
+		break;
+
 	case FileRecordTypeChecker::BAM_FILE_TYPE:
 		_fileReader = new BamFileReader();
 		(static_cast<BamFileReader *>(_fileReader))->setUseTags(_useFullBamTags);
@@ -234,6 +257,17 @@ void FileRecordMgr::allocateFileReader(bool inheader)
 	_fileReader->setFileIdx(_fileIdx);
 }
 
+void FileRecordMgr::addNeededColumns(const vector<int> &columns) {
+	if (_fileType == FileRecordTypeChecker::BAM_FILE_TYPE) {
+		return; //BAM records have no fields to copy out.
+	}
+	vector<int> fieldNums(columns.size());
+	for (int i=0; i < (int)columns.size(); i++) {
+		fieldNums[i] = columns[i] -1;
+	}
+	static_cast<SingleLineDelimTextFileReader *>(_fileReader)->addNeededFields(fieldNums);
+}
+
 const BamTools::RefVector & FileRecordMgr::getBamReferences() {
 	// exta safety check to insure user checked the file type first.
 	if (_fileType != FileRecordTypeChecker::BAM_FILE_TYPE) {
@@ -11,6 +11,7 @@
 #include <string>
 #include "QuickString.h"
 #include <set>
+#include <deque>
 //#include "DualQueue.h"
 
 //include headers for all FileReader and derivative classes.
@@ -18,6 +19,7 @@
 #include "FileReader.h"
 #include "SingleLineDelimTextFileReader.h"
 #include "BamFileReader.h"
+#include "ColumnarFileReader.h"
 
 //record manager and all record classes
 #include "RecordMgr.h"
@@ -46,9 +48,20 @@ public:
 	//NOTE!! User MUST pass back the returned pointer to deleteRecord method for cleanup!
 	//Also Note! User must check for NULL returned, meaning we failed to get the next record.
 	virtual Record *getNextRecord(RecordKeyVector *keyList = NULL);
+	//Reads past the next entry without making a record of it, for tools
+	//that know they won't use it. False if there wasn't a record to skip.
+	bool skipRecord() { return _fileReader->isOpen() && _fileReader->readEntry(); }
 	void deleteRecord(const Record *);
 	virtual void deleteRecord(RecordKeyVector *keyList);
 
+	//While deletes are deferred, deleted records are only set aside, for
+	//other threads that may still be reading them. releaseDeferredDeletes
+	//then deletes those among the first numDeletes ever deferred that
+	//haven't been deleted yet.
+	void setDeferDeletes(bool val) { _deferDeletes = val; }
+	size_t getNumDeferredDeletes() const { return _numDeferredDeletes; }
+	void releaseDeferredDeletes(size_t numDeletes);
+
 
 
 	const QuickString &getFileName() const { return _filename;}
@@ -83,6 +96,11 @@ public:
 
 	int getNumFields() const { return _fileReader->getNumFields(); }
 
+	//Records normally copy out every field they have. Once a tool names
+	//the columns it will read from them, records keep the rest only as text,
+	//to be printed. Naming none at all is allowed. Call after opening.
+	void addNeededColumns(const vector<int> &columns);
+
 	//File statistics
 	unsigned long getTotalRecordLength() const { return _totalRecordLength; } //sum of length of all returned records
 	unsigned long getTotalMergedRecordLength() const { return _totalMergedRecordLength; } // sum of all merged intervals
@@ -143,6 +161,9 @@ protected:
 	int _ioBufSize;
 	bool _noEnforceCoordSort; //only true for GroupBy
 	bool _isGroupBy; //hopefully also only true for GroupBy
+	bool _deferDeletes;
+	deque<const Record *> _deferredDeletes;
+	size_t _numDeferredDeletes;
 
 	void allocateFileReader(bool inheader=false);
 	void testInputSortOrder(Record *record);
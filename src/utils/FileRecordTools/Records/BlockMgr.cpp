@@ -32,31 +32,48 @@ BlockMgr::~BlockMgr()
 
 void BlockMgr::getBlocks(RecordKeyVector &keyList, bool &mustDelete)
 {
-	switch (keyList.getKey()->getType()) {
+	const Record *keyRecord = keyList.getKey();
+	switch (keyRecord->getType()) {
 	case FileRecordTypeChecker::BED12_RECORD_TYPE:
-		getBlocksFromBed12(keyList, mustDelete);
-		break;
-
 	case FileRecordTypeChecker::BAM_RECORD_TYPE:
-		getBlocksFromBam(keyList, mustDelete);
+		findBlocks(keyRecord, _blocks);
+		for (int i=0; i < (int)_blocks.size(); i++) {
+			keyList.push_back(allocateAndAssignRecord(keyRecord, _blocks[i].first, _blocks[i].second));
+		}
+		mustDelete = !_blocks.empty();
 		break;
 
 	default:
-		keyList.push_back(keyList.getKey());
+		keyList.push_back(keyRecord);
 		mustDelete = false;
 		break;
 	}
 }
 
+void BlockMgr::findBlocks(const Record *record, blockListType &blocks)
+{
+	blocks.clear();
+	switch (record->getType()) {
+	case FileRecordTypeChecker::BED12_RECORD_TYPE:
+		findBlocksFromBed12(record, blocks);
+		break;
+
+	case FileRecordTypeChecker::BAM_RECORD_TYPE:
+		findBlocksFromBam(record, blocks);
+		break;
 
+	default:
+		blocks.push_back(blockType(record->getStartPos(), record->getEndPos()));
+		break;
+	}
+}
 
-void BlockMgr::getBlocksFromBed12(RecordKeyVector &keyList, bool &mustDelete)
+void BlockMgr::findBlocksFromBed12(const Record *record, blockListType &blocks)
 {
-	const Bed12Interval *keyRecord = static_cast<const Bed12Interval *>(keyList.getKey());
+	const Bed12Interval *keyRecord = static_cast<const Bed12Interval *>(record);
 	int blockCount = keyRecord->getBlockCount();
 
     if ( blockCount <= 0 ) {
-    	mustDelete = false;
     	return;
     }
 
@@ -71,16 +88,13 @@ void BlockMgr::getBlocksFromBed12(RecordKeyVector &keyList, bool &mustDelete)
     for (int i=0; i < blockCount; i++) {
     	int startPos = keyRecord->getStartPos() + str2chrPos(_blockStartTokens.getElem(i).c_str());
     	int endPos = startPos + str2chrPos(_blockSizeTokens.getElem(i).c_str());
-
-    	const Record *record = allocateAndAssignRecord(keyRecord, startPos, endPos);
-    	keyList.push_back(record);
+    	blocks.push_back(blockType(startPos, endPos));
     }
-    mustDelete = true;
 }
 
-void BlockMgr::getBlocksFromBam(RecordKeyVector &keyList, bool &mustDelete)
+void BlockMgr::findBlocksFromBam(const Record *record, blockListType &blocks)
 {
-	const BamRecord *keyRecord = static_cast<const BamRecord *>(keyList.getKey());
+	const BamRecord *keyRecord = static_cast<const BamRecord *>(record);
 	const vector<BamTools::CigarOp> &cigarData = keyRecord->getCigarData();
 	int currPos = keyRecord->getStartPos();
 	int  blockLength = 0;
@@ -104,7 +118,7 @@ void BlockMgr::getBlocksFromBam(RecordKeyVector &keyList, bool &mustDelete)
 					(opType == 'N' && !_breakOnSkipOps)) {
 				blockLength += opLen;
 			} else {
-				keyList.push_back(allocateAndAssignRecord(keyRecord, currPos, currPos + blockLength));
+				blocks.push_back(blockType(currPos, currPos + blockLength));
 				currPos += opLen + blockLength;
 				blockLength = 0;
 			}
@@ -116,9 +130,8 @@ void BlockMgr::getBlocksFromBam(RecordKeyVector &keyList, bool &mustDelete)
 		}
 	}
 	if (blockLength > 0) {
-		keyList.push_back(allocateAndAssignRecord(keyRecord, currPos, currPos + blockLength));
+		blocks.push_back(blockType(currPos, currPos + blockLength));
 	}
-	mustDelete = true;
 }
 
 Record *BlockMgr::allocateAndAssignRecord(const Record *keyRecord, int startPos, int endPos)
@@ -141,15 +154,6 @@ Record *BlockMgr::allocateAndAssignRecord(const Record *keyRecord, int startPos,
 	return record;
 }
 
-int BlockMgr::getTotalBlockLength(RecordKeyVector &keyList) {
-	int sum = 0;
-	for (RecordKeyVector::const_iterator_type iter = keyList.begin(); iter != keyList.end(); iter = keyList.next()) {
-		const Record *record = *iter;
-		sum += record->getEndPos() - record->getStartPos();
-	}
-	return sum;
-}
-
 void BlockMgr::deleteBlocks(RecordKeyVector &keyList)
 {
 	for (RecordKeyVector::const_iterator_type iter = keyList.begin(); iter != keyList.end(); iter = keyList.next()) {
@@ -160,50 +164,84 @@ void BlockMgr::deleteBlocks(RecordKeyVector &keyList)
 }
 
 
+int BlockMgr::getTotalBlockLength(const blockListType &blocks) {
+	int sum = 0;
+	for (int i=0; i < (int)blocks.size(); i++) {
+		sum += blocks[i].second - blocks[i].first;
+	}
+	return sum;
+}
+
+bool BlockMgr::blocksAreSortedAndDisjoint(const blockListType &blocks) {
+	for (int i=0; i < (int)blocks.size(); i++) {
+		if (blocks[i].second < blocks[i].first) return false;
+		if (i > 0 && blocks[i].first < blocks[i-1].second) return false;
+	}
+	return true;
+}
+
+void BlockMgr::addOverlap(const Record *keyRecord, const blockType &keyBlock, const blockType &hitBlock,
+		int &totalOverlap, RecordKeyVector *overlapList)
+{
+	int maxStart = max(keyBlock.first, hitBlock.first);
+	int minEnd = min(keyBlock.second, hitBlock.second);
+	int overlap  = minEnd - maxStart;
+	if (overlap > 0) {
+		totalOverlap += overlap;
+		if (overlapList != NULL) {
+			overlapList->push_back(allocateAndAssignRecord(keyRecord, maxStart, minEnd));
+		}
+	}
+}
+
 int BlockMgr::findBlockedOverlaps(RecordKeyVector &keyList, RecordKeyVector &hitList, 
-	                              RecordKeyVector &resultList, RecordKeyVector &overlapList)
+	                              RecordKeyVector &resultList, RecordKeyVector *overlapList)
 {
-	bool deleteKeyBlocks = false;
+	const Record *keyRecord = keyList.getKey();
 	if (keyList.empty()) {
-		//get all the blocks for the query record, put them in it's list.
-		getBlocks(keyList, deleteKeyBlocks);
+		//get all the blocks for the query record.
+		findBlocks(keyRecord, _keyBlocks);
+	} else {
+		_keyBlocks.clear();
+		for (RecordKeyVector::const_iterator_type iter = keyList.begin(); iter != keyList.end(); iter = keyList.next()) {
+			_keyBlocks.push_back(blockType((*iter)->getStartPos(), (*iter)->getEndPos()));
+		}
 	}
+	bool keyBlocksDisjoint = blocksAreSortedAndDisjoint(_keyBlocks);
 	_overlapBases.clear();
-	int keyBlocksSumLength = getTotalBlockLength(keyList);
+	int keyBlocksSumLength = getTotalBlockLength(_keyBlocks);
 
 	//Loop through every database record the query intersected with
 	RecordKeyVector::const_iterator_type hitListIter = hitList.begin();
 	for (; hitListIter != hitList.end(); hitListIter = hitList.next()) 
 	{
-		RecordKeyVector hitBlocks(*hitListIter);
-		bool deleteHitBlocks = false;
-		getBlocks(hitBlocks, deleteHitBlocks); //get all blocks for the hit record.
-		int hitBlockSumLength = getTotalBlockLength(hitBlocks); //get total length of the bocks for the hitRecord.
+		findBlocks(*hitListIter, _hitBlocks); //get all blocks for the hit record.
+		int hitBlockSumLength = getTotalBlockLength(_hitBlocks); //get total length of the bocks for the hitRecord.
 		int totalHitOverlap = 0;
-		bool hitHasOverlap = false;
-
-		//loop through every block of the database record.
-		RecordKeyVector::const_iterator_type hitBlockIter = hitBlocks.begin();
-		for (; hitBlockIter != hitBlocks.end(); hitBlockIter = hitBlocks.next()) 
-		{
-			//loop through every block of the query record.
-			RecordKeyVector::const_iterator_type keyListIter = keyList.begin();
-			for (; keyListIter != keyList.end(); keyListIter = keyList.next()) 
-			{
-				const Record *keyBlock = *keyListIter;
-				const Record *hitBlock = *hitBlockIter;
-
-				int maxStart = max(keyBlock->getStartPos(), hitBlock->getStartPos());
-				int minEnd = min(keyBlock->getEndPos(), hitBlock->getEndPos());
-				int overlap  = minEnd - maxStart;
-				if (overlap > 0) {
-					hitHasOverlap = true;
-					overlapList.push_back(allocateAndAssignRecord(keyList.getKey(), maxStart, minEnd));
-					totalHitOverlap += overlap;
+
+		if (keyBlocksDisjoint && blocksAreSortedAndDisjoint(_hitBlocks)) {
+			//walk both lists together. Of two blocks, the one that ends first
+			//can't overlap anything after the other, so move past it.
+			int keyIdx = 0;
+			int hitIdx = 0;
+			while (keyIdx < (int)_keyBlocks.size() && hitIdx < (int)_hitBlocks.size()) {
+				addOverlap(keyRecord, _keyBlocks[keyIdx], _hitBlocks[hitIdx], totalHitOverlap, overlapList);
+				if (_hitBlocks[hitIdx].second < _keyBlocks[keyIdx].second) {
+					hitIdx++;
+				} else {
+					keyIdx++;
+				}
+			}
+		} else {
+			//blocks that are out of order or overlap each other: compare every
+			//block of the database record with every block of the query record.
+			for (int hitIdx = 0; hitIdx < (int)_hitBlocks.size(); hitIdx++) {
+				for (int keyIdx = 0; keyIdx < (int)_keyBlocks.size(); keyIdx++) {
+					addOverlap(keyRecord, _keyBlocks[keyIdx], _hitBlocks[hitIdx], totalHitOverlap, overlapList);
 				}
 			}
 		}
-		if (hitHasOverlap) {
+		if (totalHitOverlap > 0) {
 			if ((float) totalHitOverlap / (float)keyBlocksSumLength >= _overlapFraction) {
 				if (_hasReciprocal &&
 						((float)totalHitOverlap / (float)hitBlockSumLength >= _overlapFraction)) {
@@ -215,14 +253,7 @@ int BlockMgr::findBlockedOverlaps(RecordKeyVector &keyList, RecordKeyVector &hit
 				}
 			}
 		}
-		if (deleteHitBlocks) {
-			deleteBlocks(hitBlocks);
-		}
 	}
-	if (deleteKeyBlocks) {
-		deleteBlocks(keyList);
-	}
-	resultList.setKey(keyList.getKey());
+	resultList.setKey(keyRecord);
 	return (int)resultList.size();
 }
-
@@ -28,16 +28,20 @@ public:
 	void getBlocks(RecordKeyVector &keyList, bool &mustDelete);
 	void deleteBlocks(RecordKeyVector &keyList);
 
-	// Get the sum of the lengths of all blocks for a record.
-	int getTotalBlockLength(RecordKeyVector &keyList);
+	//The start and end of each block of a record, in the order the record
+	//gives them, without making records of them.
+	typedef pair<int, int> blockType;
+	typedef vector<blockType> blockListType;
+	void findBlocks(const Record *record, blockListType &blocks);
 
 	// Determine which hits in the hitList intersect the hits in the keyList by comparing all blocks in each
 	// and checking that their total intersection meets any overlapFraction and reciprocal criteria compared to
 	// the total block lengths of the hitList and keyList. All hits that pass will be in the resultList.
+	// If an overlapList is given, it gets a record of each overlap between blocks.
 	// Return value is the number of hits in the result set.
 
 	int findBlockedOverlaps(RecordKeyVector &keyList, RecordKeyVector &hitList, 
-							RecordKeyVector &resultList, RecordKeyVector &overlapList);
+							RecordKeyVector &resultList, RecordKeyVector *overlapList = NULL);
 
 	//these are setting options for splitting BAM records
 	void setBreakOnDeletionOps(bool val) { _breakOnDeletionOps = val; }
@@ -57,11 +61,18 @@ private:
 	bool _hasReciprocal;
 	Tokenizer _blockSizeTokens;
 	Tokenizer _blockStartTokens;
+	blockListType _blocks;
+	blockListType _keyBlocks;
+	blockListType _hitBlocks;
 
 	// For now, all records will be split into Bed6 records.
 	const static FileRecordTypeChecker::RECORD_TYPE _blockRecordsType = FileRecordTypeChecker::BED6_RECORD_TYPE;
-	void getBlocksFromBed12(RecordKeyVector &keyList, bool &mustDelete);
-	void getBlocksFromBam(RecordKeyVector &keyList, bool &mustDelete);
+	void findBlocksFromBed12(const Record *record, blockListType &blocks);
+	void findBlocksFromBam(const Record *record, blockListType &blocks);
+	static int getTotalBlockLength(const blockListType &blocks);
+	static bool blocksAreSortedAndDisjoint(const blockListType &blocks);
+	void addOverlap(const Record *keyRecord, const blockType &keyBlock, const blockType &hitBlock,
+			int &totalOverlap, RecordKeyVector *overlapList);
 
 };
 
@@ -7,34 +7,49 @@ PlusFields::PlusFields()
 
 bool PlusFields::initFromFile(SingleLineDelimTextFileReader *fileReader)
 {
-	size_t numFields = fileReader->getNumFields() - _numOffsetFields;
+	//keep the text of all the fields, but only copy out the ones the tool
+	//said it will read.
+	_text.clear();
+	fileReader->appendFields(_numOffsetFields, _text, _fieldEnds);
 
-	if (size() != numFields) {
+	size_t numFields = size();
+	if (_fields.size() != numFields) {
 		_fields.resize(numFields);
 	}
-
+	_haveField.assign(numFields, false);
 	for (size_t i=0; i < numFields; i++) {
-		fileReader->getField(i + _numOffsetFields, _fields[i]);
+		if (fileReader->isFieldNeeded(i + _numOffsetFields)) {
+			copyField(i);
+		}
 	}
 	return true;
 }
 
 void PlusFields::clear() {
 	//don't destroy the strings if we don't have to. Just clear their memory.
-	for (int i=0; i < (int)_fields.size(); i++) {
-		_fields[i].clear();
-	}
+	_text.clear();
+	_fieldEnds.clear();
+	_haveField.clear();
 }
 
 const QuickString &PlusFields::getField(int fieldNum) const
 {
-	return _fields[fieldNum - _numOffsetFields - 1];
+	size_t idx = fieldNum - _numOffsetFields - 1;
+	if (!_haveField[idx]) {
+		copyField(idx);
+	}
+	return _fields[idx];
 }
 
 void PlusFields::printFields(QuickString &outBuf) const {
-	for (size_t i=0; i < size(); i++) {
+	if (size() > 0) {
 		outBuf.append('\t');
-		outBuf.append(_fields[i]);
+		outBuf.append(_text);
 	}
+}
 
+void PlusFields::copyField(size_t idx) const {
+	size_t startPos = idx == 0 ? 0 : _fieldEnds[idx - 1] +1;
+	_fields[idx].assign(_text.c_str() + startPos, _fieldEnds[idx] - startPos);
+	_haveField[idx] = true;
 }
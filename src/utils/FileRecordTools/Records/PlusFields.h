@@ -25,13 +25,21 @@ public:
 	virtual void clear();
 	virtual void printFields(QuickString &outBuf) const;
 
+	//Fields the tool didn't name as needed are copied out of the text on
+	//first use, so tools reading records from several threads must name
+	//every field they read.
 	virtual const QuickString &getField(int fieldNum) const;
-	virtual size_t size() const { return _fields.size(); }
+	virtual size_t size() const { return _fieldEnds.size(); }
 
 
 protected:
-	vector<QuickString> _fields;
+	QuickString _text; //all the fields, tab separated, as they're printed.
+	vector<int> _fieldEnds; //where each field ends in _text.
+	mutable vector<QuickString> _fields;
+	mutable vector<bool> _haveField; //whether _fields holds each field yet.
 	int _numOffsetFields; //could be 3 for BedPlus, but GFF has 8 or 9
+
+	void copyField(size_t idx) const;
 };
 
 
@@ -16,13 +16,23 @@ RecordList::RecordList() :
 {
 }
 
+RecordList::RecordList(const RecordList &other) :
+		_begin(NULL),
+		_currEnd(NULL),
+		_prevCursor(NULL),
+		_size(0),
+		_dontDelete(false)
+{
+	*this = other;
+}
+
 void RecordList::pop_front() {
 	if (empty()) {
 		return;
 	}
 	RecordListNode *killNode = _begin;
 	if (_begin->_next == NULL) { //this is the only item. List size is 1.
-		delete killNode;
+		_nodePool.deleteObj(killNode);
 		_begin = NULL;
 		_currEnd = NULL;
 		_prevCursor = NULL;
@@ -33,7 +43,7 @@ void RecordList::pop_front() {
 		_prevCursor = _begin->_next;
 	}
 	_begin = _begin->next();
-	delete killNode;
+	_nodePool.deleteObj(killNode);
 	_size--;
 }
 
@@ -67,14 +77,15 @@ RecordListNode *RecordList::deleteCurrent() {
 		//deleting last item in list
 		_currEnd = _prevCursor; //back up the current end.
 	}
-	delete killNode;
+	_nodePool.deleteObj(killNode);
 	_size--;
 
 	return returnNode;
 }
 
 void RecordList::push_back(const Record * &val) {
-	RecordListNode *newNode = new RecordListNode(val);
+	RecordListNode *newNode = _nodePool.newObj();
+	newNode->_val = val;
 	if (empty()) {
 		_begin = newNode;
 		_currEnd = newNode;
@@ -96,7 +107,7 @@ void RecordList::clear() {
 	RecordListNode *killNode = _begin;
 	while (killNode != NULL) {
 		RecordListNode *nextNode = killNode->_next;
-		delete killNode;
+		_nodePool.deleteObj(killNode);
 		killNode = nextNode;
 	}
 	_begin = NULL;
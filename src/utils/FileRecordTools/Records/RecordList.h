@@ -55,6 +55,7 @@ private:
 class RecordList {
 public:
 	RecordList();
+	RecordList(const RecordList &other);
 
 	~RecordList() { clear(); }
 
@@ -95,6 +96,10 @@ private:
 	//calling assignNoCopy, as our list will actually just be a pointer
 	//to another list.
 
+	//nodes come from here, rather than new and delete, as the sweep
+	//caches add and remove a node for nearly every record read.
+	FreeList<RecordListNode> _nodePool;
+
 
 
 	// The rest of this is just helper methods for sorting.
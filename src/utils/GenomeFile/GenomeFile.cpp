@@ -15,16 +15,20 @@
 
 GenomeFile::GenomeFile(const string &genomeFile) {
     _genomeFile = genomeFile;
+    _genomeLength = 0;
     loadGenomeFileIntoMap();
 }
 
 GenomeFile::GenomeFile(const RefVector &genome) {
+    _genomeLength = 0;
     for (size_t i = 0; i < genome.size(); ++i) {
         string chrom = genome[i].RefName;
         int length = genome[i].RefLength;
         
         _chromSizes[chrom] = length;
         _chromList.push_back(chrom);
+        _startOffsets.push_back(_genomeLength);
+        _genomeLength += length;
     }
 }
 
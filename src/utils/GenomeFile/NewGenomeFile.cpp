@@ -14,14 +14,16 @@
 #include "Tokenizer.h"
 
 NewGenomeFile::NewGenomeFile(const QuickString &genomeFilename)
-: _maxId(-1)
+: _maxId(-1),
+  _genomeLength(0)
 {
     _genomeFileName = genomeFilename;
     loadGenomeFileIntoMap();
 }
 
 NewGenomeFile::NewGenomeFile(const BamTools::RefVector &refVector)
-: _maxId(-1)
+: _maxId(-1),
+  _genomeLength(0)
 {
 	size_t i = 0;
     for (; i < refVector.size(); ++i) {
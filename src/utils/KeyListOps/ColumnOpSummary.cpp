@@ -0,0 +1,195 @@
+/*
+ * ColumnOpSummary.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ColumnOpSummary.h"
+#include <algorithm>
+#include "ParseTools.h" //to get the isNumeric function
+
+ColumnOpSummary::ColumnOpSummary(int column, KeyListOps::OP_TYPES op, const QuickString &nullVal,
+		const QuickString &delimStr, bool isBam)
+: _column(column),
+  _op(op),
+  _nullVal(nullVal),
+  _delimStr(delimStr),
+  _isBam(isBam),
+  _count(0),
+  _sum(0.0),
+  _extreme(0.0),
+  _freqMapBytes(0),
+  _nonNumErrFlag(false)
+{
+}
+
+void ColumnOpSummary::add(const QuickString &field)
+{
+	//the ops on text see BAM's empty fields as null, as KeyListOpsMethods does.
+	const QuickString &val = (_isBam && field.empty()) ? _nullVal : field;
+	double num = 0.0;
+
+	switch (_op) {
+	case KeyListOps::SUM:
+	case KeyListOps::MEAN:
+		_sum += toNum(field);
+		break;
+
+	case KeyListOps::STDDEV:
+	case KeyListOps::SAMPLE_STDDEV:
+		num = toNum(field);
+		_sum += num;
+		_nums.push_back(num);
+		break;
+
+	case KeyListOps::MEDIAN:
+	case KeyListOps::DISTINCT_SORT_NUM:
+	case KeyListOps::DISTINCT_SORT_NUM_DESC:
+		_nums.push_back(toNum(field));
+		break;
+
+	// as KeyListOpsMethods, start from the first value, and only replace
+	// it with a value that compares as smaller (or larger).
+	case KeyListOps::MIN:
+		num = toNum(field);
+		_extreme = (_count == 0 || num < _extreme) ? num : _extreme;
+		break;
+
+	case KeyListOps::MAX:
+		num = toNum(field);
+		_extreme = (_count == 0 || num > _extreme) ? num : _extreme;
+		break;
+
+	case KeyListOps::ABSMIN:
+		num = fabs(toNum(field));
+		_extreme = (_count == 0 || num < _extreme) ? num : _extreme;
+		break;
+
+	case KeyListOps::ABSMAX:
+		num = fabs(toNum(field));
+		_extreme = (_count == 0 || num > _extreme) ? num : _extreme;
+		break;
+
+	case KeyListOps::MODE:
+	case KeyListOps::ANTIMODE:
+	case KeyListOps::DISTINCT:
+	case KeyListOps::COUNT_DISTINCT:
+	case KeyListOps::DISTINCT_ONLY:
+	case KeyListOps::FREQ_ASC:
+	case KeyListOps::FREQ_DESC:
+	{
+		size_t numVals = _freqMap.size();
+		_freqMap[val]++;
+		if (_freqMap.size() != numVals) {
+			_freqMapBytes += FREQ_MAP_NODE_BYTES + val.size();
+		}
+		break;
+	}
+
+	case KeyListOps::COLLAPSE:
+		if (_count > 0) _str += _delimStr;
+		_str.append(val);
+		break;
+
+	case KeyListOps::CONCAT:
+		_str.append(val);
+		break;
+
+	case KeyListOps::FIRST:
+		if (_count == 0) _str = val;
+		break;
+
+	case KeyListOps::LAST:
+		_str = val;
+		break;
+
+	case KeyListOps::COUNT:
+	default:
+		break;
+	}
+	_count++;
+}
+
+double ColumnOpSummary::getSum() {
+	if (_count == 0) return NAN;
+	return _sum;
+}
+
+double ColumnOpSummary::getMean() {
+	if (_count == 0) return NAN;
+	return getSum() / (float)getCount();
+}
+
+double ColumnOpSummary::getStddev() {
+	if (_count == 0) return NAN;
+	return sqrt(KeyListOpsMethods::squareDiffSum(_nums, getMean()) / (float)getCount());
+}
+
+double ColumnOpSummary::getSampleStddev() {
+	if (_count == 0) return NAN;
+	return sqrt(KeyListOpsMethods::squareDiffSum(_nums, getMean()) / ((float)getCount() - 1.0));
+}
+
+double ColumnOpSummary::getMedian() {
+	if (_count == 0) return NAN;
+
+	sort(_nums.begin(), _nums.end(), less<double>());
+	return KeyListOpsMethods::median(_nums);
+}
+
+const QuickString &ColumnOpSummary::getMode() {
+	if (_count == 0) return _nullVal;
+	return KeyListOpsMethods::mode(_freqMap);
+}
+
+const QuickString &ColumnOpSummary::getAntiMode() {
+	if (_count == 0) return _nullVal;
+	return KeyListOpsMethods::antiMode(_freqMap);
+}
+
+uint32_t ColumnOpSummary::getCountDistinct() {
+	if (_count == 0) return 0;
+	return _freqMap.size();
+}
+
+const QuickString &ColumnOpSummary::getDistinct() {
+	if (_count == 0) return _nullVal;
+	KeyListOpsMethods::distinct(_freqMap, _delimStr, _retStr);
+	return _retStr;
+}
+
+const QuickString &ColumnOpSummary::getDistinctOnly() {
+	if (_count == 0) return _nullVal;
+	KeyListOpsMethods::distinctOnly(_freqMap, _delimStr, _retStr);
+	return _retStr;
+}
+
+const QuickString &ColumnOpSummary::getDistinctSortNum(bool asc) {
+	KeyListOpsMethods::distinctSortNum(_nums, asc, _delimStr, _retStr);
+	return _retStr;
+}
+
+const QuickString &ColumnOpSummary::getFreqDesc() {
+	if (_count == 0) return _nullVal;
+	KeyListOpsMethods::freqDesc(_freqMap, _delimStr, _retStr);
+	return _retStr;
+}
+
+const QuickString &ColumnOpSummary::getFreqAsc() {
+	if (_count == 0) return _nullVal;
+	KeyListOpsMethods::freqAsc(_freqMap, _delimStr, _retStr);
+	return _retStr;
+}
+
+double ColumnOpSummary::toNum(const QuickString &val) {
+	if (!isNumeric(val)) {
+		_nonNumErrFlag = true;
+		_errMsg = " ***** WARNING: Non numeric value ";
+		_errMsg.append(val);
+		_errMsg.append(" in ");
+		_errMsg.append(_column);
+		_errMsg.append(".");
+		return NAN;
+	}
+	return atof(val.c_str());
+}
@@ -0,0 +1,90 @@
+/*
+ * ColumnOpSummary.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef COLUMNOPSUMMARY_H_
+#define COLUMNOPSUMMARY_H_
+
+#include "KeyListOps.h"
+#include "KeyListOpsMethods.h"
+#include <cmath>
+
+using namespace std;
+
+//The running summary of one column operation over a group whose records
+//arrive one at a time, rather than together in a RecordKeyVector. It keeps
+//only what its operation needs, and its methods give the same answers as
+//those of KeyListOpsMethods would for the whole group.
+class ColumnOpSummary {
+public:
+	ColumnOpSummary(int column, KeyListOps::OP_TYPES op, const QuickString &nullVal,
+			const QuickString &delimStr, bool isBam);
+
+	void add(const Record *record) { add(record->getField(_column)); }
+	//adds the value of this summary's column, as taken from a record.
+	void add(const QuickString &field);
+
+	int getColumn() const { return _column; }
+	const QuickString &getNullValue() const { return _nullVal; }
+
+	//an estimate of the memory held for the values added so far.
+	size_t getMemUsed() const {
+		return _nums.capacity() * sizeof(double) + _freqMapBytes + _str.capacity();
+	}
+
+	//Each of these may be called once, after the last record is added.
+	double getSum();
+	double getMean();
+	double getStddev();
+	double getSampleStddev();
+	double getMedian();
+	const QuickString &getMode();
+	const QuickString &getAntiMode();
+	double getMin() { return getExtreme(); }
+	double getMax() { return getExtreme(); }
+	double getAbsMin() { return getExtreme(); }
+	double getAbsMax() { return getExtreme(); }
+	uint32_t getCount() { return _count; }
+	uint32_t getCountDistinct();
+	const QuickString &getDistinctOnly();
+	const QuickString &getDistinctSortNum(bool ascending = true);
+	const QuickString &getCollapse() { return _count == 0 ? _nullVal : _str; }
+	const QuickString &getConcat() { return _count == 0 ? _nullVal : _str; }
+	const QuickString &getDistinct();
+	const QuickString &getFreqDesc();
+	const QuickString &getFreqAsc();
+	const QuickString &getFirst() { return _count == 0 ? _nullVal : _str; }
+	const QuickString &getLast() { return _count == 0 ? _nullVal : _str; }
+
+	bool nonNumErrFlagSet() const { return _nonNumErrFlag; }
+	const QuickString &getErrMsg() const { return _errMsg; }
+
+private:
+	int _column;
+	KeyListOps::OP_TYPES _op;
+	QuickString _nullVal;
+	QuickString _delimStr;
+	bool _isBam;
+
+	uint32_t _count;
+	double _sum;
+	double _extreme; //the min, max, absmin or absmax so far.
+	vector<double> _nums;
+	KeyListOpsMethods::freqMapType _freqMap;
+	size_t _freqMapBytes;
+	QuickString _str; //collapse, concat, first or last.
+	QuickString _retStr;
+
+	bool _nonNumErrFlag;
+	QuickString _errMsg;
+
+	double getExtreme() { return _count == 0 ? NAN : _extreme; }
+	double toNum(const QuickString &val);
+
+	//roughly what a map node costs beyond its key's characters.
+	static const size_t FREQ_MAP_NODE_BYTES = 64;
+};
+
+#endif /* COLUMNOPSUMMARY_H_ */
@@ -6,12 +6,13 @@
  */
 #include "KeyListOps.h"
 #include "FileRecordMgr.h"
+#include "ColumnOpSummary.h"
 #include <cmath> //for isnan
-#include <sstream>
-#include <iomanip>
+#include "ParseTools.h"
 
 KeyListOps::KeyListOps():
-_dbFileType(FileRecordTypeChecker::UNKNOWN_FILE_TYPE)
+_dbFileType(FileRecordTypeChecker::UNKNOWN_FILE_TYPE),
+_holdWarning(false)
 {
 	_opCodes["sum"] = SUM;
 	_opCodes["mean"] = MEAN;
@@ -69,6 +70,21 @@ _dbFileType(FileRecordTypeChecker::UNKNOWN_FILE_TYPE)
 
 }
 
+KeyListOps::KeyListOps(const KeyListOps &other)
+: _dbFileType(other._dbFileType),
+  _operations(other._operations),
+  _columns(other._columns),
+  _opCodes(other._opCodes),
+  _isNumericOp(other._isNumericOp),
+  _colOps(other._colOps),
+  _precision(other._precision),
+  _holdWarning(other._holdWarning)
+{
+	_methods.setDelimStr(other._methods.getDelimStr());
+	_methods.setNullValue(other._methods.getNullValue());
+	_methods.setIsBam(_dbFileType == FileRecordTypeChecker::BAM_FILE_TYPE);
+}
+
 bool KeyListOps::isNumericOp(OP_TYPES op) const {
 	map<OP_TYPES, bool>::const_iterator iter = _isNumericOp.find(op);
 	return (iter == _isNumericOp.end() ? false : iter->second);
@@ -160,164 +176,178 @@ bool KeyListOps::isValidColumnOps(FileRecordMgr *dbFile) {
     return true;
 }
 
+void KeyListOps::getOpColumns(vector<int> &columns) const {
+	columns.clear();
+	for (size_t i = 0; i < _colOps.size(); i++) {
+		columns.push_back(_colOps[i].first);
+	}
+}
+
+template <class T>
+void KeyListOps::appendOpVal(T &methods, int col, OP_TYPES opCode)
+{
+	double val = 0.0;
+	switch (opCode) {
+	case SUM:
+		val = methods.getSum();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case MEAN:
+		val = methods.getMean();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case STDDEV:
+		val = methods.getStddev();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case SAMPLE_STDDEV:
+		val = methods.getSampleStddev();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case MEDIAN:
+		val = methods.getMedian();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case MODE:
+		_outVals.append(methods.getMode());
+		break;
+
+	case ANTIMODE:
+		_outVals.append(methods.getAntiMode());
+		break;
+
+	case MIN:
+		val = methods.getMin();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case MAX:
+		val = methods.getMax();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case ABSMIN:
+		val = methods.getAbsMin();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case ABSMAX:
+		val = methods.getAbsMax();
+		if (isnan(val)) {
+			_outVals.append(methods.getNullValue());
+		} else {
+			_outVals.append(format(val));
+		}
+		break;
+
+	case COUNT:
+		_outVals.append(methods.getCount());
+		break;
+
+	case DISTINCT:
+		_outVals.append(methods.getDistinct());
+		break;
+
+	case DISTINCT_SORT_NUM:
+		_outVals.append(methods.getDistinctSortNum());
+		break;
+
+	case DISTINCT_SORT_NUM_DESC:
+		_outVals.append(methods.getDistinctSortNum(false));
+		break;
+
+	case COUNT_DISTINCT:
+		_outVals.append(methods.getCountDistinct());
+		break;
+
+	case DISTINCT_ONLY:
+		_outVals.append(methods.getDistinctOnly());
+		break;
+
+	case COLLAPSE:
+		_outVals.append(methods.getCollapse());
+		break;
+
+	case CONCAT:
+		_outVals.append(methods.getConcat());
+		break;
+
+	case FREQ_ASC:
+		_outVals.append(methods.getFreqAsc());
+		break;
+
+	case FREQ_DESC:
+		_outVals.append(methods.getFreqDesc());
+		break;
+
+	case FIRST:
+		_outVals.append(methods.getFirst());
+		break;
+
+	case LAST:
+		_outVals.append(methods.getLast());
+		break;
+
+	case INVALID:
+	default:
+		// Any unrecognized operation should have been handled already in the context validation.
+		// It's thus unnecessary to handle it here, but throw an error to help us know if future
+		// refactoring or code changes accidentally bypass the validation phase.
+		cerr << "ERROR: Invalid operation given for column " << col << ". Exiting..." << endl;
+		break;
+	}
+}
+
 const QuickString & KeyListOps::getOpVals(RecordKeyVector &hits)
 {
 	//loop through all requested columns, and for each one, call the method needed
 	//for the operation specified.
 	_methods.setKeyList(&hits);
 	_outVals.clear();
-	double val = 0.0;
+	_heldWarning.clear();
 	for (int i=0; i < (int)_colOps.size(); i++) {
 		int col = _colOps[i].first;
 		OP_TYPES opCode = _colOps[i].second;
 
 		_methods.setColumn(col);
-		switch (opCode) {
-		case SUM:
-			val = _methods.getSum();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case MEAN:
-			val = _methods.getMean();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case STDDEV:
-			val = _methods.getStddev();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case SAMPLE_STDDEV:
-			val = _methods.getSampleStddev();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case MEDIAN:
-			val = _methods.getMedian();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case MODE:
-			_outVals.append(_methods.getMode());
-			break;
-
-		case ANTIMODE:
-			_outVals.append(_methods.getAntiMode());
-			break;
-
-		case MIN:
-			val = _methods.getMin();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case MAX:
-			val = _methods.getMax();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case ABSMIN:
-			val = _methods.getAbsMin();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case ABSMAX:
-			val = _methods.getAbsMax();
-			if (isnan(val)) {
-				_outVals.append(_methods.getNullValue());
-			} else {
-				_outVals.append(format(val));
-			}
-			break;
-
-		case COUNT:
-			_outVals.append(_methods.getCount());
-			break;
-
-		case DISTINCT:
-			_outVals.append(_methods.getDistinct());
-			break;
-
-		case DISTINCT_SORT_NUM:
-			_outVals.append(_methods.getDistinctSortNum());
-			break;
-
-		case DISTINCT_SORT_NUM_DESC:
-			_outVals.append(_methods.getDistinctSortNum(false));
-			break;
-
-		case COUNT_DISTINCT:
-			_outVals.append(_methods.getCountDistinct());
-			break;
-
-		case DISTINCT_ONLY:
-			_outVals.append(_methods.getDistinctOnly());
-			break;
-
-		case COLLAPSE:
-			_outVals.append(_methods.getCollapse());
-			break;
-
-		case CONCAT:
-			_outVals.append(_methods.getConcat());
-			break;
-
-		case FREQ_ASC:
-			_outVals.append(_methods.getFreqAsc());
-			break;
-
-		case FREQ_DESC:
-			_outVals.append(_methods.getFreqDesc());
-			break;
-
-		case FIRST:
-			_outVals.append(_methods.getFirst());
-			break;
-
-		case LAST:
-			_outVals.append(_methods.getLast());
-			break;
-
-		case INVALID:
-		default:
-			// Any unrecognized operation should have been handled already in the context validation.
-			// It's thus unnecessary to handle it here, but throw an error to help us know if future
-			// refactoring or code changes accidentally bypass the validation phase.
-			cerr << "ERROR: Invalid operation given for column " << col << ". Exiting..." << endl;
-			break;
-		}
+		appendOpVal(_methods, col, opCode);
 		//if this isn't the last column, add a tab.
 		if (i < (int)_colOps.size() -1) {
 			_outVals.append('\t');
@@ -325,18 +355,64 @@ const QuickString & KeyListOps::getOpVals(RecordKeyVector &hits)
 	}
 	if (_methods.nonNumErrFlagSet()) {
 		//asked for a numeric op on a column in which a non numeric value was found.
-		cerr << _methods.getErrMsg() << endl;
+		warnNonNumeric(_methods.getErrMsg());
 		_methods.resetNonNumErrFlag();
 	}
 	return _outVals;
 }
 
+void KeyListOps::initSummary(vector<ColumnOpSummary> &summary) const
+{
+	summary.clear();
+	bool isBam = (_dbFileType == FileRecordTypeChecker::BAM_FILE_TYPE);
+	for (int i=0; i < (int)_colOps.size(); i++) {
+		summary.push_back(ColumnOpSummary(_colOps[i].first, _colOps[i].second,
+				_methods.getNullValue(), _methods.getDelimStr(), isBam));
+	}
+}
+
+void KeyListOps::addToSummary(vector<ColumnOpSummary> &summary, const Record *record)
+{
+	for (int i=0; i < (int)summary.size(); i++) {
+		summary[i].add(record);
+	}
+}
+
+const QuickString &KeyListOps::getOpVals(vector<ColumnOpSummary> &summary)
+{
+	_outVals.clear();
+	_heldWarning.clear();
+	const ColumnOpSummary *nonNumSummary = NULL;
+	for (int i=0; i < (int)_colOps.size(); i++) {
+		appendOpVal(summary[i], _colOps[i].first, _colOps[i].second);
+		if (summary[i].nonNumErrFlagSet()) {
+			nonNumSummary = &summary[i];
+		}
+		//if this isn't the last column, add a tab.
+		if (i < (int)_colOps.size() -1) {
+			_outVals.append('\t');
+		}
+	}
+	if (nonNumSummary != NULL) {
+		//as above, report the last non numeric value found.
+		warnNonNumeric(nonNumSummary->getErrMsg());
+	}
+	return _outVals;
+}
+
+void KeyListOps::warnNonNumeric(const QuickString &errMsg)
+{
+	if (_holdWarning) {
+		_heldWarning = errMsg;
+	} else {
+		cerr << errMsg << endl;
+	}
+}
+
 const QuickString &KeyListOps::format(double val)
 {
-   std::stringstream strmBuf;
-   strmBuf << std::setprecision (_precision) << val;
-   _formatStr = strmBuf.str();
-   return _formatStr;
+	double2str(val, _formatStr, _precision);
+	return _formatStr;
 }
 
 void KeyListOpsHelp() {
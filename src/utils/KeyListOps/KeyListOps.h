@@ -12,6 +12,7 @@
 #include "FileRecordTypeChecker.h"
 
 class FileRecordMgr;
+class ColumnOpSummary;
 
 //print help message
 void KeyListOpsHelp();
@@ -20,6 +21,8 @@ class KeyListOps {
 public:
 
 	KeyListOps();
+	//copies the columns and operations, but not the current key list.
+	KeyListOps(const KeyListOps &other);
 
 	void setColumns(const QuickString &columns) { _columns = columns; }
 	void addColumns(const QuickString &newCols) {
@@ -49,8 +52,24 @@ public:
 	bool isValidColumnOps(FileRecordMgr *dbFile);
 
 	const QuickString &getOpVals(RecordKeyVector &hits);
+
+	//the columns the operations read. Call after isValidColumnOps.
+	void getOpColumns(vector<int> &columns) const;
+
+	//For groups whose records arrive one at a time: start a summary of each
+	//column operation, add each record to them, and then get the same values
+	//getOpVals would give for the whole group.
+	void initSummary(vector<ColumnOpSummary> &summary) const;
+	static void addToSummary(vector<ColumnOpSummary> &summary, const Record *record);
+	const QuickString &getOpVals(vector<ColumnOpSummary> &summary);
 	void setPrecision(int val) { _precision = val; }
 
+	//Normally the warning about a non numeric value is printed as soon as
+	//getOpVals finds one. When it's held, it's kept for the caller to
+	//print instead, until the next call to getOpVals.
+	void setHoldWarning(bool val) { _holdWarning = val; }
+	const QuickString &getHeldWarning() const { return _heldWarning; }
+
 private:
     void init();
     FileRecordTypeChecker::FILE_TYPE _dbFileType;
@@ -68,12 +87,19 @@ private:
 
     QuickString _formatStr;
     int _precision;
+    bool _holdWarning;
+    QuickString _heldWarning;
 
     static const int DEFAULT_PRECISION = 10;
     OP_TYPES getOpCode(const QuickString &operation) const;
     bool isNumericOp(OP_TYPES op) const;
     bool isNumericOp(const QuickString &op) const;
     const QuickString &format(double val);
+    void warnNonNumeric(const QuickString &errMsg);
+
+    //append the value of one column operation, from either a
+    //KeyListOpsMethods or a ColumnOpSummary.
+    template <class T> void appendOpVal(T &methods, int col, OP_TYPES opCode);
 
 };
 
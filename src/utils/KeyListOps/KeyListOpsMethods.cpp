@@ -59,44 +59,24 @@ double KeyListOpsMethods::getStddev() {
 	if (empty()) return NAN;
 
 	double avg = getMean();
-	double squareDiffSum = 0.0;
-	for (begin(); !end(); next()) {
-		double val = getColValNum();
-		double diff = val - avg;
-		squareDiffSum += diff * diff;
-	}
-	return sqrt(squareDiffSum / (float)getCount());
+	toArray(true);
+	return sqrt(squareDiffSum(_numArray, avg) / (float)getCount());
 }
 // return the standard deviation
 double KeyListOpsMethods::getSampleStddev() {
 	if (empty()) return NAN;
 
 	double avg = getMean();
-	double squareDiffSum = 0.0;
-	for (begin(); !end(); next()) {
-		double val = getColValNum();
-		double diff = val - avg;
-		squareDiffSum += diff * diff;
-	}
-	return sqrt(squareDiffSum / ((float)getCount() - 1.0));
+	toArray(true);
+	return sqrt(squareDiffSum(_numArray, avg) / ((float)getCount() - 1.0));
 }
 
 // return the median value in the vector
 double KeyListOpsMethods::getMedian() {
 	if (empty()) return NAN;
 
-	//get sorted vector. if even number of elems, return middle val.
-	//if odd, average of two.
 	toArray(true, ASC);
-	size_t count = getCount();
-	if (count % 2) {
-		//odd number of elements. Take middle one.
-		return _numArray[count/2];
-	} else {
-		//even numnber of elements. Take average of middle 2.
-		double sum = _numArray[count/2 -1] + _numArray[count/2];
-		return sum / 2.0;
-	}
+	return median(_numArray);
 }
 
 // return the most common value in the vector
@@ -104,17 +84,7 @@ const QuickString &KeyListOpsMethods::getMode() {
 	if (empty()) return _nullVal;
 
 	makeFreqMap();
-
-	//now pass through the freq map and keep track of which key has the highest occurance.
-	freqMapType::iterator maxIter = _freqMap.begin();
-	int maxVal = 0;
-	for (; _freqIter != _freqMap.end(); _freqIter++) {
-		if (_freqIter->second > maxVal) {
-			maxIter = _freqIter;
-			maxVal = _freqIter->second;
-		}
-	}
-	_retStr = maxIter->first;
+	_retStr = mode(_freqMap);
 	return _retStr;
 }
 // return the least common value in the vector
@@ -122,17 +92,7 @@ const QuickString &KeyListOpsMethods::getAntiMode() {
 	if (empty()) return _nullVal;
 
 	makeFreqMap();
-
-	//now pass through the freq map and keep track of which key has the highest occurance.
-	freqMapType::iterator minIter = _freqMap.begin();
-	int minVal = INT_MAX;
-	for (; _freqIter != _freqMap.end(); _freqIter++) {
-		if (_freqIter->second < minVal) {
-			minIter = _freqIter;
-			minVal = _freqIter->second;
-		}
-	}
-	_retStr =  minIter->first;
+	_retStr = antiMode(_freqMap);
 	return _retStr;
 }
 // return the minimum element of the vector
@@ -194,11 +154,7 @@ const QuickString &KeyListOpsMethods::getDistinct() {
 	if (empty()) return _nullVal;
 	// separated list of unique values. If something repeats, only report once.
 	makeFreqMap();
-	_retStr.clear();
-	for (; _freqIter != _freqMap.end(); _freqIter++) {
-		if (_freqIter != _freqMap.begin()) _retStr += _delimStr;
-		_retStr.append(_freqIter->first);
-	}
+	distinct(_freqMap, _delimStr, _retStr);
 	return _retStr;
 }
 
@@ -206,24 +162,13 @@ const QuickString &KeyListOpsMethods::getDistinctOnly() {
 	if (empty()) return _nullVal;
 	// separated list of unique values. If something repeats, don't report.
 	makeFreqMap();
-	_retStr.clear();
-	for (; _freqIter != _freqMap.end(); _freqIter++) {
-		if (_freqIter->second > 1) continue;
-		if (_freqIter != _freqMap.begin()) _retStr += _delimStr;
-		_retStr.append(_freqIter->first);
-	}
+	distinctOnly(_freqMap, _delimStr, _retStr);
 	return _retStr;
 }
 
 const QuickString &KeyListOpsMethods::getDistinctSortNum(bool asc) {
-	toArray(true, asc ? ASC : DESC);
-	vector<double>::iterator endIter = std::unique(_numArray.begin(), _numArray.end());
-
-	_retStr.clear();
-	for (vector<double>::iterator iter = _numArray.begin(); iter != endIter; iter++) {
-		if (iter != _numArray.begin()) _retStr += _delimStr;
-		_retStr.append(*iter);
-	}
+	toArray(true);
+	distinctSortNum(_numArray, asc, _delimStr, _retStr);
 	return  _retStr;
 
 }
@@ -271,19 +216,7 @@ const QuickString &KeyListOpsMethods::getFreqDesc() {
 
 	//for each uniq val, report # occurances, in desc order.
 	makeFreqMap();
-	//put freq map into multimap where key is the freq and val is the item. In other words, basically a reverse freq map.
-	histDescType hist;
-	for (; _freqIter != _freqMap.end(); _freqIter++) {
-		hist.insert(pair<int, QuickString>(_freqIter->second, _freqIter->first));
-	}
-	//now iterate through the reverse map we just made and output it's pairs in val:key format.
-	_retStr.clear();
-	for (histDescType::iterator histIter = hist.begin(); histIter != hist.end(); histIter++) {
-		if (histIter != hist.begin()) _retStr += _delimStr;
-		_retStr.append(histIter->second);
-		_retStr += ":";
-		_retStr.append(histIter->first);
-	}
+	freqDesc(_freqMap, _delimStr, _retStr);
 	return _retStr;
 }
 // return a histogram of values and their freqs. in asc. order of frequency
@@ -292,20 +225,7 @@ const QuickString &KeyListOpsMethods::getFreqAsc() {
 
 	//for each uniq val, report # occurances, in asc order.
 	makeFreqMap();
-	//put freq map into multimap where key is the freq and val is the item. In other words, basically a reverse freq map.
-	histAscType hist;
-	for (; _freqIter != _freqMap.end(); _freqIter++) {
-		hist.insert(pair<int, QuickString>(_freqIter->second, _freqIter->first));
-//		hist[*(_freqIter->second)] = _freqIter->first;
-	}
-	//now iterate through the reverse map we just made and output it's pairs in val:key format.
-	_retStr.clear();
-	for (histAscType::iterator histIter = hist.begin(); histIter != hist.end(); histIter++) {
-		if (histIter != hist.begin()) _retStr += _delimStr;
-		_retStr.append(histIter->second);
-		_retStr += ":";
-		_retStr.append(histIter->first);
-	}
+	freqAsc(_freqMap, _delimStr, _retStr);
 	return _retStr;
 }
 // return the first value in the list
@@ -395,5 +315,108 @@ void KeyListOpsMethods::makeFreqMap() {
 	for (begin(); !end(); next()) {
 		_freqMap[getColVal()]++;
 	}
-	_freqIter = _freqMap.begin();
+}
+
+double KeyListOpsMethods::squareDiffSum(const vector<double> &nums, double avg) {
+	double sum = 0.0;
+	for (size_t i = 0; i < nums.size(); i++) {
+		double diff = nums[i] - avg;
+		sum += diff * diff;
+	}
+	return sum;
+}
+
+double KeyListOpsMethods::median(const vector<double> &sortedNums) {
+	//if odd number of elems, return middle val.
+	//if even, average of middle two.
+	size_t count = sortedNums.size();
+	if (count % 2) {
+		return sortedNums[count/2];
+	} else {
+		double sum = sortedNums[count/2 -1] + sortedNums[count/2];
+		return sum / 2.0;
+	}
+}
+
+const QuickString &KeyListOpsMethods::mode(const freqMapType &freqMap) {
+	//pass through the freq map and keep track of which key has the highest occurance.
+	freqMapType::const_iterator maxIter = freqMap.begin();
+	int maxVal = 0;
+	for (freqMapType::const_iterator iter = freqMap.begin(); iter != freqMap.end(); iter++) {
+		if (iter->second > maxVal) {
+			maxIter = iter;
+			maxVal = iter->second;
+		}
+	}
+	return maxIter->first;
+}
+
+const QuickString &KeyListOpsMethods::antiMode(const freqMapType &freqMap) {
+	//pass through the freq map and keep track of which key has the lowest occurance.
+	freqMapType::const_iterator minIter = freqMap.begin();
+	int minVal = INT_MAX;
+	for (freqMapType::const_iterator iter = freqMap.begin(); iter != freqMap.end(); iter++) {
+		if (iter->second < minVal) {
+			minIter = iter;
+			minVal = iter->second;
+		}
+	}
+	return minIter->first;
+}
+
+void KeyListOpsMethods::distinct(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr) {
+	retStr.clear();
+	for (freqMapType::const_iterator iter = freqMap.begin(); iter != freqMap.end(); iter++) {
+		if (iter != freqMap.begin()) retStr += delimStr;
+		retStr.append(iter->first);
+	}
+}
+
+void KeyListOpsMethods::distinctOnly(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr) {
+	retStr.clear();
+	for (freqMapType::const_iterator iter = freqMap.begin(); iter != freqMap.end(); iter++) {
+		if (iter->second > 1) continue;
+		if (iter != freqMap.begin()) retStr += delimStr;
+		retStr.append(iter->first);
+	}
+}
+
+void KeyListOpsMethods::distinctSortNum(vector<double> &nums, bool asc, const QuickString &delimStr, QuickString &retStr) {
+	if (asc) {
+		sort(nums.begin(), nums.end(), less<double>());
+	} else {
+		sort(nums.begin(), nums.end(), greater<double>());
+	}
+	vector<double>::iterator endIter = std::unique(nums.begin(), nums.end());
+
+	retStr.clear();
+	for (vector<double>::iterator iter = nums.begin(); iter != endIter; iter++) {
+		if (iter != nums.begin()) retStr += delimStr;
+		retStr.append(*iter);
+	}
+}
+
+template <class histType>
+void KeyListOpsMethods::freqHist(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr) {
+	//put freq map into multimap where key is the freq and val is the item. In other words, basically a reverse freq map.
+	histType hist;
+	for (freqMapType::const_iterator iter = freqMap.begin(); iter != freqMap.end(); iter++) {
+		hist.insert(pair<int, QuickString>(iter->second, iter->first));
+	}
+	//now iterate through the reverse map we just made and output it's pairs in val:key format.
+	retStr.clear();
+	for (typename histType::iterator histIter = hist.begin(); histIter != hist.end(); histIter++) {
+		if (histIter != hist.begin()) retStr += delimStr;
+		retStr.append(histIter->second);
+		retStr += ":";
+		retStr.append(histIter->first);
+	}
+}
+
+void KeyListOpsMethods::freqDesc(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr) {
+	freqHist<histDescType>(freqMap, delimStr, retStr);
+}
+
+void KeyListOpsMethods::freqAsc(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr) {
+	freqHist<histAscType>(freqMap, delimStr, retStr);
 }
@@ -85,6 +85,20 @@ public:
     	_errMsg.clear();
     }
 
+	typedef map<QuickString, int> freqMapType;
+
+	// These finish the ops from values already gathered, either from the
+	// key list or, by ColumnOpSummary, one record at a time.
+	static double squareDiffSum(const vector<double> &nums, double avg);
+	static double median(const vector<double> &sortedNums);
+	static const QuickString &mode(const freqMapType &freqMap);
+	static const QuickString &antiMode(const freqMapType &freqMap);
+	static void distinct(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr);
+	static void distinctOnly(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr);
+	static void distinctSortNum(vector<double> &nums, bool ascending, const QuickString &delimStr, QuickString &retStr);
+	static void freqDesc(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr);
+	static void freqAsc(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr);
+
 private:
 	RecordKeyVector *_keyList;
 	int _column;
@@ -99,9 +113,7 @@ private:
 	vector<double> _numArray;
 	vector<QuickString> _qsArray;
 
-	typedef map<QuickString, int> freqMapType;
 	freqMapType _freqMap;
-	freqMapType::iterator _freqIter;
 
 	typedef enum { UNSORTED, ASC, DESC} SORT_TYPE;
 
@@ -111,6 +123,8 @@ private:
 
 	typedef multimap<int, QuickString, less<int> > histAscType;
 	typedef multimap<int, QuickString, greater<int> > histDescType;
+	template <class histType>
+	static void freqHist(const freqMapType &freqMap, const QuickString &delimStr, QuickString &retStr);
 	void init();
 	const QuickString &getColVal();
 	double getColValNum();
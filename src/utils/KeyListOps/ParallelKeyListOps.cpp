@@ -0,0 +1,194 @@
+/*
+ * ParallelKeyListOps.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ParallelKeyListOps.h"
+#include "FileRecordMgr.h"
+#include <iostream>
+#include <cstdlib>
+
+ParallelKeyListOps::ParallelKeyListOps(const KeyListOps &keyListOps, int numThreads, const vector<FileRecordMgr *> &files)
+: _files(files),
+  _workers(numThreads < 1 ? 1 : numThreads),
+  _batches(_workers.size() * BATCHES_PER_THREAD + 1),
+  _firstBatch(0),
+  _numSubmitted(0),
+  _numClaimed(0),
+  _finished(false),
+  _stopping(false),
+  _taking(false),
+  _takePos(0),
+  _doneOpVals(NULL),
+  _doneWarning(NULL)
+{
+	for (size_t i = 0; i < _batches.size(); i++) {
+		_batches[i] = new Batch();
+		_batches[i]->numGroups = 0;
+		_batches[i]->numRecords = 0;
+		_batches[i]->done = false;
+		_batches[i]->deleteMarks.resize(_files.size(), 0);
+	}
+	for (size_t i = 0; i < _files.size(); i++) {
+		_files[i]->setDeferDeletes(true);
+	}
+
+	pthread_mutex_init(&_lock, NULL);
+	pthread_cond_init(&_submittedCond, NULL);
+	pthread_cond_init(&_doneCond, NULL);
+	for (size_t i = 0; i < _workers.size(); i++) {
+		_workers[i].owner = this;
+		_workers[i].keyListOps = new KeyListOps(keyListOps);
+		_workers[i].keyListOps->setHoldWarning(true);
+		if (pthread_create(&_workers[i].thread, NULL, runThread, &_workers[i]) != 0) {
+			cerr << "Error: unable to start column operation thread. Exiting." << endl;
+			exit(1);
+		}
+	}
+}
+
+ParallelKeyListOps::~ParallelKeyListOps()
+{
+	pthread_mutex_lock(&_lock);
+	_stopping = true;
+	pthread_cond_broadcast(&_submittedCond);
+	pthread_mutex_unlock(&_lock);
+	for (size_t i = 0; i < _workers.size(); i++) {
+		pthread_join(_workers[i].thread, NULL);
+		delete _workers[i].keyListOps;
+	}
+	pthread_cond_destroy(&_doneCond);
+	pthread_cond_destroy(&_submittedCond);
+	pthread_mutex_destroy(&_lock);
+
+	for (size_t i = 0; i < _files.size(); i++) {
+		_files[i]->releaseDeferredDeletes(_files[i]->getNumDeferredDeletes());
+		_files[i]->setDeferDeletes(false);
+	}
+	for (size_t i = 0; i < _batches.size(); i++) {
+		for (size_t j = 0; j < _batches[i]->groups.size(); j++) {
+			delete _batches[i]->groups[j];
+		}
+		delete _batches[i];
+	}
+}
+
+void ParallelKeyListOps::add(RecordKeyVector &hits)
+{
+	Batch &batch = getBatch(_numSubmitted);
+	if (batch.numGroups == 0) {
+		//anything deleted before now isn't in this batch, or any after it.
+		for (size_t i = 0; i < _files.size(); i++) {
+			batch.deleteMarks[i] = _files[i]->getNumDeferredDeletes();
+		}
+	}
+	if (batch.numGroups == batch.groups.size()) {
+		batch.groups.push_back(new RecordKeyVector());
+		batch.opVals.push_back(QuickString());
+		batch.warnings.push_back(QuickString());
+	}
+	batch.numRecords += hits.size() + 1;
+	batch.groups[batch.numGroups]->swap(hits);
+	batch.numGroups++;
+
+	if (batch.numGroups == GROUPS_PER_BATCH || batch.numRecords >= RECORDS_PER_BATCH) {
+		submit();
+	}
+}
+
+void ParallelKeyListOps::finish()
+{
+	if (getBatch(_numSubmitted).numGroups > 0) {
+		submit();
+	}
+	_finished = true;
+}
+
+bool ParallelKeyListOps::nextDone(RecordKeyVector &hits)
+{
+	if (_taking && _takePos == getBatch(_firstBatch).numGroups) {
+		//the last group taken has been printed by now.
+		retireFirstBatch();
+	}
+	if (!_taking) {
+		//take back the oldest batch once there's no room to start another,
+		//or at the end.
+		size_t numPending = _numSubmitted - _firstBatch;
+		if (numPending == 0 || (numPending < _batches.size() && !_finished)) {
+			return false;
+		}
+		pthread_mutex_lock(&_lock);
+		while (!getBatch(_firstBatch).done) {
+			pthread_cond_wait(&_doneCond, &_lock);
+		}
+		pthread_mutex_unlock(&_lock);
+		_taking = true;
+		_takePos = 0;
+	}
+
+	Batch &batch = getBatch(_firstBatch);
+	batch.groups[_takePos]->swap(hits);
+	_doneOpVals = &batch.opVals[_takePos];
+	_doneWarning = &batch.warnings[_takePos];
+	_takePos++;
+	return true;
+}
+
+void ParallelKeyListOps::submit()
+{
+	pthread_mutex_lock(&_lock);
+	_numSubmitted++;
+	pthread_cond_signal(&_submittedCond);
+	pthread_mutex_unlock(&_lock);
+}
+
+void ParallelKeyListOps::retireFirstBatch()
+{
+	Batch &batch = getBatch(_firstBatch);
+	batch.numGroups = 0;
+	batch.numRecords = 0;
+	batch.done = false;
+	_firstBatch++;
+	_taking = false;
+
+	//every batch before the next one is done, so the records deleted
+	//before it was started are no longer needed.
+	const Batch &next = getBatch(_firstBatch);
+	bool nextStarted = (_firstBatch < _numSubmitted || next.numGroups > 0);
+	for (size_t i = 0; i < _files.size(); i++) {
+		_files[i]->releaseDeferredDeletes(nextStarted ? next.deleteMarks[i] : _files[i]->getNumDeferredDeletes());
+	}
+}
+
+void ParallelKeyListOps::run(KeyListOps *keyListOps)
+{
+	pthread_mutex_lock(&_lock);
+	while (true) {
+		while (_numClaimed == _numSubmitted && !_stopping) {
+			pthread_cond_wait(&_submittedCond, &_lock);
+		}
+		if (_numClaimed == _numSubmitted) break;
+
+		Batch &batch = getBatch(_numClaimed);
+		_numClaimed++;
+		pthread_mutex_unlock(&_lock);
+
+		for (size_t i = 0; i < batch.numGroups; i++) {
+			batch.opVals[i] = keyListOps->getOpVals(*batch.groups[i]);
+			batch.warnings[i] = keyListOps->getHeldWarning();
+		}
+
+		pthread_mutex_lock(&_lock);
+		batch.done = true;
+		pthread_cond_broadcast(&_doneCond);
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+void *ParallelKeyListOps::runThread(void *worker)
+{
+	Worker *self = static_cast<Worker *>(worker);
+	self->owner->run(self->keyListOps);
+	return NULL;
+}
@@ -0,0 +1,95 @@
+/*
+ * ParallelKeyListOps.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef PARALLELKEYLISTOPS_H_
+#define PARALLELKEYLISTOPS_H_
+
+#include "KeyListOps.h"
+#include <pthread.h>
+
+class FileRecordMgr;
+
+//Computes the column operations of groups on worker threads, while the
+//tool goes on reading the next groups. Groups are added in batches, and
+//taken back in the order they were added, each with its values, so the
+//tool prints them just as it would have without threads.
+//
+//Records a tool deletes through one of the files given are set aside until
+//no worker can still be reading them. Records it deletes itself must wait
+//until their group has been taken back.
+class ParallelKeyListOps {
+public:
+	ParallelKeyListOps(const KeyListOps &keyListOps, int numThreads, const vector<FileRecordMgr *> &files);
+
+	//Stops the threads, and deletes any records still set aside.
+	~ParallelKeyListOps();
+
+	//Hands over the group in hits, which gets an empty group in exchange.
+	void add(RecordKeyVector &hits);
+
+	//Call after the last group is added.
+	void finish();
+
+	//Swaps the next group to be printed into hits, which must be empty.
+	//Returns false when there's no group that must be printed yet. Keep
+	//calling it after each add, and after finish until it returns false.
+	bool nextDone(RecordKeyVector &hits);
+
+	//The values of the last group taken, and the warning about a non
+	//numeric value, if any, that computing them gave.
+	const QuickString &getOpVals() const { return *_doneOpVals; }
+	const QuickString &getWarning() const { return *_doneWarning; }
+
+private:
+	static const size_t GROUPS_PER_BATCH = 256;
+	static const size_t RECORDS_PER_BATCH = 16384;
+	static const int BATCHES_PER_THREAD = 2;
+
+	struct Batch {
+		vector<RecordKeyVector *> groups;
+		vector<QuickString> opVals;
+		vector<QuickString> warnings;
+		size_t numGroups;
+		size_t numRecords;
+		bool done;
+		//how many deletes each file had deferred when the batch was started.
+		vector<size_t> deleteMarks;
+	};
+	struct Worker {
+		ParallelKeyListOps *owner;
+		KeyListOps *keyListOps;
+		pthread_t thread;
+	};
+
+	vector<FileRecordMgr *> _files;
+	vector<Worker> _workers;
+
+	//the ring of batches. Batch numbers count up from the first ever
+	//added, and batch n is kept at _batches[n % _batches.size()].
+	vector<Batch *> _batches;
+	size_t _firstBatch; //the oldest batch not yet taken back.
+	size_t _numSubmitted; //the batch being filled has this number.
+	size_t _numClaimed;
+	bool _finished;
+	bool _stopping;
+
+	bool _taking; //whether the oldest batch is being taken back.
+	size_t _takePos;
+	const QuickString *_doneOpVals;
+	const QuickString *_doneWarning;
+
+	pthread_mutex_t _lock;
+	pthread_cond_t _submittedCond;
+	pthread_cond_t _doneCond;
+
+	Batch &getBatch(size_t batchNum) { return *_batches[batchNum % _batches.size()]; }
+	void submit();
+	void retireFirstBatch();
+	void run(KeyListOps *keyListOps);
+	static void *runThread(void *worker);
+};
+
+#endif /* PARALLELKEYLISTOPS_H_ */
@@ -0,0 +1,225 @@
+/*
+ * CloseIndex.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "CloseIndex.h"
+#include "FileRecordMgr.h"
+#include <algorithm>
+
+class CloseIndexStartLtFn {
+public:
+	bool operator()(const Record *rec1, const Record *rec2) const {
+		return rec1->getStartPos() < rec2->getStartPos();
+	}
+};
+
+class CloseIndexEndLtFn {
+public:
+	CloseIndexEndLtFn(const vector<const Record *> &recs) : _recs(recs) {}
+	bool operator()(int idx1, int idx2) const {
+		return _recs[idx1]->getEndPos() < _recs[idx2]->getEndPos();
+	}
+private:
+	const vector<const Record *> &_recs;
+};
+
+CloseIndexData::CloseIndexData(ContextClosest *context)
+: _context(context)
+{
+}
+
+CloseIndexData::~CloseIndexData()
+{
+}
+
+void CloseIndexData::loadDB()
+{
+	_dbs.resize(_context->getNumDatabaseFiles());
+	for (int i=0; i < _context->getNumDatabaseFiles(); i++) {
+		FileRecordMgr *databaseFile = _context->getDatabaseFile(i);
+		chromMapType &chroms = _dbs[i];
+		Chrom *currChrom = NULL;
+		QuickString currChromName;
+
+		Record *record = NULL;
+		while (!databaseFile->eof()) {
+			record = databaseFile->getNextRecord();
+			//In addition to NULL records, we also don't want to add unmapped reads.
+			if (record == NULL || record->isUnmapped()) {
+				continue;
+			}
+			_context->testNameConventions(record);
+			if (currChrom == NULL || record->getChrName() != currChromName) {
+				currChromName = record->getChrName();
+				currChrom = &chroms[currChromName];
+			}
+			currChrom->_recs.push_back(record);
+		}
+	}
+	for (int i=0; i < (int)_dbs.size(); i++) {
+		for (chromMapType::iterator iter = _dbs[i].begin(); iter != _dbs[i].end(); iter++) {
+			finishChrom(iter->second);
+		}
+	}
+}
+
+void CloseIndexData::finishChrom(Chrom &chrom)
+{
+	//stable, so that ties keep their file order.
+	stable_sort(chrom._recs.begin(), chrom._recs.end(), CloseIndexStartLtFn());
+
+	size_t numRecs = chrom._recs.size();
+	chrom._starts.resize(numRecs);
+	chrom._maxEnds.resize(numRecs);
+	chrom._byEnd.resize(numRecs);
+	chrom._ends.resize(numRecs);
+	int maxEnd = INT_MIN;
+	for (size_t i=0; i < numRecs; i++) {
+		chrom._starts[i] = chrom._recs[i]->getStartPos();
+		maxEnd = max(maxEnd, chrom._recs[i]->getEndPos());
+		chrom._maxEnds[i] = maxEnd;
+		chrom._byEnd[i] = (int)i;
+	}
+	sort(chrom._byEnd.begin(), chrom._byEnd.end(), CloseIndexEndLtFn(chrom._recs));
+	for (size_t i=0; i < numRecs; i++) {
+		chrom._ends[i] = chrom._recs[chrom._byEnd[i]]->getEndPos();
+	}
+}
+
+const CloseIndexData::Chrom *CloseIndexData::getChrom(int dbIdx, const QuickString &chrom) const
+{
+	chromMapType::const_iterator iter = _dbs[dbIdx].find(chrom);
+	if (iter == _dbs[dbIdx].end()) {
+		return NULL;
+	}
+	return &(iter->second);
+}
+
+
+CloseIndex::CloseIndex(ContextClosest *context, const CloseIndexData *data)
+: CloseSweep(context),
+  _data(data)
+{
+	_purgeCache = false;
+}
+
+CloseIndex::~CloseIndex()
+{
+}
+
+void CloseIndex::findClosest(const Record *query, RecordKeyVector &retList)
+{
+	_currQueryRec = query;
+	_qForward = _currQueryRec->getStrandVal() == Record::FORWARD;
+	_qReverse = _currQueryRec->getStrandVal() == Record::REVERSE;
+	_finalDistances.clear();
+
+	for (int i=0; i < _numDBs; i++) {
+		_minUpstreamRecs[i]->clear();
+		_minDownstreamRecs[i]->clear();
+		_overlapRecs[i]->clear();
+		//nothing is ever purged, so no record is before the purge point.
+		clearClosestEndPos(i);
+
+		const CloseIndexData::Chrom *chrom = query->isUnmapped() ? NULL : _data->getChrom(i, query->getChrName());
+		if (chrom == NULL) {
+			continue;
+		}
+		gatherCandidates(i, *chrom);
+
+		//now offer just the candidates again, in file order, so
+		//that ties are listed as CloseSweep would list them.
+		sort(_candidates.begin(), _candidates.end());
+		_minUpstreamRecs[i]->clear();
+		_minDownstreamRecs[i]->clear();
+		_overlapRecs[i]->clear();
+		bool stopScanning = false;
+		for (size_t j=0; j < _candidates.size(); j++) {
+			considerRecord(chrom->_recs[_candidates[j]], i, stopScanning);
+		}
+		finalizeSelections(i, retList);
+	}
+	checkMultiDbs(retList);
+}
+
+void CloseIndex::gatherCandidates(int dbIdx, const CloseIndexData::Chrom &chrom)
+{
+	_candidates.clear();
+	int qStart = _currQueryRec->getStartPos();
+	int qEnd = _currQueryRec->getEndPos();
+	int numRecs = (int)chrom._recs.size();
+
+	//records that may overlap the query. Everything before the first
+	//start past the query's end, back to where no earlier record
+	//reaches the query's start.
+	int firstRight = (int)(upper_bound(chrom._starts.begin(), chrom._starts.end(), qEnd) - chrom._starts.begin());
+	for (int i = firstRight -1; i >= 0 && chrom._maxEnds[i] >= qStart; i--) {
+		if (chrom._recs[i]->getEndPos() >= qStart) {
+			offerRecord(dbIdx, chrom, i);
+		}
+	}
+
+	//records to the left, nearest first, until no further one could be
+	//among the k closest.
+	int leftEnd = (int)(lower_bound(chrom._ends.begin(), chrom._ends.end(), qStart) - chrom._ends.begin());
+	for (int i = leftEnd -1; i >= 0; i--) {
+		int dist = qStart - chrom._ends[i] + 1;
+		if (sideClosed(true, dist, dbIdx)) break;
+		offerRecord(dbIdx, chrom, chrom._byEnd[i]);
+	}
+
+	//and likewise to the right.
+	for (int i = firstRight; i < numRecs; i++) {
+		int dist = chrom._starts[i] - qEnd + 1;
+		if (sideClosed(false, dist, dbIdx)) break;
+		offerRecord(dbIdx, chrom, i);
+	}
+}
+
+void CloseIndex::offerRecord(int dbIdx, const CloseIndexData::Chrom &chrom, int idx)
+{
+	bool stopScanning = false;
+	considerRecord(chrom._recs[idx], dbIdx, stopScanning);
+	_candidates.push_back(idx);
+}
+
+//true if no record on that side at least dist away can be among the
+//closest, because every list it could go in already holds k closer ones.
+bool CloseIndex::sideClosed(bool left, int dist, int dbIdx) const
+{
+	//which strands of database records aren't ignored outright.
+	bool forwardOk = true;
+	bool otherOk = true;
+	if (_sameStrand) {
+		forwardOk = _qForward;
+		otherOk = _qReverse;
+	} else if (_diffStrand) {
+		forwardOk = _qReverse;
+		otherOk = _qForward;
+	}
+
+	//hits on the left are upstream, unless -D flips them, just as in considerRecord.
+	bool signDist = _context->signDistance();
+	bool flipForward = signDist && ((_aDist && _qReverse) || _bDist);
+	bool flipOther = signDist && (_aDist && _qReverse);
+	bool canUp = false;
+	bool canDown = false;
+	if (forwardOk) {
+		(flipForward == left ? canDown : canUp) = true;
+	}
+	if (otherOk) {
+		(flipOther == left ? canDown : canUp) = true;
+	}
+	canUp = canUp && !_ignoreUpstream;
+	canDown = canDown && !_ignoreDownstream;
+
+	return (!canUp || listClosed(_minUpstreamRecs[dbIdx], dist)) &&
+			(!canDown || listClosed(_minDownstreamRecs[dbIdx], dist));
+}
+
+bool CloseIndex::listClosed(const RecDistList *list, int dist) const
+{
+	return list->uniqueSize() == _kClosest && dist > list->getMaxDist();
+}
@@ -0,0 +1,63 @@
+/*
+ * CloseIndex.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef CLOSEINDEX_H_
+#define CLOSEINDEX_H_
+
+#include "CloseSweep.h"
+
+//closest for unsorted input. The database files are loaded into
+//per-chromosome arrays, and each query is answered with binary searches,
+//so neither file needs to be sorted, and queries can be answered in any
+//order, or in parallel.
+class CloseIndexData {
+public:
+	CloseIndexData(ContextClosest *context);
+	~CloseIndexData();
+	void loadDB();
+
+	//One database's records on one chrom, sorted by start. Ties keep
+	//their file order, so on sorted input, ties come out as in CloseSweep.
+	class Chrom {
+	public:
+		vector<const Record *> _recs;
+		vector<int> _starts;
+		vector<int> _maxEnds; //max end of _recs[0..i].
+		vector<int> _byEnd; //indexes into _recs, sorted by end,
+		vector<int> _ends;  //and their ends.
+	};
+	typedef map<QuickString, Chrom> chromMapType;
+	const Chrom *getChrom(int dbIdx, const QuickString &chrom) const;
+
+private:
+	ContextClosest *_context;
+	vector<chromMapType> _dbs;
+	void finishChrom(Chrom &chrom);
+};
+
+//Finds the closest records for one query at a time. The selection
+//itself is CloseSweep's. Only how the candidates are found differs,
+//so -k, -D, the tie modes and -mdb all behave the same. Each thread
+//needs its own CloseIndex, but they can share one CloseIndexData.
+class CloseIndex : public CloseSweep {
+public:
+	CloseIndex(ContextClosest *context, const CloseIndexData *data);
+	~CloseIndex();
+
+	//the hits go in retList, and their distances in getDistances().
+	void findClosest(const Record *query, RecordKeyVector &retList);
+
+private:
+	const CloseIndexData *_data;
+	vector<int> _candidates;
+
+	void gatherCandidates(int dbIdx, const CloseIndexData::Chrom &chrom);
+	void offerRecord(int dbIdx, const CloseIndexData::Chrom &chrom, int idx);
+	bool sideClosed(bool left, int dist, int dbIdx) const;
+	bool listClosed(const RecDistList *list, int dist) const;
+};
+
+#endif /* CLOSEINDEX_H_ */
@@ -10,185 +10,113 @@
 
 RecDistList::RecDistList(int maxSize)
 :  _kVal(maxSize),
-   _empty(true),
-   _currNumIdxs(0),
-   _totalRecs(0)
-
-    {
-
-	_allRecs.resize(_kVal);
-	for (int i=0; i < _kVal; i++) {
-		_allRecs[i] = new elemsType();
-	}
-	_distIndex = new indexType[_kVal];
-
-	clear();
+   _totalRecs(0),
+   _isGrouped(false)
+{
+	_dists.reserve(_kVal);
 }
 
 RecDistList::~RecDistList() {
-	for (int i=0; i < _kVal; i++) {
-		delete _allRecs[i];
-	}
-	delete _distIndex;
-	_distIndex = NULL;
-
 }
 
 void RecDistList::clear() {
-	for (int i=0; i < _kVal; i++) {
-		_allRecs[i]->clear();
-		_allRecs[i]->reserve(16);
-	}
-	for (int i=0; i < _kVal; i++) {
-		_distIndex[i].first = -1;
-		_distIndex[i].second = -1;
-	}
-	_currNumIdxs = 0;
-	_empty = true;
+	_dists.clear();
+	_elems.clear();
 	_totalRecs = 0;
+	_isGrouped = false;
 }
 
 bool RecDistList::addRec(int dist, const Record *record, chromDirType chromDir) {
-	int newPos = 0;
-	bool mustAppend = false;
-	int useElemIdx = 0;
-
-	if (dist > getMaxDist()) {
-		//dist is bigger than any currently contained.
-		if (_currNumIdxs == _kVal) {
-			//already full with smaller distances
-			return false;
-		}
-		mustAppend = true;
-		useElemIdx = _currNumIdxs;
-		newPos = _currNumIdxs;
-	}
-	if (find(dist, newPos)) {
-		_allRecs[_distIndex[newPos].second]->push_back(elemPairType(chromDir, record));
-		_totalRecs++;
-		return true;
+	if (uniqueSize() == _kVal && dist > getMaxDist()) {
+		//already full with smaller distances
+		return false;
 	}
-	if (!mustAppend) {
-		//smaller than maxDist, and doesn't currently exist. must insert
-		//newPos now is the insertion point.
-		int startShiftPos = 0;
-		if (_currNumIdxs == _kVal) {
-			//already full. must remove oldest max.
-			//determine which vector it was using
-			//so we can re-use it.
-			startShiftPos = _kVal-1;
-			useElemIdx = _distIndex[startShiftPos].second;
-		} else {
-			//can add a new element
-			startShiftPos = _currNumIdxs;
-			useElemIdx = _currNumIdxs;
-			_currNumIdxs++;
-		}
-		for (int i=startShiftPos; i > newPos; i--) {
-			_distIndex[i].first = _distIndex[i-1].first;
-			_distIndex[i].second = _distIndex[i-1].second;
+	int pos = 0;
+	//most records land at or past the current max, so check there
+	//before searching.
+	if (empty() || dist > getMaxDist()) {
+		pos = uniqueSize();
+		_dists.push_back(distInfoType(dist));
+	} else if (dist == getMaxDist()) {
+		pos = uniqueSize() -1;
+	} else if (!find(dist, pos)) {
+		if (uniqueSize() == _kVal) {
+			//already full. The records at the old max are dropped.
+			_totalRecs -= _dists.back()._count;
+			_dists.pop_back();
 		}
-	} else {
-		_currNumIdxs++;
+		_dists.insert(_dists.begin() + pos, distInfoType(dist));
 	}
-	_allRecs[useElemIdx]->clear();
-	_allRecs[useElemIdx]->reserve(16);
-	_allRecs[useElemIdx]->push_back(elemPairType(chromDir, record));
-
-	_distIndex[newPos].first = dist;
-	_distIndex[newPos].second = useElemIdx;
-	_empty = false;
+	distInfoType &info = _dists[pos];
+	info._count++;
 	_totalRecs++;
+	_elems.push_back(distElemType(dist, elemPairType(chromDir, record)));
+	_isGrouped = false;
+	if (_elems.size() > 2 * _totalRecs + 64) {
+		compact();
+	}
 	return true;
 }
 
-//bool RecDistList::addRec(int dist, const Record *record, chromDirType chromDir) {
-//	//if unique size is >= maxRecNum, that means the collection is
-//	//full. In that case, if the new rec has greater distance than
-//	// any in the collection, ignore it. If the distance isn't
-//	// greater, add it, removing the previously greater one
-//	// if need be.
-//	// If the collection isn't full, just the new.
-//
-//	if (uniqueSize() < _kVal || exists(dist)) {
-//		insert(dist, record, chromDir);
-//		return true;
-//	} else {
-//		//find previous greatest distance
-//		revIterType rIter = _recs.rbegin();
-//		int currMaxDist = rIter->first;
-//		if (dist > currMaxDist) {
-//			return false;
-//		}
-//		//Now we know dist is less than currMax.
-//		//new dist is smaller. Erase old max.
-//		delete rIter->second;
-//
-//		//apparently you can't erase a reverse iterator, so we'll
-//		//make a normal one pointing at the end, then back it  up.
-//		iterType delIter = _recs.end();
-//		delIter--;
-//		_recs.erase(delIter);
-//		insert(dist, record, chromDir);
-//		return true;
-//	}
-//
-//}
-
-//void RecDistList::insert(int dist, const Record *record, chromDirType chromDir) {
-//	if ()
-//	elemsType *elems = NULL;
-//	distRecsType::iterator iter = _recs.find(dist);
-//	if (iter == _recs.end()) {
-//		//dist didn't exist before. Add it by
-//		// creating new elems container, then
-//		//putting this in the map.
-//		elems = new elemsType();
-//		_recs[dist] = elems;
-//	} else {
-//		elems = iter->second;
-//	}
-//	elems->push_back(pair<chromDirType, const Record *>(chromDir, record));
-//	_totalRecs++;
-//}
-
 //if true, pos will be the idx the distance is at.
 //if false, pos will be the idx to insert at.
 bool RecDistList::find(int dist, int &pos) const {
-	int lbound=0, ubound=_currNumIdxs-1, currVal =0;
-	pos = 0;
-	while(lbound <= ubound)
-	{
-		pos = (lbound + ubound) / 2;
-		currVal = _distIndex[pos].first;
-		if (currVal == dist) {
-			return true;
-		}
-		if (dist > currVal) {
-			lbound = pos + 1;
+	int lbound = 0, ubound = uniqueSize();
+	while (lbound < ubound) {
+		int mid = (lbound + ubound) / 2;
+		if (_dists[mid]._dist < dist) {
+			lbound = mid + 1;
 		} else {
-			ubound = pos -1;
+			ubound = mid;
 		}
 	}
-	pos = (ubound == -1 ) ? 0 : (lbound == _currNumIdxs ? _currNumIdxs : lbound);
-	return false;
+	pos = lbound;
+	return pos < uniqueSize() && _dists[pos]._dist == dist;
 }
 
-int RecDistList::getMaxLeftEndPos() const {
-
-	if (_empty) return -1;
-
-	int maxDist =_distIndex[_currNumIdxs-1].first;
-
-  const elemsType *elems = _allRecs[_distIndex[_currNumIdxs-1].second];
-	for (int i=0; i < (int)elems->size(); i++) {
-    const elemPairType & elem = (*elems)[i];
-		if (elem.first == LEFT) {
-			return maxDist;
+void RecDistList::compact() {
+	//once full, distances only ever leave from the top, so the
+	//records still wanted are exactly those within the max.
+	int maxDist = getMaxDist();
+	size_t numKept = 0;
+	for (size_t i=0; i < _elems.size(); i++) {
+		if (_elems[i]._dist <= maxDist) {
+			_elems[numKept++] = _elems[i];
 		}
 	}
-	return -1;
+	_elems.erase(_elems.begin() + numKept, _elems.end());
+}
+
+void RecDistList::group() const {
+	if (_isGrouped) return;
+	//a counting sort on the distance's index, which keeps each
+	//distance's records in the order they were added.
+	_groupStarts.resize(_dists.size() + 1);
+	size_t start = 0;
+	for (size_t i=0; i < _dists.size(); i++) {
+		_groupStarts[i] = start;
+		start += _dists[i]._count;
+	}
+	_groupStarts[_dists.size()] = start;
+	_grouped.resize(start);
+	int maxDist = getMaxDist();
+	for (size_t i=0; i < _elems.size(); i++) {
+		if (_elems[i]._dist > maxDist) continue;
+		int pos = 0;
+		find(_elems[i]._dist, pos);
+		_grouped[_groupStarts[pos]++] = _elems[i]._elem;
+	}
+	//the starts were advanced past each group. Put them back.
+	for (size_t i = _dists.size(); i > 0; i--) {
+		_groupStarts[i] = _groupStarts[i-1];
+	}
+	_groupStarts[0] = 0;
+	_isGrouped = true;
+}
 
+const RecDistList::elemPairType &RecDistList::currElem(constIterType iter, size_t idx) const {
+	group();
+	return _grouped[_groupStarts[iter] + idx];
 }
 
 
@@ -196,6 +124,7 @@ CloseSweep::CloseSweep(ContextClosest *context)
 :	NewChromSweep(context),
  	_context(context),
  	_kClosest(_context->getNumClosestHitsWanted()),
+	_purgeCache(true),
 	_sameStrand(false),
 	_diffStrand(false),
 
@@ -222,6 +151,7 @@ CloseSweep::CloseSweep(ContextClosest *context)
 	_overlapRecs.resize(_numDBs, NULL);
 	_maxPrevLeftClosestEndPos.resize(_numDBs, 0);
 	_maxPrevLeftClosestEndPosReverse.resize(_numDBs, 0);
+	_leftRecs.resize(_numDBs);
 
 	for (int i=0; i < _numDBs; i++) {
 		_minUpstreamRecs[i] = new RecDistList(_kClosest);
@@ -229,21 +159,6 @@ CloseSweep::CloseSweep(ContextClosest *context)
 		_overlapRecs[i] = new RecDistList(_kClosest);
 	}
 
-}
-
-CloseSweep::~CloseSweep(void) {
-	for (int i=0; i < _numDBs; i++) {
-		delete _minUpstreamRecs[i];
-		delete _minDownstreamRecs[i];
-		delete _overlapRecs[i];
-	}
-}
-
-bool CloseSweep::init() {
-
-    bool retVal =  NewChromSweep::init();
-    _runToQueryEnd = true;
-
 	// Some abbreviations to make the code less miserable.
 	_sameStrand = _context->getSameStrand();
 	_diffStrand = _context->getDiffStrand();
@@ -259,7 +174,20 @@ bool CloseSweep::init() {
 	_firstTie = _tieMode == ContextClosest::FIRST_TIE;
 	_lastTie = _tieMode == ContextClosest::LAST_TIE;
 	_allTies = _tieMode == ContextClosest::ALL_TIES;
+}
 
+CloseSweep::~CloseSweep(void) {
+	for (int i=0; i < _numDBs; i++) {
+		delete _minUpstreamRecs[i];
+		delete _minDownstreamRecs[i];
+		delete _overlapRecs[i];
+	}
+}
+
+bool CloseSweep::init() {
+
+    bool retVal =  NewChromSweep::init();
+    _runToQueryEnd = true;
 
     return retVal;
  }
@@ -398,7 +326,7 @@ void CloseSweep::finalizeSelections(int dbIdx, RecordKeyVector &retList) {
 		//add upstream recs until all are used or K hits taken.
 		while (upIter != upRecs->end() && totalHitsUsed < _kClosest) {
 			upDist = upRecs->currDist(upIter);
-			totalHitsUsed += addRecsToRetList(upRecs->allElems(upIter), 0 - upDist, retList);
+			totalHitsUsed += addRecsToRetList(upRecs, upIter, 0 - upDist, retList);
 			upIter++;
 		}
 	}
@@ -407,7 +335,7 @@ void CloseSweep::finalizeSelections(int dbIdx, RecordKeyVector &retList) {
 	if (_context->forceDownstream()) {
 		while (downIter != downRecs->end() && totalHitsUsed < _kClosest) {
 			downDist = downRecs->currDist(downIter);
-			totalHitsUsed += addRecsToRetList(downRecs->allElems(downIter), downDist, retList);
+			totalHitsUsed += addRecsToRetList(downRecs, downIter, downDist, retList);
 			downIter++;
 		}
 	}
@@ -416,7 +344,7 @@ void CloseSweep::finalizeSelections(int dbIdx, RecordKeyVector &retList) {
 	//start with the overlaps, which will all have distance zero.
 	if (totalHitsUsed < _kClosest && !overlaps->empty()) {
 		//there are overlaps.
-		totalHitsUsed += addRecsToRetList(overlaps->allElems(overlaps->begin()), 0, retList);
+		totalHitsUsed += addRecsToRetList(overlaps, overlaps->begin(), 0, retList);
 	}
 
 	//now check the upstream and downstream recs, starting with the beginning of each,
@@ -441,12 +369,12 @@ void CloseSweep::finalizeSelections(int dbIdx, RecordKeyVector &retList) {
 		bool usedUp = false;
 		bool usedDown = false;
 		if (upDist < downDist || (tie && !_lastTie)) {
-			totalHitsUsed += addRecsToRetList(upRecs->allElems(upIter), 0 - upDist, retList);
+			totalHitsUsed += addRecsToRetList(upRecs, upIter, 0 - upDist, retList);
 			upIter++;
 			usedUp = true;
 		}
 		if (downDist < upDist || (tie && !_firstTie)) {
-			totalHitsUsed += addRecsToRetList(downRecs->allElems(downIter), downDist, retList);
+			totalHitsUsed += addRecsToRetList(downRecs, downIter, downDist, retList);
 			downIter++;
 			usedDown = true;
 		}
@@ -466,24 +394,24 @@ void CloseSweep::finalizeSelections(int dbIdx, RecordKeyVector &retList) {
 
 
 
-int CloseSweep::addRecsToRetList(const RecDistList::elemsType *recs, int currDist, RecordKeyVector &retList) {
+int CloseSweep::addRecsToRetList(const RecDistList *recs, RecDistList::constIterType iter, int currDist, RecordKeyVector &retList) {
 
 	int hitsUsed = 0;
-	int numRecs = (int)recs->size(); //just to clean the code some.
+	int numRecs = (int)recs->currNumElems(iter); //just to clean the code some.
 
 
 	if (_firstTie) {
-		addSingleRec(recs->at(0).second, currDist, hitsUsed, retList);
+		addSingleRec(recs->currElem(iter, 0).second, currDist, hitsUsed, retList);
 		return 1;
 
 	} else if (_lastTie) {
-		addSingleRec(recs->at(numRecs-1).second, currDist, hitsUsed, retList);
+		addSingleRec(recs->currElem(iter, numRecs-1).second, currDist, hitsUsed, retList);
 		return 1;
 
 	} else { //tieMode == ALL_TIES
 
 		for (int i=0; i < numRecs; i++) {
-			addSingleRec(recs->at(i).second, currDist, hitsUsed, retList);
+			addSingleRec(recs->currElem(iter, i).second, currDist, hitsUsed, retList);
 		}
 		return numRecs;
 	}
@@ -654,6 +582,7 @@ void CloseSweep::setLeftClosestEndPos(int dbIdx)
 
   //no records found to left of query,
   //can't set purge point, except for some special cases.
+  if (!_purgeCache) return;
   purgeDirectionType purgeDir = purgePointException(dbIdx);
   if (purgeDir == BOTH || purgeDir == FORWARD_ONLY) {
     _maxPrevLeftClosestEndPos[dbIdx] = max(_currQueryRec->getStartPos(), _maxPrevLeftClosestEndPos[dbIdx]);
@@ -661,18 +590,16 @@ void CloseSweep::setLeftClosestEndPos(int dbIdx)
   if (purgeDir == BOTH || purgeDir == REVERSE_ONLY) {
     _maxPrevLeftClosestEndPosReverse[dbIdx] = max(_currQueryRec->getStartPos(), _maxPrevLeftClosestEndPosReverse[dbIdx]);
   }
-  if (purgeDir != NEITHER) return;
-
-  RecDistList *upRecs = _minUpstreamRecs[dbIdx];
-	RecDistList *downRecs = _minDownstreamRecs[dbIdx];
-
-	int upDist = upRecs->getMaxLeftEndPos();
-	int downDist = downRecs->getMaxLeftEndPos();
-
+  if (purgeDir != NEITHER) {
+	  _leftRecs[dbIdx].clear();
+	  return;
+  }
 
-  if (upDist == -1 && downDist == -1) return;
+	int maxDist = maxNeededLeftDist(dbIdx);
+	_leftRecs[dbIdx].clear();
+	if (maxDist == -1) return;
 
-	int leftMostEndPos = (_currQueryRec->getStartPos() - max(upDist, downDist)) +1;
+	int leftMostEndPos = (_currQueryRec->getStartPos() - maxDist) +1;
 	if ((!_sameStrand && !_diffStrand) ||
 		(_sameStrand && _qForward) ||
 		(_diffStrand && _qReverse))  {
@@ -683,6 +610,87 @@ void CloseSweep::setLeftClosestEndPos(int dbIdx)
 	}
 }
 
+//The distance past which no record on the left of the query can be
+//among the closest to this query or any later one on its strand, or -1
+//if there's no such distance yet.
+//
+//Moving right adds the same amount to the distance of every record on
+//the left, so a record can go once k records closer than it stay
+//eligible: k distinct distances, or k ties when all ties are reported.
+//Only records on the left count, because those on the right may come to
+//overlap a later query. With -N, the k closer records must do for a
+//query of any name, and with -fu or -fd, the upstream and downstream
+//records are taken separately, so each must have its own k.
+int CloseSweep::maxNeededLeftDist(int dbIdx)
+{
+	vector<leftRecType> &leftRecs = _leftRecs[dbIdx];
+	if (!_context->forceUpstream() && !_context->forceDownstream()) {
+		return maxNeededLeftDist(leftRecs, leftRecs.size());
+	}
+	size_t numUp = 0;
+	for (size_t i=0; i < leftRecs.size(); i++) {
+		if (leftRecs[i]._streamDir == UPSTREAM) {
+			swap(leftRecs[i], leftRecs[numUp++]);
+		}
+	}
+	vector<leftRecType> downRecs(leftRecs.begin() + numUp, leftRecs.end());
+	int upDist = numUp == 0 ? 0 : maxNeededLeftDist(leftRecs, numUp);
+	int downDist = downRecs.empty() ? 0 : maxNeededLeftDist(downRecs, downRecs.size());
+	if (upDist == -1 || downDist == -1 || (numUp == 0 && downRecs.empty())) {
+		return -1;
+	}
+	return max(upDist, downDist);
+}
+
+int CloseSweep::maxNeededLeftDist(vector<leftRecType> &leftRecs, size_t numRecs)
+{
+	sort(leftRecs.begin(), leftRecs.begin() + numRecs);
+
+	//with -N, what a query of each name can't count: its namesakes when
+	//all ties are reported, otherwise the distances held by them alone.
+	vector<pair<const QuickString *, int> > nameCounts;
+	int maxNameCount = 0;
+
+	int numCounted = 0;
+	size_t i = 0;
+	while (i < numRecs) {
+		int dist = leftRecs[i]._dist;
+		size_t distStart = i;
+		bool oneName = true;
+		for (; i < numRecs && leftRecs[i]._dist == dist; i++) {
+			oneName = oneName && leftRecs[i]._rec->getName() == leftRecs[distStart]._rec->getName();
+		}
+		if (_allTies) {
+			numCounted += (int)(i - distStart);
+			if (_context->diffNames()) {
+				for (size_t j = distStart; j < i; j++) {
+					countName(nameCounts, leftRecs[j]._rec->getName(), maxNameCount);
+				}
+			}
+		} else {
+			numCounted++;
+			if (_context->diffNames() && oneName) {
+				countName(nameCounts, leftRecs[distStart]._rec->getName(), maxNameCount);
+			}
+		}
+		if (numCounted - maxNameCount >= _kClosest) {
+			return dist;
+		}
+	}
+	return -1;
+}
+
+void CloseSweep::countName(vector<pair<const QuickString *, int> > &nameCounts, const QuickString &name, int &maxCount)
+{
+	size_t j = 0;
+	while (j < nameCounts.size() && *(nameCounts[j].first) != name) j++;
+	if (j == nameCounts.size()) {
+		nameCounts.push_back(make_pair(&name, 0));
+	}
+	nameCounts[j].second++;
+	maxCount = max(maxCount, nameCounts[j].second);
+}
+
 bool CloseSweep::beforeLeftClosestEndPos(int dbIdx, const Record *rec)
 {
 	int recEndPos = rec->getEndPos();
@@ -747,6 +755,9 @@ CloseSweep::rateOvlpType CloseSweep::tryToAddRecord(const Record *cacheRec, int
 		if (!shouldIgnore) {
 			useList->addRec(dist, cacheRec, RecDistList::LEFT);
 		}
+		if (_purgeCache && !badStrand && !badStream) {
+			_leftRecs[dbIdx].push_back(leftRecType(dist, cacheRec, streamDir));
+		}
 	}
 
 	else if (chromDir == RIGHT) {
@@ -762,7 +773,13 @@ CloseSweep::rateOvlpType CloseSweep::tryToAddRecord(const Record *cacheRec, int
 		//      Otherwise, always continue.
 		if (!shouldIgnore) {
 			if (!useList->addRec(dist, cacheRec, RecDistList::RIGHT)) {
-				stopScanning = true;
+				//with -fu or -fd, the forced stream's hits are taken first
+				//at any distance, so only its list being full ends the scan.
+				bool otherStreamForced = (streamDir == DOWNSTREAM && _context->forceUpstream()) ||
+						(streamDir == UPSTREAM && _context->forceDownstream());
+				if (!otherStreamForced) {
+					stopScanning = true;
+				}
 			}
 		} else { // hit is ignored
 			if (allHitsRightOfQueryIgnored()) {
@@ -818,7 +835,7 @@ CloseSweep::purgeDirectionType CloseSweep::purgePointException(int dbIdx) {
       if (_qForward && _diffStrand) purgeDir = REVERSE_ONLY;
       else if (_qReverse && _sameStrand) purgeDir = REVERSE_ONLY;
     }
-   } else { //ignoreDownstream
+   } else if (_ignoreDownstream) {
      // if refDist, do nothing. left hits can't be downstream.
      if (_aDist) {
        //if qForward, do nothing. left hits can't be downstream.
@@ -42,14 +42,22 @@ public:
 };
 
 
+//The records at the k smallest distinct distances from a query, with all
+//of their ties. The distances are a sorted array of at most k ints, and
+//the records go in one pooled buffer in the order they're added, so a
+//query's worth of adds and the clear after it allocate nothing once the
+//buffers have grown. Records whose distance is pushed out by a closer one
+//stay in the buffer until it's compacted; they're the ones beyond
+//getMaxDist(). When the records are read back, they're grouped by
+//distance, keeping the order they were added in.
 class RecDistList {
 public:
     typedef enum { LEFT, OVERLAP, RIGHT } chromDirType;
 	RecDistList(int maxSize);
 	~RecDistList();
-	bool empty() const { return _empty; }
+	bool empty() const { return _dists.empty(); }
 	void clear();
-	int uniqueSize() const { return _currNumIdxs; }
+	int uniqueSize() const { return (int)_dists.size(); }
 	size_t totalSize() const { return _totalRecs; }
 	bool addRec(int dist, const Record *, chromDirType chromDir);
 	bool exists(int dist) const {
@@ -57,35 +65,45 @@ public:
 		return find(dist, dummyVal);
 	}
 	typedef pair<chromDirType, const Record *> elemPairType;
-	typedef vector<elemPairType> elemsType;
-	typedef pair<int, int> indexType;
 
-	int getMaxDist() const { return _empty ? 0 : _distIndex[_currNumIdxs-1].first; }
+	int getMaxDist() const { return _dists.empty() ? 0 : _dists.back()._dist; }
 	typedef int constIterType; //used to be a map iter, trying not to change interface too much.
 	constIterType begin() const { return 0; }
-	constIterType end() const { return _currNumIdxs; }
-	int currDist(constIterType iter) const { return _distIndex[iter].first; }
-	size_t currNumElems(constIterType iter) const { return allElems(iter)->size(); }
-	const elemsType *allElems(constIterType iter) const { return _allRecs[_distIndex[iter].second]; }
-	int getMaxLeftEndPos() const;
+	constIterType end() const { return uniqueSize(); }
+	int currDist(constIterType iter) const { return _dists[iter]._dist; }
+	size_t currNumElems(constIterType iter) const { return _dists[iter]._count; }
+	const elemPairType &currElem(constIterType iter, size_t idx) const;
 
 private:
-
-	void insert(int dist, const Record *, chromDirType chromDir);
-
+	class distInfoType {
+	public:
+		distInfoType(int dist) : _dist(dist), _count(0) {}
+		int _dist;
+		size_t _count; //records at this distance.
+	};
+	class distElemType {
+	public:
+		distElemType(int dist, const elemPairType &elem) : _dist(dist), _elem(elem) {}
+		int _dist;
+		elemPairType _elem;
+	};
 
 	//if true, pos will be the idx the distance is at.
 	//if false, pos will be the idx to insert at.
 	bool find(int dist, int &pos) const;
-
+	void compact();
+	void group() const;
 
 	int _kVal; //max unique allowed
-	bool _empty;
-	int _currNumIdxs;
-	int _totalRecs;
+	size_t _totalRecs;
+
+	vector<distInfoType> _dists; //sorted by distance, at most _kVal.
+	vector<distElemType> _elems;
 
-	vector<elemsType *> _allRecs;
-	indexType * _distIndex;
+	//_elems grouped by distance, made when first read.
+	mutable vector<elemPairType> _grouped;
+	mutable vector<size_t> _groupStarts;
+	mutable bool _isGrouped;
 };
 
 class CloseSweep : public NewChromSweep {
@@ -95,7 +113,7 @@ public:
 	bool init();
 	const vector<int> &getDistances() { return _finalDistances; }
 
-private:
+protected:
    ContextClosest *_context;
    int _kClosest; // how many closest hits we want to each query.
 	vector<RecDistList *> _minUpstreamRecs;
@@ -104,6 +122,9 @@ private:
 	vector<int> _maxPrevLeftClosestEndPos;
 	vector<int> _maxPrevLeftClosestEndPosReverse;
 
+	//whether records before the purge point are dropped from the cache.
+	bool _purgeCache;
+
 	vector<int> _finalDistances;
 
 
@@ -156,10 +177,25 @@ private:
     typedef enum { UPSTREAM, INTERSECT, DOWNSTREAM } streamDirType;
     typedef enum { NEITHER, FORWARD_ONLY, REVERSE_ONLY, BOTH } purgeDirectionType;
 
+	//a record to the left of the query that no option rules out, except
+	//perhaps -N, which depends on the query's name.
+	class leftRecType {
+	public:
+		leftRecType(int dist, const Record *rec, streamDirType streamDir) : _dist(dist), _rec(rec), _streamDir(streamDir) {}
+		bool operator < (const leftRecType &other) const { return _dist < other._dist; }
+		int _dist;
+		const Record *_rec;
+		streamDirType _streamDir;
+	};
+	vector<vector<leftRecType> > _leftRecs;
+
     void setLeftClosestEndPos(int dbIdx);
+    int maxNeededLeftDist(int dbIdx);
+    int maxNeededLeftDist(vector<leftRecType> &leftRecs, size_t numRecs);
+    static void countName(vector<pair<const QuickString *, int> > &nameCounts, const QuickString &name, int &maxCount);
     bool beforeLeftClosestEndPos(int dbIdx, const Record *rec);
     void clearClosestEndPos(int dbIdx);
-    int addRecsToRetList(const RecDistList::elemsType *recs, int currDist, RecordKeyVector &retList);
+    int addRecsToRetList(const RecDistList *recs, RecDistList::constIterType iter, int currDist, RecordKeyVector &retList);
     void addSingleRec(const Record *rec, int currDist, int &hitsUsed, RecordKeyVector &retList);
     rateOvlpType tryToAddRecord(const Record *cacheRec, int dist, int dbIdx, bool &stopScanning, chromDirType chromDir, streamDirType streamDir);
     purgeDirectionType purgePointException(int dbIdx);
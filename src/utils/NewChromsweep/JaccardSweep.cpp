@@ -0,0 +1,153 @@
+/*
+ * JaccardSweep.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "JaccardSweep.h"
+#include "ContextIntersect.h"
+#include "FileRecordMgr.h"
+
+JaccardSweep::JaccardSweep(ContextIntersect *context)
+: NewChromSweep(context),
+  _sameStrand(context->getSameStrand()),
+  _diffStrand(context->getDiffStrand()),
+  _intersectionBases(0),
+  _numIntersections(0)
+{
+}
+
+JaccardSweep::~JaccardSweep()
+{
+}
+
+bool JaccardSweep::init()
+{
+	if (!NewChromSweep::init()) {
+		return false;
+	}
+	_recCaches.resize(_numDBs);
+	_cacheChroms.resize(_numDBs);
+	return true;
+}
+
+void JaccardSweep::masterScan(RecordKeyVector &retList)
+{
+	for (int i=0; i < _numDBs; i++) {
+		if (dbFinished(i) || chromChange(i, retList, true)) {
+			continue;
+		}
+		scanCache(i, retList);
+		while (_currDbRecs[i] != NULL &&
+				_currQueryRec->sameChrom(_currDbRecs[i]) &&
+				!(_currDbRecs[i]->after(_currQueryRec)))
+		{
+			const Record *dbRec = _currDbRecs[i];
+			if (intersects(_currQueryRec, dbRec)) {
+				addHit(dbRec->getStartPos(), dbRec->getEndPos());
+			}
+			if (!_currQueryRec->after(dbRec)) {
+				cacheRecord(i, dbRec);
+			}
+			_dbFRMs[i]->deleteRecord(dbRec);
+			_currDbRecs[i] = NULL;
+			nextRecord(false, i);
+		}
+	}
+}
+
+void JaccardSweep::scanCache(int dbIdx, RecordKeyVector &retList)
+{
+	vector<CachedRec> &cache = _recCaches[dbIdx];
+	bool sameChrom = !cache.empty() && _currQueryRec->getChrName() == _cacheChroms[dbIdx];
+	int queryStart = _currQueryRec->getStartPos();
+	int queryEnd = _currQueryRec->getEndPos();
+
+	//keep what isn't behind the query, in order, as NewChromSweep would.
+	size_t numKept = 0;
+	size_t i = 0;
+	for (; i < cache.size(); i++) {
+		const CachedRec &rec = cache[i];
+		if (!sameChrom || queryStart >= rec._end) {
+			continue;
+		}
+		if (cachedIntersects(rec)) {
+			addHit(rec._start, rec._end);
+		} else if (rec._start >= queryEnd) {
+			break;
+		}
+		cache[numKept++] = rec;
+	}
+	for (; i < cache.size(); i++) {
+		cache[numKept++] = cache[i];
+	}
+	cache.resize(numKept);
+}
+
+void JaccardSweep::clearCache(int dbIdx)
+{
+	_recCaches[dbIdx].clear();
+}
+
+bool JaccardSweep::dbFinished(int dbIdx)
+{
+	return _currDbRecs[dbIdx] == NULL && _recCaches[dbIdx].empty();
+}
+
+bool JaccardSweep::allCachesEmpty()
+{
+	for (int i=0; i < _numDBs; i++) {
+		if (!_recCaches[i].empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void JaccardSweep::cacheRecord(int dbIdx, const Record *rec)
+{
+	vector<CachedRec> &cache = _recCaches[dbIdx];
+	if (cache.empty()) {
+		_cacheChroms[dbIdx] = rec->getChrName();
+	}
+	CachedRec cached;
+	cached._start = rec->getStartPos();
+	cached._end = rec->getEndPos();
+	cached._strand = rec->getStrandVal();
+	cached._isUnmapped = rec->isUnmapped();
+	cache.push_back(cached);
+}
+
+//Record::sameChromIntersects, without the overlap fractions.
+bool JaccardSweep::cachedIntersects(const CachedRec &rec) const
+{
+	if (_currQueryRec->isUnmapped() || rec._isUnmapped) {
+		return false;
+	}
+	Record::strandType queryStrand = _currQueryRec->getStrandVal();
+	if (_sameStrand && (queryStrand != rec._strand || queryStrand == Record::UNKNOWN)) {
+		return false;
+	}
+	if (_diffStrand && (queryStrand == Record::UNKNOWN || rec._strand == Record::UNKNOWN || queryStrand == rec._strand)) {
+		return false;
+	}
+	int queryStart = _currQueryRec->getStartPos();
+	int queryEnd = _currQueryRec->getEndPos();
+	int maxStart = max(queryStart, rec._start);
+	int minEnd = min(queryEnd, rec._end);
+	if (minEnd < maxStart) {
+		return false;
+	}
+	if (minEnd == maxStart && queryEnd != queryStart && rec._end != rec._start) {
+		return false;
+	}
+	return true;
+}
+
+void JaccardSweep::addHit(int start, int end)
+{
+	int maxStart = max(start, _currQueryRec->getStartPos());
+	int minEnd = min(end, _currQueryRec->getEndPos());
+	_intersectionBases += (unsigned long)(minEnd - maxStart);
+	_numIntersections++;
+}
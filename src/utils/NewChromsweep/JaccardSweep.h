@@ -0,0 +1,58 @@
+/*
+ * JaccardSweep.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef JACCARDSWEEP_H_
+#define JACCARDSWEEP_H_
+
+#include "NewChromsweep.h"
+#include "Record.h"
+
+//The sweep for jaccard and fisher, which only need the total overlap
+//between the files, and how many overlaps there were. It walks the files
+//just as NewChromSweep does, so the totals come out the same, but it adds
+//each overlap up as it's found, rather than returning lists of hits, and
+//it caches only the coordinates of database records, so a record can be
+//released as soon as it's read. next() never returns any hits.
+//
+//It doesn't handle -split, or the -f family of overlap fractions.
+class JaccardSweep : public NewChromSweep {
+public:
+	JaccardSweep(ContextIntersect *context);
+	~JaccardSweep();
+	bool init();
+
+	unsigned long getIntersectionBases() const { return _intersectionBases; }
+	unsigned long getNumIntersections() const { return _numIntersections; }
+
+private:
+	class CachedRec {
+	public:
+		int _start;
+		int _end;
+		Record::strandType _strand;
+		bool _isUnmapped;
+	};
+	//all of a cache's records are on one chrom.
+	vector<vector<CachedRec> > _recCaches;
+	vector<QuickString> _cacheChroms;
+	bool _sameStrand;
+	bool _diffStrand;
+
+	unsigned long _intersectionBases;
+	unsigned long _numIntersections;
+
+	void masterScan(RecordKeyVector &retList);
+	void scanCache(int dbIdx, RecordKeyVector &retList);
+	void clearCache(int dbIdx);
+	bool dbFinished(int dbIdx);
+	bool allCachesEmpty();
+
+	void cacheRecord(int dbIdx, const Record *rec);
+	bool cachedIntersects(const CachedRec &rec) const;
+	void addHit(int start, int end);
+};
+
+#endif /* JACCARDSWEEP_H_ */
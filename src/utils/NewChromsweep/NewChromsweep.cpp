@@ -334,10 +334,10 @@ void NewChromSweep::testChromOrder(const Record *rec)
         _filePrevChrom[fileIdx] = chrom;
         return; //no previously stored chrom for this file.
     }
+    //most records are on the same chrom as the last, so check that before copying.
+    if (chrom == prevIter->second) return;
     const QuickString prevChrom(prevIter->second);
-    _filePrevChrom[fileIdx] = chrom;
-
-    if (chrom == prevChrom) return;
+    prevIter->second = chrom;
 
     if (verifyChromOrderMismatch(chrom, prevChrom, fileIdx)) {
         fprintf(stderr, "ERROR: chromomsome sort ordering for file %s is inconsistent with other files. Record was:\n", _context->getInputFileName(fileIdx).c_str());
@@ -100,11 +100,11 @@ protected:
     virtual void clearCache(int dbIdx);
     virtual bool chromChange(int dbIdx, RecordKeyVector &retList, bool wantScan);
 
-    bool dbFinished(int dbIdx);
+    virtual bool dbFinished(int dbIdx);
 
     bool intersects(const Record *rec1, const Record *rec2) const;
 
-    bool allCachesEmpty();
+    virtual bool allCachesEmpty();
     bool allCurrDBrecsNull();
 
 
@@ -0,0 +1,93 @@
+/*****************************************************************************
+  LoserTree.h
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#ifndef LOSERTREE_H
+#define LOSERTREE_H
+
+#include <vector>
+
+using namespace std;
+
+/*
+   A tournament ("loser") tree for k-way merging of sorted inputs.
+
+   Each of the k leaves holds the key of the next event from one input.
+   winner() is the leaf with the smallest key (ties go to the lower leaf
+   index, so merges are deterministic). After the winner's key changes,
+   update() replays only the matches on that leaf's path to the root,
+   which is log2(k) comparisons against the stored losers, with no
+   allocation and no moving of payloads, unlike a priority_queue.
+
+   Leaves live at nodes k..2k-1 of an implicit binary tree, and internal
+   nodes 1..k-1 hold the loser of the match played there.
+ */
+template <typename KEY>
+class LoserTree {
+public:
+    LoserTree() {}
+
+    // build the tree over an initial set of keys, one per input.
+    // with no inputs, winner() is -1 and winnerKey() is emptyKey.
+    void init(const vector<KEY> &keys, const KEY &emptyKey) {
+        _keys = keys;
+        _emptyKey = emptyKey;
+        int k = (int)_keys.size();
+        _losers.assign(k > 0 ? k : 1, 0);
+        if (k <= 1) {
+            return;
+        }
+        vector<int> winners(2 * k);
+        for (int i = 0; i < k; ++i) {
+            winners[k + i] = i;
+        }
+        for (int node = k - 1; node > 0; --node) {
+            int a = winners[2 * node];
+            int b = winners[2 * node + 1];
+            if (beats(a, b)) {
+                winners[node] = a;
+                _losers[node] = b;
+            } else {
+                winners[node] = b;
+                _losers[node] = a;
+            }
+        }
+        _losers[0] = winners[1];
+    }
+
+    int size() const { return (int)_keys.size(); }
+    int winner() const { return _keys.empty() ? -1 : _losers[0]; }
+    const KEY &winnerKey() const {
+        return _keys.empty() ? _emptyKey : _keys[_losers[0]];
+    }
+    const KEY &key(int leaf) const { return _keys[leaf]; }
+
+    // change the key of the current winner and replay its path to the root.
+    // (the stored losers are only valid for the winner's path, so other
+    // leaves must not be updated; re-init() instead.)
+    void update(int leaf, const KEY &newKey) {
+        _keys[leaf] = newKey;
+        int k = (int)_keys.size();
+        int winner = leaf;
+        for (int node = (leaf + k) / 2; node > 0; node /= 2) {
+            if (beats(_losers[node], winner)) {
+                int tmp = _losers[node];
+                _losers[node] = winner;
+                winner = tmp;
+            }
+        }
+        _losers[0] = winner;
+    }
+
+private:
+    vector<KEY> _keys;
+    KEY _emptyKey;
+    vector<int> _losers; // _losers[0] is the overall winner.
+
+    bool beats(int a, int b) const {
+        return _keys[a] < _keys[b] || (!(_keys[b] < _keys[a]) && a < b);
+    }
+};
+
+#endif /* LOSERTREE_H */
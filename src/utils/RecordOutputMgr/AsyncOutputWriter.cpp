@@ -0,0 +1,97 @@
+/*
+ * AsyncOutputWriter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "AsyncOutputWriter.h"
+#include "ColumnarFormat.h"
+#include "GzipWriter.h"
+#include <iostream>
+#include <cstdlib>
+
+AsyncOutputWriter::AsyncOutputWriter(FILE *out, ColumnarWriter *columnarWriter, GzipWriter *gzipWriter)
+: _out(out),
+  _columnarWriter(columnarWriter),
+  _gzipWriter(gzipWriter),
+  _head(0),
+  _numQueued(0),
+  _done(false),
+  _started(false)
+{
+	pthread_mutex_init(&_lock, NULL);
+	pthread_cond_init(&_queuedCond, NULL);
+	pthread_cond_init(&_writtenCond, NULL);
+}
+
+AsyncOutputWriter::~AsyncOutputWriter()
+{
+	if (_started) {
+		pthread_mutex_lock(&_lock);
+		_done = true;
+		pthread_cond_signal(&_queuedCond);
+		pthread_mutex_unlock(&_lock);
+		pthread_join(_thread, NULL);
+	}
+
+	pthread_cond_destroy(&_writtenCond);
+	pthread_cond_destroy(&_queuedCond);
+	pthread_mutex_destroy(&_lock);
+}
+
+void AsyncOutputWriter::write(QuickString &buf)
+{
+	if (!_started) {
+		if (pthread_create(&_thread, NULL, runThread, this) != 0) {
+			cerr << "Error: unable to start output thread. Exiting." << endl;
+			exit(1);
+		}
+		_started = true;
+	}
+
+	pthread_mutex_lock(&_lock);
+	while (_numQueued == NUM_BUFFERS) {
+		pthread_cond_wait(&_writtenCond, &_lock);
+	}
+	//the slot after the last queued buffer has already been written and cleared.
+	_bufs[(_head + _numQueued) % NUM_BUFFERS].swap(buf);
+	_numQueued++;
+	pthread_cond_signal(&_queuedCond);
+	pthread_mutex_unlock(&_lock);
+}
+
+void AsyncOutputWriter::run()
+{
+	pthread_mutex_lock(&_lock);
+	while (true) {
+		while (_numQueued == 0 && !_done) {
+			pthread_cond_wait(&_queuedCond, &_lock);
+		}
+		if (_numQueued == 0) break;
+
+		//the head buffer stays queued while it's written, so write() won't touch it.
+		QuickString &buf = _bufs[_head];
+		pthread_mutex_unlock(&_lock);
+
+		if (_columnarWriter != NULL) {
+			_columnarWriter->write(buf.c_str(), buf.size());
+		} else if (_gzipWriter != NULL) {
+			_gzipWriter->write(buf.c_str(), buf.size());
+		} else {
+			fwrite(buf.c_str(), 1, buf.size(), _out);
+		}
+		buf.clear();
+
+		pthread_mutex_lock(&_lock);
+		_head = (_head + 1) % NUM_BUFFERS;
+		_numQueued--;
+		pthread_cond_signal(&_writtenCond);
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+void *AsyncOutputWriter::runThread(void *writer)
+{
+	static_cast<AsyncOutputWriter *>(writer)->run();
+	return NULL;
+}
@@ -0,0 +1,58 @@
+/*
+ * AsyncOutputWriter.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef ASYNCOUTPUTWRITER_H_
+#define ASYNCOUTPUTWRITER_H_
+
+#include "QuickString.h"
+#include <cstdio>
+#include <pthread.h>
+
+using namespace std;
+
+class ColumnarWriter;
+class GzipWriter;
+
+//Writes full output buffers from a thread of its own, so that the tool
+//doesn't wait on slow disks or pipes. Buffers queue up in a small ring,
+//and are written in the order they were handed over. The thread isn't
+//started until the first buffer is, and the ring's buffers only grow as
+//big as the output put in them, so tools with little output don't pay for either.
+class AsyncOutputWriter {
+public:
+	//Output goes through the columnar or BGZF writer, if there is one, or else to out.
+	AsyncOutputWriter(FILE *out, ColumnarWriter *columnarWriter, GzipWriter *gzipWriter);
+
+	//Writes anything still queued, then stops the thread.
+	~AsyncOutputWriter();
+
+	//Queue the contents of buf, which gets an empty buffer in exchange.
+	//Waits if every buffer in the ring is already queued.
+	void write(QuickString &buf);
+
+private:
+	static const int NUM_BUFFERS = 3;
+
+	FILE *_out;
+	ColumnarWriter *_columnarWriter;
+	GzipWriter *_gzipWriter;
+
+	QuickString _bufs[NUM_BUFFERS];
+	int _head; //the next buffer to write.
+	int _numQueued;
+	bool _done;
+	bool _started;
+
+	pthread_t _thread;
+	pthread_mutex_t _lock;
+	pthread_cond_t _queuedCond;
+	pthread_cond_t _writtenCond;
+
+	void run();
+	static void *runThread(void *writer);
+};
+
+#endif /* ASYNCOUTPUTWRITER_H_ */
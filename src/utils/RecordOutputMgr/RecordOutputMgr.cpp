@@ -22,6 +22,9 @@
 #include "VcfRecord.h"
 #include "GffRecord.h"
 #include "NoPosPlusRecord.h"
+#include "ColumnarFormat.h"
+#include "AsyncOutputWriter.h"
+#include "GzipWriter.h"
 
 
 
@@ -31,8 +34,13 @@
 RecordOutputMgr::RecordOutputMgr()
 : _context(NULL),
   _printable(true),
+  _outFile(stdout),
+  _columnarWriter(NULL),
+  _gzipWriter(NULL),
+  _asyncWriter(NULL),
   _bamWriter(NULL),
   _currBamBlockList(NULL),
+  _outBufSize(UNBUFFERED_OUTBUF_SIZE),
   _bamBlockMgr(NULL)
 {
 	_bamBlockMgr = new BlockMgr();
@@ -47,6 +55,16 @@ RecordOutputMgr::~RecordOutputMgr()
 	if (_outBuf.size() > 0) {
 		flush();
 	}
+	delete _asyncWriter; //waits for queued output to be written.
+	_asyncWriter = NULL;
+	delete _columnarWriter; //writes the end of the file, or reports a bad line the writer thread found.
+	_columnarWriter = NULL;
+	delete _gzipWriter; //so does this.
+	_gzipWriter = NULL;
+	if (_outFile != stdout) {
+		fclose(_outFile);
+		_outFile = NULL;
+	}
 	if (_bamWriter != NULL) {
 		_bamWriter->Close();
 		delete _bamWriter;
@@ -57,7 +75,7 @@ RecordOutputMgr::~RecordOutputMgr()
 
 }
 
-void RecordOutputMgr::init(ContextBase *context) {
+void RecordOutputMgr::init(ContextBase *context, const QuickString &outputFile) {
 	_context = context;
 	if (_context->getOutputFileType() == FileRecordTypeChecker::BAM_FILE_TYPE) {
 		//set-up BAM writer.
@@ -65,10 +83,36 @@ void RecordOutputMgr::init(ContextBase *context) {
 		_bamWriter->SetCompressionMode(_context->getUncompressedBam() ?  BamTools::BamWriter::Uncompressed : BamTools::BamWriter::Compressed);
 
 		int bamFileIdx = _context->getBamHeaderAndRefIdx();
-		_bamWriter->Open("stdout", _context->getFile(bamFileIdx)->getHeader().c_str(), _context->getFile(bamFileIdx)->getBamReferences());
+		if (!_bamWriter->Open(outputFile.c_str(), _context->getFile(bamFileIdx)->getHeader().c_str(), _context->getFile(bamFileIdx)->getBamReferences())) {
+			cerr << "Error: Unable to open output file " << outputFile << ". Exiting." << endl;
+			exit(1);
+		}
 	} else {
+		if (strcmp(outputFile.c_str(), "stdout") != 0) {
+			_outFile = fopen(outputFile.c_str(), "w");
+			if (_outFile == NULL) {
+				cerr << "Error: Unable to open output file " << outputFile << ". Exiting." << endl;
+				exit(1);
+			}
+		}
+		if (_context->getOutputFileType() == FileRecordTypeChecker::COLUMNAR_FILE_TYPE) {
+			_columnarWriter = new ColumnarWriter(_outFile);
+		} else if (_context->getBgzfOutput() || _context->getGzipOutput()) {
+			_gzipWriter = new GzipWriter(_outFile, _context->getBgzfOutput() ? GzipWriter::BGZF : GzipWriter::GZIP,
+					_context->getNumThreads());
+			if (!_context->getTabixIndexFile().empty()) {
+				_gzipWriter->setIndexer(new TabixIndexer(_context->getTabixIndexFile(), _context->getTabixPreset()));
+			}
+		}
 		//for everything but BAM, we'll copy output to an output buffer before printing.
-		_outBuf.reserve(MAX_OUTBUF_SIZE);
+		//Buffered output is handed to a writer thread each time the buffer fills.
+		if (_context->getUseBufferedOutput()) {
+			_outBufSize = _context->getOutBufSize();
+			//the buffer grows as it's filled, rather than taking all of _outBufSize up front.
+			_asyncWriter = new AsyncOutputWriter(_outFile, _columnarWriter, _gzipWriter);
+		} else {
+			_outBuf.reserve(_outBufSize);
+		}
 	}
 	if (_context->getProgram() == ContextBase::INTERSECT) {
 		if ((static_cast<ContextIntersect *>(_context))->getAnyHit() || (static_cast<ContextIntersect *>(_context))->getNoHit() ||
@@ -127,8 +171,8 @@ RecordOutputMgr::printBamType RecordOutputMgr::printBamRecord(RecordKeyVector &k
 
 void RecordOutputMgr::printRecord(const Record *record)
 {
-	RecordKeyVector keyList(record);
-	printRecord(keyList);
+	_singleRecord.setKey(record);
+	printRecord(_singleRecord);
 }
 
 void RecordOutputMgr::printRecord(const Record *record, const QuickString & value)
@@ -530,6 +574,17 @@ void RecordOutputMgr::printKey(const Record *key)
 }
 
 void RecordOutputMgr::flush() {
-	fwrite(_outBuf.c_str(), 1, _outBuf.size(), stdout);
+	if (_asyncWriter != NULL) {
+		_asyncWriter->write(_outBuf);
+		return;
+	}
+	if (_columnarWriter != NULL) {
+		_columnarWriter->write(_outBuf.c_str(), _outBuf.size());
+		_columnarWriter->checkError();
+	} else if (_gzipWriter != NULL) {
+		_gzipWriter->write(_outBuf.c_str(), _outBuf.size());
+	} else {
+		fwrite(_outBuf.c_str(), 1, _outBuf.size(), _outFile);
+	}
 	_outBuf.clear();
 }
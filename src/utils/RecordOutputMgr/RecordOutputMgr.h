@@ -15,6 +15,9 @@
 using namespace std;
 
 class BlockMgr;
+class ColumnarWriter;
+class AsyncOutputWriter;
+class GzipWriter;
 
 class RecordOutputMgr {
 public:
@@ -22,7 +25,8 @@ public:
 	~RecordOutputMgr();
 
 	//The init method must be called after all the input files are open.
-	void init(ContextBase *context);
+	//Output goes to stdout unless an output file name is given.
+	void init(ContextBase *context, const QuickString &outputFile = "stdout");
 
 	void printRecord(const Record *record);
 	void printRecord(RecordKeyVector &keyList);
@@ -39,13 +43,19 @@ private:
 
 	ContextBase *_context;
 	bool _printable;
+	FILE *_outFile;
+	ColumnarWriter *_columnarWriter;
+	GzipWriter *_gzipWriter;
+	AsyncOutputWriter *_asyncWriter;
 	BamTools::BamWriter *_bamWriter;
 	RecordKeyVector *_currBamBlockList;
 
 	QuickString _outBuf;
+	size_t _outBufSize;
 
 	BlockMgr *_bamBlockMgr;
 	QuickString _afterVal; //to store values to be printed after record, such as column operations.
+	RecordKeyVector _singleRecord; //reused to print a lone record, rather than building a list for each.
 	//some helper functions to neaten the code.
 	void null(bool queryType, bool dbType);
 
@@ -59,12 +69,12 @@ private:
 	void reportOverlapDetail(const Record *keyRecord, const Record *hitRecord, int hitIdx = 0);
 	void reportOverlapSummary(RecordKeyVector &keyList);
 
-	static const unsigned int MAX_OUTBUF_SIZE = 16384; //16 K
+	static const unsigned int UNBUFFERED_OUTBUF_SIZE = 16384; //16 K
 
 	// If we are using buffered output, only flush the output buffer if it's least
 	// 90% full. If we're not using buffered output, flush if it's not empty
 	bool needsFlush() const {
-		return ((_context->getUseBufferedOutput() &&_outBuf.size() >= MAX_OUTBUF_SIZE *.9) ||
+		return ((_context->getUseBufferedOutput() &&_outBuf.size() >= _outBufSize *.9) ||
 				(!_context->getUseBufferedOutput() && !_outBuf.empty()));
 	}
 	void flush();
@@ -72,6 +72,7 @@ Class methods
 // Constructor
 BedFile::BedFile(string &bedFile)
 : bedFile(bedFile),
+  _lineNum(0),
   _isGff(false),
   _isVcf(false),
   _typeIsKnown(false),
@@ -84,7 +85,8 @@ BedFile::BedFile(string &bedFile)
 {}
 
 BedFile::BedFile(void)
-: _isGff(false),
+: _lineNum(0),
+  _isGff(false),
   _isVcf(false),
   _typeIsKnown(false),
   _merged_start(-1),
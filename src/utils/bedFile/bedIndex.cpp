@@ -0,0 +1,219 @@
+/*****************************************************************************
+  bedIndex.cpp
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#include "bedIndex.h"
+#include <algorithm>
+
+
+// the level of the bin hierarchy that a bin is in. Finer levels
+// have the higher bin numbers.
+static BINLEVEL binLevel(BIN bin) {
+    BINLEVEL level = 0;
+    while (bin < _binOffsetsExtended[level])
+        ++level;
+    return level;
+}
+
+
+bool binSearchLess(BIN a, BIN b) {
+    BINLEVEL la = binLevel(a);
+    BINLEVEL lb = binLevel(b);
+    if (la != lb) return la < lb;
+    return a < b;
+}
+
+
+// orders intervals as a search of the bin map visits them:
+// by level, then by bin, then as they were added.
+struct BinOrderLt {
+    const vector<BIN> &bins;
+    BinOrderLt(const vector<BIN> &b) : bins(b) {}
+    bool operator()(size_t i, size_t j) const {
+        if (bins[i] != bins[j]) return binSearchLess(bins[i], bins[j]);
+        return i < j;
+    }
+};
+
+
+struct StartLt {
+    const vector<CHRPOS> &starts;
+    StartLt(const vector<CHRPOS> &s) : starts(s) {}
+    bool operator()(size_t i, size_t j) const {
+        if (starts[i] != starts[j]) return starts[i] < starts[j];
+        return i < j;
+    }
+};
+
+
+IntervalIndex::IntervalIndex(void)
+: _numIntervals(0)
+{}
+
+
+void IntervalIndex::Add(const string &chrom, CHRPOS start, CHRPOS end) {
+    IndexChrom &c = _chroms[chrom];
+    c.starts.push_back(start);
+    c.ends.push_back(end);
+    c.bins.push_back(getBin(start, end));
+    // the ids wait here, in the order added, until Finish().
+    c.idsByRank.push_back(_numIntervals++);
+}
+
+
+void IntervalIndex::Finish(void) {
+    map<string, IndexChrom>::iterator chromItr = _chroms.begin();
+    for (; chromItr != _chroms.end(); ++chromItr) {
+        IndexChrom &c = chromItr->second;
+        size_t n = c.starts.size();
+
+        vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i) order[i] = i;
+        sort(order.begin(), order.end(), BinOrderLt(c.bins));
+        vector<size_t> ranks(n);
+        vector<size_t> idsByRank(n);
+        for (size_t r = 0; r < n; ++r) {
+            ranks[order[r]] = r;
+            idsByRank[r] = c.idsByRank[order[r]];
+        }
+
+        for (size_t i = 0; i < n; ++i) order[i] = i;
+        sort(order.begin(), order.end(), StartLt(c.starts));
+        IndexChrom sorted;
+        sorted.starts.resize(n);
+        sorted.ends.resize(n);
+        sorted.maxEnds.resize(n);
+        sorted.bins.resize(n);
+        sorted.ranks.resize(n);
+        CHRPOS maxEnd = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t k = order[i];
+            sorted.starts[i] = c.starts[k];
+            sorted.ends[i]   = c.ends[k];
+            sorted.bins[i]   = c.bins[k];
+            sorted.ranks[i]  = ranks[k];
+            maxEnd = max(maxEnd, c.ends[k]);
+            sorted.maxEnds[i] = maxEnd;
+        }
+        sorted.idsByRank.swap(idsByRank);
+        c = sorted;
+    }
+}
+
+
+void IntervalIndex::FindCandidates(const string &chrom, CHRPOS start,
+                                   CHRPOS end, vector<size_t> &ids) const
+{
+    map<string, IndexChrom>::const_iterator chromItr = _chroms.find(chrom);
+    if (chromItr == _chroms.end())
+        return;
+    const IndexChrom &c = chromItr->second;
+
+    // the first bins at the finest level, as allHits computes them.
+    BIN startBin = (start >> _binFirstShift);
+    BIN endBin = ((end-1) >> _binFirstShift);
+
+    // scan back from the last interval starting at or before the end
+    // until no earlier interval can reach the start.
+    size_t first = ids.size();
+    size_t i = upper_bound(c.starts.begin(), c.starts.end(), end)
+               - c.starts.begin();
+    while (i > 0) {
+        --i;
+        if (c.maxEnds[i] < start)
+            break;
+        if (c.ends[i] < start)
+            continue;
+        // would the bin search have visited its bin?
+        BIN bin = c.bins[i];
+        BINLEVEL level = binLevel(bin);
+        BIN offset = _binOffsetsExtended[level];
+        BIN shift = _binNextShift * level;
+        if (bin >= (startBin >> shift) + offset &&
+            bin <= (endBin >> shift) + offset)
+        {
+            ids.push_back(c.ranks[i]);
+        }
+    }
+
+    sort(ids.begin() + first, ids.end());
+    for (size_t j = first; j < ids.size(); ++j)
+        ids[j] = c.idsByRank[ids[j]];
+}
+
+
+BedIndex::BedIndex(BedFile *bedFile)
+: _bedFile(bedFile)
+{
+    _bedFile->loadBedFileIntoVector();
+    const bedVector &beds = _bedFile->bedList;
+    for (size_t i = 0; i < beds.size(); ++i)
+        _index.Add(beds[i].chrom, beds[i].start, beds[i].end);
+    _index.Finish();
+}
+
+
+// the tests BedFile::allHits applies to each feature in the bins it searches.
+bool BedIndex::IsHit(const BED &b, CHRPOS start, CHRPOS end,
+                     const string &strand, bool sameStrand, bool diffStrand,
+                     float overlapFraction, bool reciprocal) const
+{
+    CHRPOS aLength = (end - start);
+    CHRPOS s = max(start, b.start);
+    CHRPOS e = min(end, b.end);
+    int overlapBases = (e - s);
+    // 1. is there sufficient overlap w.r.t A?
+    if (!( (float) overlapBases / (float) aLength >= overlapFraction))
+        return false;
+    // 2. does the overlap meet the user's strand requirements?
+    bool strands_are_same = (strand == b.strand);
+    if (!( (sameStrand == false && diffStrand == false) ||
+           (sameStrand == true && strands_are_same == true) ||
+           (diffStrand == true && strands_are_same == false) ))
+        return false;
+    // 3. did the user request reciprocal overlap
+    // (i.e. sufficient overlap w.r.t. both A and B?)
+    if (reciprocal) {
+        CHRPOS bLength = (b.end - b.start);
+        float bOverlap = ( (float) overlapBases / (float) bLength );
+        return (bOverlap >= overlapFraction);
+    }
+    return true;
+}
+
+
+void BedIndex::allHits(const string &chrom, CHRPOS start, CHRPOS end,
+                       const string &strand, vector<size_t> &hits,
+                       bool sameStrand, bool diffStrand,
+                       float overlapFraction, bool reciprocal) const
+{
+    size_t first = hits.size();
+    _index.FindCandidates(chrom, start, end, hits);
+    size_t numHits = first;
+    for (size_t i = first; i < hits.size(); ++i) {
+        if (IsHit(Get(hits[i]), start, end, strand, sameStrand, diffStrand,
+                  overlapFraction, reciprocal))
+        {
+            hits[numHits++] = hits[i];
+        }
+    }
+    hits.resize(numHits);
+}
+
+
+bool BedIndex::anyHits(const string &chrom, CHRPOS start, CHRPOS end,
+                       const string &strand, bool sameStrand, bool diffStrand,
+                       float overlapFraction, bool reciprocal) const
+{
+    vector<size_t> candidates;
+    _index.FindCandidates(chrom, start, end, candidates);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (IsHit(Get(candidates[i]), start, end, strand, sameStrand,
+                  diffStrand, overlapFraction, reciprocal))
+        {
+            return true;
+        }
+    }
+    return false;
+}
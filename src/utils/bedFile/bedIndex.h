@@ -0,0 +1,106 @@
+/*****************************************************************************
+  bedIndex.h
+
+  Licenced under the GNU General Public License 2.0 license.
+******************************************************************************/
+#ifndef BEDINDEX_H
+#define BEDINDEX_H
+
+#include "bedFile.h"
+#include <vector>
+#include <map>
+#include <string>
+
+using namespace std;
+
+
+// whether a search of BedFile's bin map visits bin a before bin b: it goes
+// level by level, from the finest bins to the largest, and by bin within
+// a level. Intervals in the same bin are visited in the order added.
+bool binSearchLess(BIN a, BIN b);
+
+
+/*
+    A read-only index of intervals, for the tools that load B once and
+    search it for each A feature.  Each chrom's intervals are held in flat
+    arrays sorted by start, along with a running max of their ends, so a
+    search is a binary search and a short scan back.
+
+    Intervals are known by the order in which they were added, and searches
+    return those numbers rather than copies of the features.  They come back
+    in the order that a search of BedFile's bin map would find them, so the
+    tools' output is unchanged.
+
+    Searching doesn't change the index, so once it is finished, any number
+    of threads can search it at once, each with its own hit vector.
+*/
+class IntervalIndex {
+
+public:
+
+    IntervalIndex(void);
+
+    // add an interval; it is numbered by the count of intervals before it.
+    void Add(const string &chrom, CHRPOS start, CHRPOS end);
+
+    // sort the intervals. Call once they have all been added.
+    void Finish(void);
+
+    size_t Size(void) const { return _numIntervals; }
+
+    // append the intervals that overlap [start, end), or touch it, and
+    // that a search of the bin map would visit.
+    void FindCandidates(const string &chrom, CHRPOS start, CHRPOS end,
+                        vector<size_t> &ids) const;
+
+private:
+
+    // one chrom's intervals, sorted by start.
+    struct IndexChrom {
+        vector<CHRPOS> starts;
+        vector<CHRPOS> ends;
+        vector<CHRPOS> maxEnds;     // max end of intervals [0, i]
+        vector<BIN>    bins;
+        vector<size_t> ranks;       // position in bin map search order
+        vector<size_t> idsByRank;
+    };
+    map<string, IndexChrom> _chroms;
+    size_t _numIntervals;
+};
+
+
+/*
+    A BED file loaded into its bedList and indexed.  Hits are returned as
+    indexes into bedList.
+*/
+class BedIndex {
+
+public:
+
+    // load the valid records of bedFile into its bedList, and index them.
+    BedIndex(BedFile *bedFile);
+
+    const BED &Get(size_t idx) const { return _bedFile->bedList[idx]; }
+
+    // the same hits, in the same order, as BedFile::allHits.
+    void allHits(const string &chrom, CHRPOS start, CHRPOS end,
+                 const string &strand, vector<size_t> &hits,
+                 bool sameStrand, bool diffStrand,
+                 float overlapFraction, bool reciprocal) const;
+
+    // return true if at least one overlap was found, as BedFile::anyHits.
+    bool anyHits(const string &chrom, CHRPOS start, CHRPOS end,
+                 const string &strand, bool sameStrand, bool diffStrand,
+                 float overlapFraction, bool reciprocal) const;
+
+private:
+
+    BedFile *_bedFile;
+    IntervalIndex _index;
+
+    bool IsHit(const BED &b, CHRPOS start, CHRPOS end, const string &strand,
+               bool sameStrand, bool diffStrand,
+               float overlapFraction, bool reciprocal) const;
+};
+
+#endif /* BEDINDEX_H */
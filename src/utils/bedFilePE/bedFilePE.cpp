@@ -394,99 +394,79 @@ bool BedFilePE::parseBedPELine (BEDPE &bed, const vector<string> &lineVector, co
 /*
     Adapted from kent source "binKeeperFind"
 */
-void BedFilePE::FindOverlapsPerBin(int bEnd, string chrom, CHRPOS start, CHRPOS end, string name, string strand,
-                                   vector<MATE> &hits, float overlapFraction, bool forceStrand, bool enforceDiffNames) {
-
-    int startBin, endBin;
-    startBin = (start >> _binFirstShift);
-    endBin = ((end-1) >> _binFirstShift);
-
-    // loop through each bin "level" in the binning hierarchy
-    for (int i = 0; i < _binLevels; ++i) {
-
-        // loop through each bin at this level of the hierarchy
-        int offset = _binOffsetsExtended[i];
-        for (int j = (startBin+offset); j <= (endBin+offset); ++j)  {
-
-            // loop through each feature in this chrom/bin and see if it overlaps
-            // with the feature that was passed in.  if so, add the feature to
-            // the list of hits.
-            vector<MATE>::const_iterator bedItr;
-            vector<MATE>::const_iterator bedEnd;
-            if (bEnd == 1) {
-                bedItr = bedMapEnd1[chrom][j].begin();
-                bedEnd = bedMapEnd1[chrom][j].end();
-            }
-            else if (bEnd == 2) {
-                bedItr = bedMapEnd2[chrom][j].begin();
-                bedEnd = bedMapEnd2[chrom][j].end();
-            }
-            else {
-                cerr << "Unexpected end of B requested" << endl;
-            }
-            for (; bedItr != bedEnd; ++bedItr) {
-                float overlap = overlaps(bedItr->bed.start, bedItr->bed.end, start, end);
-                float size    = end - start;
-
-                if ( (overlap / size) >= overlapFraction ) {
-
-                    // skip the hit if not on the same strand (and we care)
-                    if ((forceStrand == false) && (enforceDiffNames == false)) {
-                        hits.push_back(*bedItr);    // it's a hit, add it.
-                    }
-                    else if ((forceStrand == true) && (enforceDiffNames == false)) {
-                        if (strand == bedItr->bed.strand)
-                            hits.push_back(*bedItr);    // it's a hit, add it.
-                    }
-                    else if ((forceStrand == true) && (enforceDiffNames == true)) {
-                        if ((strand == bedItr->bed.strand) && (name != bedItr->bed.name))
-                            hits.push_back(*bedItr);    // it's a hit, add it.
-                    }
-                    else if ((forceStrand == false) && (enforceDiffNames == true)) {
-                        if (name != bedItr->bed.name)
-                            hits.push_back(*bedItr);    // it's a hit, add it.
-                    }
-                }
+void BedFilePE::FindOverlapsInIndex(int bEnd, const string &chrom, CHRPOS start, CHRPOS end,
+                                    const string &name, const string &strand, vector<size_t> &hits,
+                                    float overlapFraction, bool forceStrand, bool enforceDiffNames) const {
+
+    const vector<MATE> *mates;
+    size_t first = hits.size();
+    if (bEnd == 1) {
+        _mateIndex1.FindCandidates(chrom, start, end, hits);
+        mates = &mates1;
+    }
+    else if (bEnd == 2) {
+        _mateIndex2.FindCandidates(chrom, start, end, hits);
+        mates = &mates2;
+    }
+    else {
+        cerr << "Unexpected end of B requested" << endl;
+        return;
+    }
 
-            }
+    // keep the candidates that overlap enough, and meet the
+    // strand and name requirements.
+    size_t numHits = first;
+    for (size_t i = first; i < hits.size(); ++i) {
+        const BED &b = (*mates)[hits[i]].bed;
+        float overlap = overlaps(b.start, b.end, start, end);
+        float size    = end - start;
+
+        if ( (overlap / size) >= overlapFraction ) {
+            // skip the hit if not on the same strand (and we care)
+            if (forceStrand == true && strand != b.strand)
+                continue;
+            if (enforceDiffNames == true && name == b.name)
+                continue;
+            hits[numHits++] = hits[i];    // it's a hit, keep it.
         }
-        startBin >>= _binNextShift;
-        endBin >>= _binNextShift;
     }
+    hits.resize(numHits);
 }
 
 
-void BedFilePE::loadBedPEFileIntoMap() {
+void BedFilePE::loadBedPEFileIntoIndex() {
 
     int lineNum = 0;
-    int bin1, bin2;
     BedLineStatus bedStatus;
     BEDPE bedpeEntry, nullBedPE;
+    MATE bedEntry1, bedEntry2;
 
     Open();
     bedStatus = this->GetNextBedPE(bedpeEntry, lineNum);
     while (bedStatus != BED_INVALID) {
 
         if (bedStatus == BED_VALID) {
-            MATE *bedEntry1 = new MATE();
-            MATE *bedEntry2 = new MATE();
             // separate the BEDPE entry into separate
             // BED entries
-            splitBedPEIntoBeds(bedpeEntry, lineNum, bedEntry1, bedEntry2);
-
-            // load end1 into a UCSC bin map
-            bin1 = getBin(bedEntry1->bed.start, bedEntry1->bed.end);
-            this->bedMapEnd1[bedEntry1->bed.chrom][bin1].push_back(*bedEntry1);
-
-            // load end2 into a UCSC bin map
-            bin2 = getBin(bedEntry2->bed.start, bedEntry2->bed.end);
-            this->bedMapEnd2[bedEntry2->bed.chrom][bin2].push_back(*bedEntry2);
+            splitBedPEIntoBeds(bedpeEntry, lineNum, &bedEntry1, &bedEntry2);
+            mates1.push_back(bedEntry1);
+            mates2.push_back(bedEntry2);
+            _mateIndex1.Add(bedEntry1.bed.chrom, bedEntry1.bed.start, bedEntry1.bed.end);
+            _mateIndex2.Add(bedEntry2.bed.chrom, bedEntry2.bed.start, bedEntry2.bed.end);
 
             bedpeEntry = nullBedPE;
         }
         bedStatus = this->GetNextBedPE(bedpeEntry, lineNum);
     }
     Close();
+
+    // the vectors won't move now, so point each end at its mate.
+    for (size_t i = 0; i < mates1.size(); ++i) {
+        mates1[i].mate = &mates2[i];
+        mates2[i].mate = &mates1[i];
+    }
+    _mateIndex1.Finish();
+    _mateIndex2.Finish();
 }
 
 
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <algorithm>
 #include "bedFile.h"
+#include "bedIndex.h"
 #include "lineFileUtilities.h"
 
 using namespace std;
@@ -71,22 +72,29 @@ public:
 
     void reportBedPETab(const BEDPE &a);
     void reportBedPENewLine(const BEDPE &a);
-    void loadBedPEFileIntoMap();
+    // load the ends of each BEDPE entry into mates1 and mates2, and index them.
+    void loadBedPEFileIntoIndex();
     void splitBedPEIntoBeds(const BEDPE &a, const int &lineNum, MATE *bedEntry1, MATE *bedEntry2);
 
 
-    void FindOverlapsPerBin(int bEnd, string chrom, CHRPOS start, CHRPOS end, string name, string strand,
-        vector<MATE> &hits, float overlapFraction, bool forceStrand, bool enforceDiffNames);
+    // append the hits among the ends in mates1 (bEnd 1) or mates2 (bEnd 2),
+    // as indexes into them.
+    void FindOverlapsInIndex(int bEnd, const string &chrom, CHRPOS start, CHRPOS end,
+        const string &name, const string &strand, vector<size_t> &hits,
+        float overlapFraction, bool forceStrand, bool enforceDiffNames) const;
 
 
     string bedFile;
     unsigned int bedType;
 
-    masterMateMap bedMapEnd1;
-    masterMateMap bedMapEnd2;
+    // end1 and end2 of each entry. mates1[i] and mates2[i] are mates.
+    vector<MATE> mates1;
+    vector<MATE> mates2;
 
 private:
     istream *_bedStream;
+    IntervalIndex _mateIndex1;
+    IntervalIndex _mateIndex2;
 
     // methods
     BedLineStatus parseLine (BEDPE &bedpe, const vector<string> &lineVector, int &lineNum);
@@ -11,6 +11,7 @@
 #include "ContextSubtract.h"
 #include "ContextSpacing.h"
 #include "ContextCoverage.h"
+#include "ContextBatch.h"
 
 //tools
 #include "intersectFile.h"
@@ -40,6 +41,7 @@ BedtoolsDriver::BedtoolsDriver()
 	_supported.insert("coverage");
 	_supported.insert("complement");
 	_supported.insert("groupby");
+	_supported.insert("batch");
 }
 
 
@@ -50,7 +52,10 @@ bool BedtoolsDriver::supports(const QuickString &tool) {
 
 bool BedtoolsDriver::subMain(int argc, char **argv) {
 	_subCmd = argv[1];
-	ContextBase *context = getContext();
+	if (_subCmd == "batch") {
+		return batchMain(argc, argv);
+	}
+	ContextBase *context = getContext(_subCmd);
 
 	//process all command line arguments, check for valid usage,
 	//show help and error messages if needed.
@@ -62,7 +67,7 @@ bool BedtoolsDriver::subMain(int argc, char **argv) {
 
 	//establish which tool we're using (intersect, map, closest, etc).
 	//initialize it.
-	ToolBase *tool = getTool(context);
+	ToolBase *tool = getTool(_subCmd, context);
 	if (!tool->init()) {
 		delete context;
 		return false;
@@ -87,71 +92,151 @@ bool BedtoolsDriver::subMain(int argc, char **argv) {
 }
 
 
-ContextBase *BedtoolsDriver::getContext()
+bool BedtoolsDriver::batchMain(int argc, char **argv) {
+	ContextBatch *context = new ContextBatch();
+	if (!context->testCmdArgs(argc - 1, argv + 1)) {
+		_hadError = context->errorEncountered();
+		delete context;
+		return false;
+	}
+
+	//set up each job with its own context, tool and output, as though
+	//it had been run on its own with -sorted. The contexts keep
+	//pointers into their argv, so those must outlive them. They use
+	//the batch's open inputs, so each input is read just once, and
+	//stdin works too.
+	int numJobs = context->getNumJobs();
+	vector<vector<char *> > jobArgvs(numJobs);
+	vector<ContextBase *> jobContexts;
+	vector<IntersectFile *> jobTools;
+	vector<RecordOutputMgr *> outputMgrs;
+	bool runToQueryEnd = false;
+	bool ok = true;
+	for (int i = 0; i < numJobs && ok; i++) {
+		jobArgvs[i] = context->getJobArgv(i);
+		ContextBase *jobContext = getContext(context->getJobTool(i));
+		jobContexts.push_back(jobContext);
+		jobContext->shareFiles(context);
+		if (!jobContext->testCmdArgs((int)jobArgvs[i].size(), &jobArgvs[i][0])) {
+			_hadError = true;
+			ok = false;
+		}
+	}
+	//only open the outputs once every job is known to be valid.
+	for (int i = 0; i < numJobs && ok; i++) {
+		IntersectFile *tool = static_cast<IntersectFile *>(getTool(context->getJobTool(i), jobContexts[i]));
+		jobTools.push_back(tool);
+		if (!tool->initShared()) {
+			ok = false;
+			break;
+		}
+		RecordOutputMgr *outputMgr = new RecordOutputMgr();
+		outputMgr->init(jobContexts[i], context->getJobOutputFile(i));
+		outputMgrs.push_back(outputMgr);
+		runToQueryEnd = runToQueryEnd || static_cast<ContextIntersect *>(jobContexts[i])->getRunToQueryEnd();
+	}
+
+	if (ok) {
+		//one sweep with the loosest overlap test. Each job then keeps
+		//only the hits that pass its own.
+		context->setRunToQueryEnd(runToQueryEnd);
+		NewChromSweep sweep(context);
+		ok = sweep.init();
+		FileRecordMgr *queryFRM = context->getFile(context->getQueryFileIdx());
+		RecordKeyVector sharedHits;
+		RecordKeyVector hits;
+		while (ok && sweep.next(sharedHits)) {
+			for (int i = 0; i < numJobs; i++) {
+				jobTools[i]->findShared(sharedHits, hits);
+				jobTools[i]->processHits(outputMgrs[i], hits);
+				jobTools[i]->releaseHits(hits);
+			}
+			queryFRM->deleteRecord(sharedHits.getKey());
+			sharedHits.clearAll();
+		}
+		if (ok && !context->hasGenomeFile()) {
+			sweep.closeOut(!context->getNameCheckDisabled());
+		}
+		for (int i = 0; ok && i < numJobs; i++) {
+			jobTools[i]->finalizeCalculations();
+			jobTools[i]->giveFinalReport(outputMgrs[i]);
+		}
+	}
+
+	for (int i = 0; i < (int)jobContexts.size(); i++) {
+		if (i < (int)outputMgrs.size()) delete outputMgrs[i];
+		if (i < (int)jobTools.size()) delete jobTools[i];
+		delete jobContexts[i];
+	}
+	delete context;
+	return ok;
+}
+
+ContextBase *BedtoolsDriver::getContext(const QuickString &subCmd)
 {
 	ContextBase *context = NULL;
-	if (_subCmd == "intersect") {
+	if (subCmd == "intersect") {
 		context = new ContextIntersect();
-	} else if (_subCmd == "map") {
+	} else if (subCmd == "map") {
 		context = new ContextMap();
-	} else if (_subCmd == "merge") {
+	} else if (subCmd == "merge") {
 		context = new ContextMerge();
-	} else if (_subCmd == "jaccard") {
+	} else if (subCmd == "jaccard") {
 		context = new ContextJaccard();
-	} else if (_subCmd == "closest") {
+	} else if (subCmd == "closest") {
 		context = new ContextClosest();
-	} else if (_subCmd == "subtract") {
+	} else if (subCmd == "subtract") {
 		context = new ContextSubtract();
-	} else if (_subCmd == "sample") {
+	} else if (subCmd == "sample") {
 		context = new ContextSample();
-	} else if (_subCmd == "spacing") {
+	} else if (subCmd == "spacing") {
 		context = new ContextSpacing();
-	} else if (_subCmd == "fisher") {
+	} else if (subCmd == "fisher") {
 		context = new ContextFisher();
-	} else if (_subCmd == "coverage") {
+	} else if (subCmd == "coverage") {
 		context = new ContextCoverage();
-	} else if (_subCmd == "complement") {
+	} else if (subCmd == "complement") {
 		context = new ContextComplement();
-	} else if (_subCmd == "groupby") {
+	} else if (subCmd == "groupby") {
 		context = new ContextGroupBy();
 	} else {
-		cerr << "Error: Tool " << _subCmd << " is not supported. Exiting..." << endl;
+		cerr << "Error: Tool " << subCmd << " is not supported. Exiting..." << endl;
 		exit(1);
 	}
 	return context;
 }
 
-ToolBase *BedtoolsDriver::getTool(ContextBase *context)
+ToolBase *BedtoolsDriver::getTool(const QuickString &subCmd, ContextBase *context)
 {
 	ToolBase *tool = NULL;
-	if (_subCmd == "intersect") {
+	if (subCmd == "intersect") {
 		tool = new IntersectFile(static_cast<ContextIntersect *>(context));
-	} else if (_subCmd == "map") {
+	} else if (subCmd == "map") {
 		tool = new MapFile(static_cast<ContextMap *>(context));
-	} else if (_subCmd == "closest") {
+	} else if (subCmd == "closest") {
 		tool = new ClosestFile(static_cast<ContextClosest *>(context));
-	} else if (_subCmd == "merge") {
+	} else if (subCmd == "merge") {
 		tool = new MergeFile(static_cast<ContextMerge *>(context));
-	} else if (_subCmd == "jaccard") {
+	} else if (subCmd == "jaccard") {
 		tool = new Jaccard(static_cast<ContextJaccard *>(context));
-	} else if (_subCmd == "subtract") {
+	} else if (subCmd == "subtract") {
 		tool = new SubtractFile(static_cast<ContextSubtract *>(context));
-	} else if (_subCmd == "sample") {
+	} else if (subCmd == "sample") {
 		tool = new SampleFile(static_cast<ContextSample *>(context));
-	} else if (_subCmd == "spacing") {
+	} else if (subCmd == "spacing") {
 		tool = new SpacingFile(static_cast<ContextSpacing *>(context));
-	} else if (_subCmd == "fisher") {
+	} else if (subCmd == "fisher") {
 		tool = new Fisher(static_cast<ContextFisher *>(context));
-	} else if (_subCmd == "coverage") {
+	} else if (subCmd == "coverage") {
 		tool = new CoverageFile(static_cast<ContextCoverage *>(context));
-	} else if (_subCmd == "complement") {
+	} else if (subCmd == "complement") {
 		tool = new ComplementFile(static_cast<ContextComplement *>(context));
-	} else if (_subCmd == "groupby") {
+	} else if (subCmd == "groupby") {
 		tool = new GroupBy(static_cast<ContextGroupBy *>(context));
 	}
 
 	else {
-		cerr << "Error: Tool " << _subCmd << " is not supported. Exiting..." << endl;
+		cerr << "Error: Tool " << subCmd << " is not supported. Exiting..." << endl;
 		exit(1);
 	}
 	return tool;
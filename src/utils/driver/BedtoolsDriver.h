@@ -6,8 +6,8 @@ public:
 	BedtoolsDriver();
 	bool subMain(int argc, char **argv);
 	bool supports(const QuickString &tool);
-	ContextBase *getContext();
-	ToolBase *getTool(ContextBase *context);
+	ContextBase *getContext(const QuickString &subCmd);
+	ToolBase *getTool(const QuickString &subCmd, ContextBase *context);
 	bool hadError() const { return _hadError; }
 protected:
 	QuickString _subCmd;
@@ -15,4 +15,5 @@ protected:
 	supportType _supported;
 	bool _hadError;
 
+	bool batchMain(int argc, char **argv);
 };
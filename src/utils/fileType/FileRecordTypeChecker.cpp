@@ -2,6 +2,7 @@
 #include "FileRecordTypeChecker.h"
 #include "api/BamReader.h"
 #include "ParseTools.h"
+#include "ColumnarFormat.h"
 
 FileRecordTypeChecker::FileRecordTypeChecker()
 : _eofHit(false),
@@ -88,6 +89,7 @@ FileRecordTypeChecker::FileRecordTypeChecker()
 	_fileTypeNames[GZIP_FILE_TYPE] = "Gzip file type";
 	_fileTypeNames[BAM_FILE_TYPE] = "BAM file type";
 	_fileTypeNames[VCF_FILE_TYPE] = "VCF file type";
+	_fileTypeNames[COLUMNAR_FILE_TYPE] = "Columnar BED file type";
 }
 
 
@@ -102,6 +104,11 @@ bool FileRecordTypeChecker::scanBuffer(const char *buffer, size_t len, bool eofH
 		return true;
 	}
 
+	//columnar BED carries its own type information in its file header.
+	if (ColumnarFormat::hasMagic(buffer, len)) {
+		return handleColumnarFormat(buffer, len);
+	}
+
 	//special: the first thing we do is look for a gzipped file.
 	if (!_isGzipped && ((unsigned char)(buffer[0]) == 0x1f)) {
 		_isGzipped = true;
@@ -122,6 +129,42 @@ bool FileRecordTypeChecker::scanBuffer(const char *buffer, size_t len, bool eofH
 	}
 }
 
+bool FileRecordTypeChecker::handleColumnarFormat(const char *buffer, size_t len)
+{
+	int numFields = 0;
+	size_t headerBytes = 0;
+	QuickString header, sample;
+	int status = ColumnarFormat::parseFileHeader(buffer, len, numFields, header, sample, headerBytes);
+	if (status == 0 && !_eofHit) {
+		_insufficientData = true;
+		return false;
+	}
+	_insufficientData = false;
+	if (status != 1) {
+		cerr << "Error: file " << _filename << " is not a valid columnar BED file." << endl;
+		return false;
+	}
+	_isBinary = true;
+	_isText = false;
+	if (numFields == 0) {
+		_fileType = COLUMNAR_FILE_TYPE;
+		_recordType = EMPTY_RECORD_TYPE;
+		return true;
+	}
+	//the header and sample are the start of the text the file was made
+	//from, so the record type is decided exactly as it would be for that.
+	QuickString text(header);
+	text.append(sample);
+	_eofHit = true;
+	_isCompressed = false;
+	_numBytesInBuffer = text.size();
+	if (!handleTextFormat(text.c_str(), text.size())) {
+		return false;
+	}
+	_fileType = COLUMNAR_FILE_TYPE;
+	return true;
+}
+
 bool FileRecordTypeChecker::isBinaryBuffer(const char *buffer, size_t len)
 {
 	if (isBAM(buffer)) {
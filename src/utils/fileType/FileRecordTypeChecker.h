@@ -28,7 +28,7 @@ public:
 
 	typedef enum  { UNKNOWN_FILE_TYPE, EMPTY_FILE_TYPE, SINGLE_LINE_DELIM_TEXT_FILE_TYPE,
 			MULTI_LINE_ENTRY_TEXT_FILE_TYPE,
-			GFF_FILE_TYPE, GZIP_FILE_TYPE, BAM_FILE_TYPE, VCF_FILE_TYPE} FILE_TYPE;
+			GFF_FILE_TYPE, GZIP_FILE_TYPE, BAM_FILE_TYPE, VCF_FILE_TYPE, COLUMNAR_FILE_TYPE} FILE_TYPE;
 
 	typedef enum  { UNKNOWN_RECORD_TYPE, EMPTY_RECORD_TYPE, BED3_RECORD_TYPE, BED4_RECORD_TYPE, BEDGRAPH_RECORD_TYPE, BED5_RECORD_TYPE,
 		BED6_RECORD_TYPE, BED12_RECORD_TYPE, BED_PLUS_RECORD_TYPE, BED6_PLUS_RECORD_TYPE, BAM_RECORD_TYPE, VCF_RECORD_TYPE, GFF_RECORD_TYPE,
@@ -123,6 +123,7 @@ private:
 	bool isBinaryBuffer(const char *buffer, size_t len);
 	bool isBAM(const char *buffer);
 	bool handleTextFormat(const char *buffer, size_t len);
+	bool handleColumnarFormat(const char *buffer, size_t len);
 	bool isTextDelimtedFormat(const char *buffer, size_t len);
 	bool isBedFormat();
 	bool isVCFformat(const char *buffer);
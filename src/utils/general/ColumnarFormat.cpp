@@ -0,0 +1,397 @@
+/*
+ * ColumnarFormat.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ColumnarFormat.h"
+#include "ParseTools.h"
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <iostream>
+#include <zlib.h>
+
+const char *ColumnarFormat::MAGIC = "CBED";
+
+static const uint64_t NO_OFFSET = (uint64_t)-1;
+
+bool ColumnarFormat::hasMagic(const char *buf, size_t len)
+{
+	return len >= (size_t)MAGIC_LEN && memcmp(buf, MAGIC, MAGIC_LEN) == 0;
+}
+
+int ColumnarFormat::parseFileHeader(const char *buf, size_t len, int &numFields,
+		QuickString &header, QuickString &sample, size_t &headerBytes)
+{
+	size_t pos = MAGIC_LEN;
+	if (len < pos + 9) {
+		return 0;
+	}
+	if ((unsigned char)buf[pos] != VERSION) {
+		return -1;
+	}
+	pos++;
+	numFields = (int)getUint32(buf + pos);
+	pos += 4;
+	uint32_t headerLen = getUint32(buf + pos);
+	pos += 4;
+	if (len < pos + headerLen + 4) {
+		return 0;
+	}
+	header.assign(buf + pos, headerLen);
+	pos += headerLen;
+	uint32_t sampleLen = getUint32(buf + pos);
+	pos += 4;
+	if (len < pos + sampleLen) {
+		return 0;
+	}
+	sample.assign(buf + pos, sampleLen);
+	pos += sampleLen;
+	headerBytes = pos;
+	return 1;
+}
+
+void ColumnarFormat::putUint32(QuickString &buf, uint32_t val)
+{
+	for (int i = 0; i < 4; i++) {
+		buf.append((char)((val >> (8 * i)) & 0xff));
+	}
+}
+
+void ColumnarFormat::putUint64(QuickString &buf, uint64_t val)
+{
+	putUint32(buf, (uint32_t)(val & 0xffffffff));
+	putUint32(buf, (uint32_t)(val >> 32));
+}
+
+uint32_t ColumnarFormat::getUint32(const char *buf)
+{
+	const unsigned char *ubuf = (const unsigned char *)buf;
+	return (uint32_t)ubuf[0] | ((uint32_t)ubuf[1] << 8) |
+			((uint32_t)ubuf[2] << 16) | ((uint32_t)ubuf[3] << 24);
+}
+
+void ColumnarFormat::putVarint(QuickString &buf, uint32_t val)
+{
+	while (val >= 0x80) {
+		buf.append((char)((val & 0x7f) | 0x80));
+		val >>= 7;
+	}
+	buf.append((char)val);
+}
+
+bool ColumnarFormat::parseInt(const char *str, size_t len, int &val)
+{
+	size_t pos = 0;
+	bool isNegative = (len > 0 && str[0] == '-');
+	if (isNegative) {
+		pos++;
+	}
+	if (len == pos || len - pos > 10) {
+		return false;
+	}
+	if (str[pos] == '0' && (len - pos > 1 || isNegative)) {
+		return false;
+	}
+	int64_t sum = 0;
+	for (; pos < len; pos++) {
+		if (str[pos] < '0' || str[pos] > '9') {
+			return false;
+		}
+		sum = sum * 10 + (str[pos] - '0');
+	}
+	if (isNegative) {
+		sum = -sum;
+	}
+	if (sum > INT_MAX || sum <= INT_MIN) {
+		return false;
+	}
+	val = (int)sum;
+	return true;
+}
+
+bool ColumnarFormat::getVarint(const char *&pos, const char *end, uint32_t &val)
+{
+	val = 0;
+	for (int shift = 0; shift < 35 && pos < end; shift += 7) {
+		unsigned char byte = (unsigned char)*pos++;
+		val |= (uint32_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+ColumnarWriter::ColumnarWriter(FILE *out)
+: _out(out),
+  _closed(false),
+  _numFields(-1),
+  _numSampleLines(0),
+  _fileHeaderWritten(false),
+  _lineNum(0),
+  _errorMsg(NULL),
+  _errorLineNum(0),
+  _sectionBytesWritten(0),
+  _fileHeaderBytes(0),
+  _currChromId(-1),
+  _blockNumRecs(0),
+  _blockPosAsText(false)
+{
+	_starts.reserve(ColumnarFormat::BLOCK_SIZE);
+	_ends.reserve(ColumnarFormat::BLOCK_SIZE);
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+	close();
+}
+
+void ColumnarWriter::write(const char *buf, size_t len)
+{
+	const char *pos = buf;
+	const char *end = buf + len;
+	if (_errorMsg != NULL) {
+		return;
+	}
+	if (!_partialLine.empty()) {
+		const char *newLine = (const char *)memchr(pos, '\n', end - pos);
+		if (newLine == NULL) {
+			_partialLine.append(pos, end - pos);
+			return;
+		}
+		_partialLine.append(pos, newLine - pos);
+		addLine(_partialLine.c_str(), _partialLine.size());
+		_partialLine.clear();
+		pos = newLine + 1;
+	}
+	while (pos < end && _errorMsg == NULL) {
+		const char *newLine = (const char *)memchr(pos, '\n', end - pos);
+		if (newLine == NULL) {
+			_partialLine.append(pos, end - pos);
+			break;
+		}
+		addLine(pos, newLine - pos);
+		pos = newLine + 1;
+	}
+}
+
+void ColumnarWriter::close()
+{
+	if (_closed) {
+		return;
+	}
+	_closed = true;
+	if (!_partialLine.empty() && _errorMsg == NULL) {
+		addLine(_partialLine.c_str(), _partialLine.size());
+		_partialLine.clear();
+	}
+	checkError();
+	flushBlock();
+	if (!_fileHeaderWritten) {
+		writeFileHeader();
+	}
+	_sections.append((char)ColumnarFormat::INDEX_TAG);
+	ColumnarFormat::putUint32(_sections, (uint32_t)_chromOffsets.size());
+	for (int i = 0; i < (int)_chromOffsets.size(); i++) {
+		ColumnarFormat::putUint64(_sections, _fileHeaderBytes + _chromOffsets[i]);
+	}
+	_sections.append((char)ColumnarFormat::END_TAG);
+	writeSections();
+}
+
+void ColumnarWriter::addLine(const char *line, size_t len)
+{
+	_lineNum++;
+	if (len > 0 && line[len - 1] == '\r') {
+		len--;
+	}
+	if (len == 0) {
+		return;
+	}
+	if (_numFields == -1) {
+		QuickString lineStr;
+		lineStr.assign(line, len);
+		if (isHeaderLine(lineStr)) {
+			_header.append(line, len);
+			_header.append('\n');
+			return;
+		}
+	}
+
+	_delimPos.clear();
+	_delimPos.push_back(-1);
+	for (int i = 0; i < (int)len; i++) {
+		if (line[i] == '\t') {
+			_delimPos.push_back(i);
+		}
+	}
+	_delimPos.push_back((int)len);
+	int numFields = (int)_delimPos.size() - 1;
+	if (_numFields == -1) {
+		if (numFields < 3) {
+			lineError("has fewer than 3 fields");
+			return;
+		}
+		_numFields = numFields;
+		_columns.resize(_numFields - 1);
+	} else if (numFields != _numFields) {
+		lineError("has a different number of fields than the first record");
+		return;
+	}
+
+	if (_numSampleLines < ColumnarFormat::SAMPLE_LINES) {
+		_sample.append(line, len);
+		_sample.append('\n');
+		_numSampleLines++;
+	}
+
+	int start = 0, end = 0;
+	bool posAsText = !(ColumnarFormat::parseInt(line + _delimPos[1] + 1, _delimPos[2] - _delimPos[1] - 1, start) &&
+			ColumnarFormat::parseInt(line + _delimPos[2] + 1, _delimPos[3] - _delimPos[2] - 1, end));
+
+	size_t chromLen = _delimPos[1];
+	if (_currChromId == -1 || chromLen != _currChrom.size() ||
+			memcmp(line, _currChrom.c_str(), chromLen) != 0) {
+		flushBlock();
+		startChrom(line, chromLen);
+	} else if (_blockNumRecs > 0 && posAsText != _blockPosAsText) {
+		flushBlock();
+	}
+	_blockPosAsText = posAsText;
+	_blockNumRecs++;
+
+	if (!posAsText) {
+		_starts.push_back(start);
+		_ends.push_back(end);
+	}
+	for (int i = posAsText ? 1 : 3; i < _numFields; i++) {
+		int fieldStart = _delimPos[i] + 1;
+		int fieldLen = _delimPos[i + 1] - fieldStart;
+		QuickString &column = _columns[i - 1];
+		ColumnarFormat::putVarint(column, (uint32_t)fieldLen);
+		column.append(line + fieldStart, fieldLen);
+	}
+	if (_blockNumRecs == ColumnarFormat::BLOCK_SIZE) {
+		flushBlock();
+	}
+	if (!_fileHeaderWritten && _numSampleLines == ColumnarFormat::SAMPLE_LINES) {
+		writeFileHeader();
+	}
+}
+
+void ColumnarWriter::startChrom(const char *chrom, size_t len)
+{
+	_currChrom.assign(chrom, len);
+	map<QuickString, int>::iterator iter = _chromIds.find(_currChrom);
+	if (iter != _chromIds.end()) {
+		_currChromId = iter->second;
+		return;
+	}
+	_currChromId = (int)_chromOffsets.size();
+	_chromIds[_currChrom] = _currChromId;
+	_chromOffsets.push_back(NO_OFFSET);
+
+	_sections.append((char)ColumnarFormat::CHROM_TAG);
+	ColumnarFormat::putUint32(_sections, (uint32_t)len);
+	_sections.append(chrom, len);
+}
+
+void ColumnarWriter::flushBlock()
+{
+	if (_blockNumRecs == 0) {
+		return;
+	}
+	if (_chromOffsets[_currChromId] == NO_OFFSET) {
+		_chromOffsets[_currChromId] = _sectionBytesWritten + _sections.size();
+	}
+	int numRecs = _blockNumRecs;
+	_rawBlock.clear();
+	if (!_blockPosAsText) {
+		//unsigned arithmetic, so that extreme deltas wrap rather than overflow.
+		uint32_t prevStart = 0;
+		for (int i = 0; i < numRecs; i++) {
+			ColumnarFormat::putVarint(_rawBlock, ColumnarFormat::zigzag((int)((uint32_t)_starts[i] - prevStart)));
+			prevStart = (uint32_t)_starts[i];
+		}
+		for (int i = 0; i < numRecs; i++) {
+			ColumnarFormat::putVarint(_rawBlock, ColumnarFormat::zigzag((int)((uint32_t)_ends[i] - (uint32_t)_starts[i])));
+		}
+	}
+	for (int i = 0; i < (int)_columns.size(); i++) {
+		_rawBlock.append(_columns[i]);
+		_columns[i].clear();
+	}
+	_starts.clear();
+	_ends.clear();
+	_blockNumRecs = 0;
+
+	uLong rawLen = _rawBlock.size();
+	_storedBlock.resize(compressBound(rawLen));
+	uLongf storedLen = _storedBlock.size();
+	bool useCompressed = (compress2(&_storedBlock[0], &storedLen,
+			(const Bytef *)_rawBlock.c_str(), rawLen, Z_BEST_SPEED) == Z_OK && storedLen < rawLen);
+
+	_sections.append((char)ColumnarFormat::BLOCK_TAG);
+	ColumnarFormat::putUint32(_sections, (uint32_t)_currChromId);
+	ColumnarFormat::putUint32(_sections, (uint32_t)numRecs);
+	ColumnarFormat::putUint32(_sections, (uint32_t)rawLen);
+	if (useCompressed) {
+		ColumnarFormat::putUint32(_sections, (uint32_t)storedLen);
+	} else {
+		ColumnarFormat::putUint32(_sections, (uint32_t)rawLen);
+	}
+	_sections.append((char)(_blockPosAsText ? ColumnarFormat::POSITIONS_AS_TEXT : 0));
+	if (useCompressed) {
+		_sections.append((const char *)&_storedBlock[0], storedLen);
+	} else {
+		_sections.append(_rawBlock);
+	}
+	if (_fileHeaderWritten) {
+		writeSections();
+	}
+}
+
+void ColumnarWriter::writeFileHeader()
+{
+	QuickString fileHeader;
+	fileHeader.append(ColumnarFormat::MAGIC, ColumnarFormat::MAGIC_LEN);
+	fileHeader.append((char)ColumnarFormat::VERSION);
+	ColumnarFormat::putUint32(fileHeader, _numFields == -1 ? 0 : (uint32_t)_numFields);
+	ColumnarFormat::putUint32(fileHeader, (uint32_t)_header.size());
+	fileHeader.append(_header);
+	ColumnarFormat::putUint32(fileHeader, (uint32_t)_sample.size());
+	fileHeader.append(_sample);
+	fwrite(fileHeader.c_str(), 1, fileHeader.size(), _out);
+	_fileHeaderBytes = fileHeader.size();
+	_fileHeaderWritten = true;
+	writeSections();
+}
+
+void ColumnarWriter::writeSections()
+{
+	if (_sections.empty()) {
+		return;
+	}
+	fwrite(_sections.c_str(), 1, _sections.size(), _out);
+	_sectionBytesWritten += _sections.size();
+	_sections.clear();
+}
+
+void ColumnarWriter::lineError(const char *msg)
+{
+	_errorMsg = msg;
+	_errorLineNum = _lineNum;
+}
+
+void ColumnarWriter::checkError() const
+{
+	if (_errorMsg == NULL) {
+		return;
+	}
+	cerr << "Error: output line " << _errorLineNum << " " << _errorMsg
+		 << ", so it can't be written in columnar format." << endl;
+	exit(1);
+}
@@ -0,0 +1,131 @@
+/*
+ * ColumnarFormat.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef COLUMNARFORMAT_H_
+#define COLUMNARFORMAT_H_
+
+#include <cstdio>
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "QuickString.h"
+
+using namespace std;
+
+// Columnar BED ("cbed") is a binary interval format for handing records
+// from one bedtools step to the next without printing and re-parsing text.
+// All integers below are little-endian uint32, unless noted otherwise.
+//
+//	"CBED" version(1 byte) numFields
+//	headerLen header	the "#" header lines, verbatim
+//	sampleLen sample	the first data lines as text, for type detection
+//
+// followed by tagged sections:
+//
+//	'C' nameLen name	declares the next chromosome id (0, 1, 2, ...)
+//	'B' chromId numRecords rawLen storedLen flags(1 byte) payload
+//	'I' numChroms, then a uint64 file offset of each chrom's first block
+//	'E'
+//
+// A block holds up to BLOCK_SIZE records from one chromosome. Its payload
+// is zlib compressed, unless storedLen == rawLen, and is laid out by column:
+// the starts as zigzag varint deltas from the previous start, the lengths
+// (end - start) as zigzag varints, then each field after the third as a
+// varint length followed by the bytes of the field, one per record.
+// Blocks flagged POSITIONS_AS_TEXT store the second and third fields as
+// text columns too, for records (VCF, say) whose third field isn't an end.
+class ColumnarFormat {
+public:
+	static const char *MAGIC;
+	static const int MAGIC_LEN = 4;
+	static const unsigned char VERSION = 1;
+	static const int BLOCK_SIZE = 4096;
+	static const int SAMPLE_LINES = 16;
+
+	enum { CHROM_TAG = 'C', BLOCK_TAG = 'B', INDEX_TAG = 'I', END_TAG = 'E' };
+	enum { POSITIONS_AS_TEXT = 1 };
+
+	static bool hasMagic(const char *buf, size_t len);
+
+	// parse the file header at the front of buf. Returns 1 on success,
+	// 0 if buf doesn't yet hold the whole header, or -1 if it's invalid.
+	static int parseFileHeader(const char *buf, size_t len, int &numFields,
+			QuickString &header, QuickString &sample, size_t &headerBytes);
+
+	static void putUint32(QuickString &buf, uint32_t val);
+	static void putUint64(QuickString &buf, uint64_t val);
+	static uint32_t getUint32(const char *buf);
+	static void putVarint(QuickString &buf, uint32_t val);
+	// returns false if the varint runs past end.
+	static bool getVarint(const char *&pos, const char *end, uint32_t &val);
+
+	// only integers that print back exactly as given are stored as numbers.
+	static bool parseInt(const char *str, size_t len, int &val);
+
+	static uint32_t zigzag(int val) { return ((uint32_t)val << 1) ^ (uint32_t)(val >> 31); }
+	static int unzigzag(uint32_t val) { return (int)(val >> 1) ^ -(int)(val & 1); }
+};
+
+// Turns the tab delimited text of an output buffer into a columnar file.
+// Lines may be split across calls to write().
+class ColumnarWriter {
+public:
+	ColumnarWriter(FILE *out);
+	~ColumnarWriter();
+
+	// A line that can't be stored stops the writer, rather than exiting from
+	// whatever thread is writing. Nothing after it is written.
+	void write(const char *buf, size_t len);
+
+	// reports a line that couldn't be stored, and exits. Call it from the
+	// thread that owns the output.
+	void checkError() const;
+
+	// finish the last block and write the chromosome index, after checkError().
+	void close();
+
+private:
+	FILE *_out;
+	bool _closed;
+	int _numFields;
+	QuickString _header;
+	QuickString _sample;
+	int _numSampleLines;
+	bool _fileHeaderWritten;
+	QuickString _partialLine;
+	int _lineNum;
+	const char *_errorMsg; //the first line that couldn't be stored, if any.
+	int _errorLineNum;
+
+	// sections not yet written. They're held back until the sample is
+	// complete, since the file header has to come first.
+	QuickString _sections;
+	uint64_t _sectionBytesWritten;
+	uint64_t _fileHeaderBytes;
+
+	map<QuickString, int> _chromIds;
+	vector<uint64_t> _chromOffsets;
+	QuickString _currChrom;
+	int _currChromId;
+
+	int _blockNumRecs;
+	bool _blockPosAsText;
+	vector<int> _starts;
+	vector<int> _ends;
+	vector<QuickString> _columns; //fields 2..n, in the order of the file.
+	vector<int> _delimPos;
+	QuickString _rawBlock;
+	vector<unsigned char> _storedBlock;
+
+	void addLine(const char *line, size_t len);
+	void startChrom(const char *chrom, size_t len);
+	void flushBlock();
+	void writeFileHeader();
+	void writeSections();
+	void lineError(const char *msg);
+};
+
+#endif /* COLUMNARFORMAT_H_ */
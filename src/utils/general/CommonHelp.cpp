@@ -98,6 +98,25 @@ void multiDbOutputHelp() {
 void allToolsCommonHelp() {
 	cerr << "\t-bed\t"          << "If using BAM input, write output as BED." << endl << endl;
 
+	cerr << "\t-cbed\t"         << "Write output as columnar BED, a compact binary format that" << endl;
+	cerr                        << "\t\tbedtools reads back faster than text. Useful for passing" << endl;
+	cerr                        << "\t\tresults between bedtools steps." << endl << endl;
+
+	cerr << "\t-threads\t"      << "Number of threads to use. -obgz and -ogz output is compressed" << endl;
+	cerr                        << "\t\ton all of them, and tools that can split up their own work" << endl;
+	cerr                        << "\t\tsay so above. Output is the same. Default is 1." << endl << endl;
+
+	cerr << "\t-obgz\t"         << "Write output as BGZF compressed text, as bgzip does. It can be" << endl;
+	cerr                        << "\t\tread by gzip, and indexed by tabix if it is sorted." << endl << endl;
+
+	cerr << "\t-ogz\t"          << "Write output as gzip compressed text, as gzip does." << endl << endl;
+
+	cerr << "\t-tbi\t"          << "With -obgz, also write a tabix index of the output to this" << endl;
+	cerr                        << "\t\tfile. Output must be sorted by chrom, then start." << endl << endl;
+
+	cerr << "\t-tbip\t"         << "The columns -tbi indexes, as tabix -p: bed, gff or vcf." << endl;
+	cerr                        << "\t\tDefault is bed." << endl << endl;
+
 	cerr << "\t-header\t"       << "Print the header from the A file prior to results." << endl << endl;
 
 	cerr << "\t-nobuf\t"       << "Disable buffered output. Using this option will cause each line"<< endl;
@@ -111,4 +130,8 @@ void allToolsCommonHelp() {
 	cerr << "\t-iobuf\t"            << "Specify amount of memory to use for input buffer." << endl;
 	cerr << "\t\t" <<					"Takes an integer argument. Optional suffixes K/M/G supported." << endl;
 	cerr << "\t\t" 					<< "Note: currently has no effect with compressed files." << endl << endl;
+
+	cerr << "\t-obuf\t"            << "Specify amount of memory to use for each output buffer. Full" << endl;
+	cerr << "\t\t" <<					"buffers are written by a separate thread. Default is 4M." << endl;
+	cerr << "\t\t" <<					"Takes an integer argument. Optional suffixes K/M/G supported." << endl << endl;
 }
@@ -9,7 +9,6 @@
 #define FREELIST_H_
 
 #include <cstddef> //defines NULL
-#include <deque>
 #include <vector>
 
 using namespace std;
@@ -18,19 +17,21 @@ template <class T>
 class FreeList {
 public:
 	FreeList(int blockSize=512)
-	: _nextPos(0),
+	: _currBlock(-1),
+	  _nextPos(0),
+	  _capacity(0),
 	  _blockSize(blockSize)
 	{
-		_freeList.reserve(_blockSize);
 	}
 
 	~FreeList() {
-		for (int i=0; i < (int)_buffer.size(); i++) {
-			delete _buffer[i];
+		for (int i=0; i < (int)_blocks.size(); i++) {
+			delete [] _blocks[i];
 		}
 	}
 
 	void clear() {
+		_currBlock = -1;
 		_nextPos = 0;
 		_freeList.clear();
 	}
@@ -42,10 +43,14 @@ public:
 			ptr = _freeList.back();
 			_freeList.pop_back();
 		} else {
-			if (_nextPos == (int)_buffer.size()) {
-				growBuffer();
+			if (_currBlock < 0 || _nextPos == _blockLens[_currBlock]) {
+				if (_currBlock + 1 == (int)_blocks.size()) {
+					growBuffer();
+				}
+				_currBlock++;
+				_nextPos = 0;
 			}
-			ptr = _buffer[_nextPos];
+			ptr = _blocks[_currBlock] + _nextPos;
 			_nextPos ++;
 		}
 
@@ -60,19 +65,31 @@ public:
 		}
 	}
 
-	int capacity() const { return _buffer.size(); }
+	int capacity() const { return _capacity; }
 
 private:
-	deque<T *> _buffer;
+	vector<T *> _blocks;
+	vector<int> _blockLens;
 	vector<T *> _freeList;
-	int _nextPos;
+	int _currBlock; //the block objects are being handed out from.
+	int _nextPos; //the next unused object in that block.
+	int _capacity;
 	int _blockSize;
 	void growBuffer() {
-		for (int i=0; i < _blockSize; ++i) {
-			_buffer.push_back(new T());
-		}
+		//allocate the whole block at once, so that objects handed out
+		//one after another also sit next to each other in memory.
+		//Blocks start small and double up to the blockSize, so that a
+		//FreeList that only ever holds a few objects stays small.
+		int blockLen = _capacity > 0 ? _capacity : MIN_BLOCK_SIZE;
+		if (blockLen > _blockSize) blockLen = _blockSize;
+		if (blockLen < 1) blockLen = 1;
+		_blocks.push_back(new T[blockLen]);
+		_blockLens.push_back(blockLen);
+		_capacity += blockLen;
 	}
 
+	static const int MIN_BLOCK_SIZE = 8;
+
 	//this number determines how many times larger than the blockSize the freeList
 	//is allowed to grow. If speed performance is poor, we may need to increase this number.
 	//If memory performance is poor, decrease it.
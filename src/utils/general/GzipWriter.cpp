@@ -0,0 +1,299 @@
+/*
+ * GzipWriter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "GzipWriter.h"
+#include "TabixIndexer.h"
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+
+static const size_t BLOCK_HEADER_SIZE = 18;
+static const size_t BLOCK_FOOTER_SIZE = 8;
+
+// a gzip member header with the "BC" extra field. The block size
+// goes in the last two bytes.
+static const unsigned char BLOCK_HEADER[BLOCK_HEADER_SIZE] = {
+	31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0, 0, 0
+};
+
+static const unsigned char EOF_BLOCK[] = {
+	31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0, 27, 0,
+	3, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// a plain gzip member header, for GZIP.
+static const unsigned char GZIP_HEADER[] = {
+	31, 139, 8, 0, 0, 0, 0, 0, 0, 255
+};
+
+static void putLE16(char *buf, uint32_t val)
+{
+	buf[0] = (char)(val & 0xff);
+	buf[1] = (char)((val >> 8) & 0xff);
+}
+
+static void putLE32(char *buf, uint32_t val)
+{
+	putLE16(buf, val & 0xffff);
+	putLE16(buf + 2, val >> 16);
+}
+
+//min() takes these by reference, so they need a definition.
+const size_t GzipWriter::BLOCK_DATA_SIZE;
+const size_t GzipWriter::DICT_SIZE;
+
+GzipWriter::GzipWriter(FILE *out, FORMAT format, int numThreads)
+: _out(out),
+  _format(format),
+  _numThreads(numThreads < 1 ? 1 : numThreads),
+  _indexer(NULL),
+  _textStart(0),
+  _outLen(0),
+  _crc(crc32(0, NULL, 0)),
+  _textLen(0),
+  _stripes(_numThreads),
+  _workers(_numThreads),
+  _batch(0),
+  _numStripes(0),
+  _numDone(0),
+  _quit(false)
+{
+	//the streams are set up in place, as zlib keeps a pointer back to each.
+	for (int i = 0; i < _numThreads; i++) {
+		z_stream &zs = _stripes[i].zs;
+		memset(&zs, 0, sizeof(zs));
+		//negative window bits give raw deflate, without the zlib wrapper.
+		if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			cerr << "Error: unable to initialize compression. Exiting." << endl;
+			exit(1);
+		}
+	}
+
+	pthread_mutex_init(&_lock, NULL);
+	pthread_cond_init(&_startCond, NULL);
+	pthread_cond_init(&_doneCond, NULL);
+	_threads.resize(_numThreads - 1);
+	for (int i = 1; i < _numThreads; i++) {
+		_workers[i].writer = this;
+		_workers[i].stripeIdx = i;
+		if (pthread_create(&_threads[i - 1], NULL, runWorkerThread, &_workers[i]) != 0) {
+			cerr << "Error: unable to start compression thread. Exiting." << endl;
+			exit(1);
+		}
+	}
+
+	if (_format == GZIP) {
+		fwrite(GZIP_HEADER, 1, sizeof(GZIP_HEADER), _out);
+		_outLen = sizeof(GZIP_HEADER);
+	}
+}
+
+GzipWriter::~GzipWriter()
+{
+	compressText(true);
+	if (_format == BGZF) {
+		//text that ends a block is indexed as the start of the next.
+		if (_indexer != NULL) {
+			_blockOffsets.push_back(_outLen);
+		}
+		fwrite(EOF_BLOCK, 1, sizeof(EOF_BLOCK), _out);
+	} else {
+		char trailer[8];
+		putLE32(trailer, _crc);
+		putLE32(trailer + 4, (uint32_t)(_textLen & 0xffffffff));
+		fwrite(trailer, 1, sizeof(trailer), _out);
+	}
+
+	pthread_mutex_lock(&_lock);
+	_quit = true;
+	pthread_cond_broadcast(&_startCond);
+	pthread_mutex_unlock(&_lock);
+	for (size_t i = 0; i < _threads.size(); i++) {
+		pthread_join(_threads[i], NULL);
+	}
+	pthread_cond_destroy(&_doneCond);
+	pthread_cond_destroy(&_startCond);
+	pthread_mutex_destroy(&_lock);
+	for (int i = 0; i < _numThreads; i++) {
+		deflateEnd(&_stripes[i].zs);
+	}
+
+	if (_indexer != NULL) {
+		_indexer->write(_blockOffsets, BLOCK_DATA_SIZE);
+		delete _indexer;
+	}
+}
+
+void GzipWriter::setIndexer(TabixIndexer *indexer)
+{
+	_indexer = indexer;
+}
+
+void GzipWriter::write(const char *buf, size_t len)
+{
+	if (_indexer != NULL) {
+		_indexer->addText(buf, len);
+	}
+	_text.insert(_text.end(), buf, buf + len);
+	//wait for a block per thread, so small writes don't make small batches.
+	if (_text.size() - _textStart >= _numThreads * BLOCK_DATA_SIZE) {
+		compressText(false);
+	}
+}
+
+void GzipWriter::compressText(bool last)
+{
+	//the text of a partial block is kept for the next write, unless it's the last.
+	size_t pending = _text.size() - _textStart;
+	size_t numBlocks = last ? (pending + BLOCK_DATA_SIZE - 1) / BLOCK_DATA_SIZE : pending / BLOCK_DATA_SIZE;
+	if (last && _format == GZIP && numBlocks == 0) {
+		numBlocks = 1; //the deflate stream still needs its final block.
+	}
+	if (numBlocks == 0) return;
+	size_t len = last ? pending : numBlocks * BLOCK_DATA_SIZE;
+
+	size_t numStripes = min((size_t)_numThreads, numBlocks);
+	size_t stripeLen = ((numBlocks + numStripes - 1) / numStripes) * BLOCK_DATA_SIZE;
+	const char *text = _text.data() + _textStart;
+	for (size_t i = 0; i < numStripes; i++) {
+		Stripe &stripe = _stripes[i];
+		size_t start = min(len, i * stripeLen);
+		stripe.data = text + start;
+		stripe.len = min(len - start, stripeLen);
+		stripe.dictLen = _format == GZIP ? min(DICT_SIZE, _textStart + start) : 0;
+		stripe.last = last && i == numStripes - 1;
+	}
+
+	if (numStripes == 1) {
+		compressStripe(_stripes[0]);
+	} else {
+		pthread_mutex_lock(&_lock);
+		_numStripes = (int)numStripes;
+		_numDone = 0;
+		_batch++;
+		pthread_cond_broadcast(&_startCond);
+		pthread_mutex_unlock(&_lock);
+
+		compressStripe(_stripes[0]);
+
+		pthread_mutex_lock(&_lock);
+		while (_numDone < (int)_threads.size()) {
+			pthread_cond_wait(&_doneCond, &_lock);
+		}
+		pthread_mutex_unlock(&_lock);
+	}
+
+	for (size_t i = 0; i < numStripes; i++) {
+		Stripe &stripe = _stripes[i];
+		if (_indexer != NULL) {
+			for (size_t j = 0; j < stripe.blockLens.size(); j++) {
+				_blockOffsets.push_back(_outLen);
+				_outLen += stripe.blockLens[j];
+			}
+		} else {
+			_outLen += stripe.outLen;
+		}
+		if (_format == GZIP) {
+			_crc = crc32_combine(_crc, stripe.crc, stripe.len);
+		}
+		fwrite(stripe.out.data(), 1, stripe.outLen, _out);
+	}
+	_textLen += len;
+
+	size_t end = _textStart + len;
+	size_t keepFrom = _format == GZIP ? end - min(end, DICT_SIZE) : end;
+	_text.erase(_text.begin(), _text.begin() + keepFrom);
+	_textStart = end - keepFrom;
+}
+
+void GzipWriter::compressStripe(Stripe &stripe)
+{
+	size_t numBlocks = (stripe.len + BLOCK_DATA_SIZE - 1) / BLOCK_DATA_SIZE;
+	if (stripe.last && _format == GZIP && numBlocks == 0) {
+		numBlocks = 1;
+	}
+	if (stripe.out.size() < numBlocks * MAX_BLOCK_SIZE) {
+		stripe.out.resize(numBlocks * MAX_BLOCK_SIZE);
+	}
+	stripe.outLen = 0;
+	stripe.blockLens.clear();
+	stripe.crc = crc32(0, NULL, 0);
+
+	size_t headerLen = _format == BGZF ? BLOCK_HEADER_SIZE : 0;
+	size_t footerLen = _format == BGZF ? BLOCK_FOOTER_SIZE : 0;
+	z_stream &zs = stripe.zs;
+	for (size_t i = 0; i < numBlocks; i++) {
+		size_t pos = i * BLOCK_DATA_SIZE;
+		size_t dataLen = min(BLOCK_DATA_SIZE, stripe.len - pos);
+		const char *data = stripe.data + pos;
+		char *block = &stripe.out[stripe.outLen];
+		//GZIP blocks end with a sync flush, to a byte boundary, except the last.
+		bool finish = _format == BGZF || (stripe.last && i == numBlocks - 1);
+
+		deflateReset(&zs);
+		if (_format == GZIP) {
+			size_t dictLen = min(DICT_SIZE, stripe.dictLen + pos);
+			if (dictLen > 0) {
+				deflateSetDictionary(&zs, (const Bytef *)(data - dictLen), (uInt)dictLen);
+			}
+		}
+		zs.next_in = (Bytef *)data;
+		zs.avail_in = (uInt)dataLen;
+		zs.next_out = (Bytef *)(block + headerLen);
+		zs.avail_out = (uInt)(MAX_BLOCK_SIZE - headerLen - footerLen);
+		int ret = deflate(&zs, finish ? Z_FINISH : Z_SYNC_FLUSH);
+		if (finish ? ret != Z_STREAM_END : (ret != Z_OK || zs.avail_out == 0)) {
+			cerr << "Error: compressed block too large. Exiting." << endl;
+			exit(1);
+		}
+		size_t blockSize = headerLen + zs.total_out + footerLen;
+		uint32_t crc = (uint32_t)crc32(crc32(0, NULL, 0), (const Bytef *)data, (uInt)dataLen);
+
+		if (_format == BGZF) {
+			memcpy(block, BLOCK_HEADER, BLOCK_HEADER_SIZE);
+			putLE16(block + 16, (uint32_t)(blockSize - 1));
+			char *footer = block + blockSize - BLOCK_FOOTER_SIZE;
+			putLE32(footer, crc);
+			putLE32(footer + 4, (uint32_t)dataLen);
+		} else {
+			stripe.crc = (uint32_t)crc32_combine(stripe.crc, crc, (z_off_t)dataLen);
+		}
+		stripe.outLen += blockSize;
+		stripe.blockLens.push_back(blockSize);
+	}
+}
+
+void GzipWriter::runWorker(int stripeIdx)
+{
+	uint64_t batch = 0;
+	pthread_mutex_lock(&_lock);
+	while (true) {
+		while (_batch == batch && !_quit) {
+			pthread_cond_wait(&_startCond, &_lock);
+		}
+		if (_quit) break;
+		batch = _batch;
+		bool hasStripe = stripeIdx < _numStripes;
+		pthread_mutex_unlock(&_lock);
+
+		if (hasStripe) {
+			compressStripe(_stripes[stripeIdx]);
+		}
+
+		pthread_mutex_lock(&_lock);
+		_numDone++;
+		pthread_cond_signal(&_doneCond);
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+void *GzipWriter::runWorkerThread(void *worker)
+{
+	Worker *w = static_cast<Worker *>(worker);
+	w->writer->runWorker(w->stripeIdx);
+	return NULL;
+}
@@ -0,0 +1,109 @@
+/*
+ * GzipWriter.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef GZIPWRITER_H_
+#define GZIPWRITER_H_
+
+#include <cstdio>
+#include <stdint.h>
+#include <vector>
+#include <pthread.h>
+#include <zlib.h>
+
+using namespace std;
+
+class TabixIndexer;
+
+// Writes gzip compressed text, in one of two formats:
+//
+// BGZF, the blocked gzip of bgzip, tabix and BAM files. It's a series of
+// gzip members, so any gzip reader can read it too. Each block holds at
+// most BLOCK_DATA_SIZE bytes of text, and carries its compressed size in
+// a "BC" extra field so readers can seek from block to block. An empty
+// block marks the end of the file.
+//
+// GZIP, a single gzip member, as gzip writes. Each block of text is
+// deflated with the 32 KB before it as its dictionary, and ends on a byte
+// boundary, so the blocks join up into one deflate stream. pigz does this.
+//
+// Text is held until there are whole blocks of it, so the blocks come out
+// the same whatever the sizes of the writes.
+class GzipWriter {
+public:
+	typedef enum { BGZF, GZIP } FORMAT;
+
+	//The blocks of each write are compressed by up to numThreads threads,
+	//which are started here and kept until the writer is destroyed.
+	GzipWriter(FILE *out, FORMAT format, int numThreads = 1);
+
+	//Compresses the text that's left, and writes the end of the file.
+	//With an indexer, the index is then written too.
+	~GzipWriter();
+
+	void write(const char *buf, size_t len);
+
+	//BGZF only. The text written is also indexed for tabix. The writer
+	//takes ownership of the indexer.
+	void setIndexer(TabixIndexer *indexer);
+
+	//the text in each block, kept small enough that a block of incompressible
+	//text is still under the 64 KB limit. This is bgzip's choice, too.
+	static const size_t BLOCK_DATA_SIZE = 0xff00;
+	static const size_t MAX_BLOCK_SIZE = 0x10000;
+
+private:
+	FILE *_out;
+	FORMAT _format;
+	int _numThreads;
+	TabixIndexer *_indexer;
+
+	//text not yet compressed starts at _textStart. With GZIP, it's
+	//preceded by the last DICT_SIZE bytes compressed, for dictionaries.
+	vector<char> _text;
+	size_t _textStart;
+	uint64_t _outLen; //the compressed bytes written so far.
+	vector<uint64_t> _blockOffsets; //with an indexer, where each block starts.
+	uint32_t _crc; //GZIP only, of all the text so far.
+	uint64_t _textLen;
+
+	static const size_t DICT_SIZE = 32768;
+
+	// a run of consecutive blocks, compressed by one thread.
+	struct Stripe {
+		const char *data;
+		size_t len;
+		size_t dictLen; //the bytes before data that GZIP blocks may refer to.
+		bool last; //the stripe with the end of the text.
+		vector<char> out;
+		size_t outLen;
+		vector<size_t> blockLens;
+		uint32_t crc;
+		z_stream zs;
+	};
+	vector<Stripe> _stripes;
+
+	//The workers take stripes 1 on, while the writing thread does stripe 0.
+	struct Worker {
+		GzipWriter *writer;
+		int stripeIdx;
+	};
+	vector<Worker> _workers;
+	vector<pthread_t> _threads;
+	pthread_mutex_t _lock;
+	pthread_cond_t _startCond;
+	pthread_cond_t _doneCond;
+	uint64_t _batch; //counts the batches handed to the workers.
+	int _numStripes; //in the current batch.
+	int _numDone;
+	bool _quit;
+
+	void compressText(bool last);
+	void compressStripe(Stripe &stripe);
+	void runWorker(int stripeIdx);
+	static void *runWorkerThread(void *worker);
+};
+
+#endif /* GZIPWRITER_H_ */
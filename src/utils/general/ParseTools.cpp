@@ -5,6 +5,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <cmath>
 
 //This functions recognizes only numbers with digits, plus sign, minus sign, decimal point, e, or E. Hexadecimal and pointers not currently supported.
 bool isNumeric(const QuickString &str) {
@@ -30,6 +31,19 @@ bool isInteger(const QuickString &str) {
 
 
 
+int parseNumThreads(const char *str) {
+	size_t len = strlen(str);
+	if (len == 0 || len > 9) {
+		return 0;
+	}
+	for (size_t i = 0; i < len; i++) {
+		if (!isdigit(str[i])) {
+			return 0;
+		}
+	}
+	return atoi(str);
+}
+
 int str2chrPos(const QuickString &str) {
 	return str2chrPos(str.c_str(), str.size());
 }
@@ -128,6 +142,160 @@ string vectorIntToStr(const vector<int> &vec) {
 	return str;
 }
 
+//the powers of ten a double holds exactly.
+static const double EXACT_POWERS_OF_TEN[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const int MAX_EXACT_POWER_OF_TEN = 22;
+
+//the most digits a double holds exactly.
+static const int MAX_FAST_DIGITS = 15;
+
+//Sets result to the nearest integer to val * 10^scale, where val is not
+//negative, as printf would round it from val's exact value. Returns false
+//when the double product is too close to halfway between two integers for
+//that to be sure, or is too large to hold exactly.
+static bool scaleAndRound(double val, int scale, uint64_t &result) {
+	if (scale > MAX_EXACT_POWER_OF_TEN || scale < -MAX_EXACT_POWER_OF_TEN) {
+		return false;
+	}
+	double scaled = scale >= 0 ? val * EXACT_POWERS_OF_TEN[scale] : val / EXACT_POWERS_OF_TEN[-scale];
+	if (!(scaled < EXACT_POWERS_OF_TEN[MAX_FAST_DIGITS + 1])) {
+		return false;
+	}
+	//scaled is off from the exact product by at most half a unit in its last
+	//place, so only a fraction within that of one half could round either way.
+	double whole = floor(scaled);
+	double frac = scaled - whole;
+	if (fabs(frac - 0.5) <= scaled * numeric_limits<double>::epsilon()) {
+		return false;
+	}
+	result = (uint64_t)whole + (frac > 0.5 ? 1 : 0);
+	return true;
+}
+
+//writes exactly numDigits digits of num, zero padded, ending just before end.
+static void writeDigits(uint64_t num, int numDigits, char *end) {
+	for (int i=0; i < numDigits; i++) {
+		*--end = (num % 10) + '0';
+		num /= 10;
+	}
+}
+
+static void appendPrintf(QuickString &buffer, const char *format, int precision, double number) {
+	char tmpBuffer[64];
+	int len = snprintf(tmpBuffer, sizeof(tmpBuffer), format, precision, number);
+	if (len < (int)sizeof(tmpBuffer)) {
+		buffer.append(tmpBuffer, len);
+		return;
+	}
+	vector<char> bigBuffer(len + 1);
+	snprintf(&bigBuffer[0], bigBuffer.size(), format, precision, number);
+	buffer.append(&bigBuffer[0], len);
+}
+
+void double2str(double number, QuickString &buffer, int precision, bool appendToBuf) {
+	if (!appendToBuf) {
+		buffer.clear();
+	}
+	int numDigits = precision == 0 ? 1 : precision;
+	if (number != number || fabs(number) > numeric_limits<double>::max() || numDigits > MAX_FAST_DIGITS) {
+		//nan, inf, or more digits than we can get right.
+		appendPrintf(buffer, "%.*g", precision, number);
+		return;
+	}
+	if (number == 0.0) {
+		buffer.append(signbit(number) ? "-0" : "0");
+		return;
+	}
+
+	//find the digits, and the exponent of the first, after rounding. The log
+	//may be off by one either way near a power of ten, so adjust for that.
+	double absVal = fabs(number);
+	int exponent = (int)floor(log10(absVal));
+	uint64_t digits = 0;
+	int tries = 0;
+	while (true) {
+		if (tries++ == 3 || !scaleAndRound(absVal, numDigits - 1 - exponent, digits)) {
+			appendPrintf(buffer, "%.*g", precision, number);
+			return;
+		}
+		if (digits >= (uint64_t)EXACT_POWERS_OF_TEN[numDigits]) {
+			exponent++;
+		} else if (digits < (uint64_t)EXACT_POWERS_OF_TEN[numDigits - 1]) {
+			exponent--;
+		} else {
+			break;
+		}
+	}
+
+	char digitBuf[MAX_FAST_DIGITS];
+	writeDigits(digits, numDigits, digitBuf + numDigits);
+	int numSigDigits = numDigits;
+	while (numSigDigits > 1 && digitBuf[numSigDigits - 1] == '0') {
+		numSigDigits--; //%g drops trailing zeros.
+	}
+
+	if (number < 0) {
+		buffer.append('-');
+	}
+	if (exponent < -4 || exponent >= numDigits) {
+		buffer.append(digitBuf[0]);
+		if (numSigDigits > 1) {
+			buffer.append('.');
+			buffer.append(digitBuf + 1, numSigDigits - 1);
+		}
+		buffer.append(exponent < 0 ? "e-" : "e+");
+		int absExponent = exponent < 0 ? -exponent : exponent;
+		if (absExponent < 10) {
+			buffer.append('0');
+		}
+		int2str(absExponent, buffer, true);
+	} else if (exponent >= 0) {
+		buffer.append(digitBuf, exponent + 1);
+		if (numSigDigits > exponent + 1) {
+			buffer.append('.');
+			buffer.append(digitBuf + exponent + 1, numSigDigits - exponent - 1);
+		}
+	} else {
+		buffer.append("0.");
+		for (int i = exponent + 1; i < 0; i++) {
+			buffer.append('0');
+		}
+		buffer.append(digitBuf, numSigDigits);
+	}
+}
+
+void fixed2str(double number, QuickString &buffer, int precision, bool appendToBuf) {
+	if (!appendToBuf) {
+		buffer.clear();
+	}
+	uint64_t digits = 0;
+	if (number != number || precision > MAX_FAST_DIGITS || !scaleAndRound(fabs(number), precision, digits)) {
+		appendPrintf(buffer, "%.*f", precision, number);
+		return;
+	}
+
+	//at most MAX_FAST_DIGITS + 1 digits, and a leading zero, a point and a sign.
+	char tmpBuffer[MAX_FAST_DIGITS + 4];
+	char *end = &tmpBuffer[sizeof tmpBuffer];
+	char *start = end - precision;
+	writeDigits(digits, precision, end);
+	uint64_t wholePart = digits / (uint64_t)EXACT_POWERS_OF_TEN[precision];
+	if (precision > 0) {
+		*--start = '.';
+	}
+	do {
+		*--start = (wholePart % 10) + '0';
+		wholePart /= 10;
+	} while (wholePart > 0);
+	if (signbit(number)) {
+		*--start = '-';
+	}
+	buffer.append(start, end - start);
+}
+
 bool isHeaderLine(const QuickString &line) {
 	if (line[0] == '>') {
 		return true;
@@ -21,6 +21,10 @@ using namespace std;
 bool isNumeric(const QuickString &str);
 bool isInteger(const QuickString &str);
 
+//The value of a -threads option, which must be a whole number above zero.
+//Anything else gives 0.
+int parseNumThreads(const char *str);
+
 //This method is a faster version of atoi, but is limited to a maximum of
 //9 digit numbers in Base 10 only. The string may begin with a negative.
 //Empty strings, too long strings, or strings containing anything other than
@@ -75,6 +79,14 @@ void int2str(int number, T& buffer, bool appendToBuf = false)
 
 }
 
+//double2str and fixed2str are the same idea for floating point: they give
+//exactly what printf's "%.*g" and "%.*f" formats would (ignoring locale),
+//but build the digits themselves rather than going through printf or a
+//stringstream. The rare values whose rounding can't be settled from a
+//double's precision are still handed to snprintf.
+void double2str(double number, QuickString &buffer, int precision = 6, bool appendToBuf = false);
+void fixed2str(double number, QuickString &buffer, int precision = 6, bool appendToBuf = false);
+
 bool isHeaderLine(const QuickString &line);
 
 string vectorIntToStr(const vector<int> &vec);
@@ -2,6 +2,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
+#include <algorithm>
 #include "ParseTools.h"
 #include "lineFileUtilities.h"
 
@@ -54,12 +55,19 @@ QuickString::QuickString(char c)
 }
 
 void QuickString::build() {
-	_buffer = (char *)malloc(_currCapacity);
+	if (_currCapacity <= LOCAL_CAPACITY) {
+		_currCapacity = LOCAL_CAPACITY;
+		_buffer = _localBuffer;
+	} else {
+		_buffer = (char *)malloc(_currCapacity);
+	}
 	clear();
 }
 
 QuickString::~QuickString(){
-	free(_buffer);
+	if (!isLocal()) {
+		free(_buffer);
+	}
 }
 
 void QuickString::clear() {
@@ -68,11 +76,33 @@ void QuickString::clear() {
 }
 
 void QuickString::release() {
-	free(_buffer);
+	if (!isLocal()) {
+		free(_buffer);
+	}
 	_currCapacity = DEFAULT_CAPACITY;
 	build();
 }
 
+void QuickString::swap(QuickString &other) {
+	if (this == &other) {
+		return;
+	}
+	bool wasLocal = isLocal();
+	bool otherWasLocal = other.isLocal();
+	std::swap(_buffer, other._buffer);
+	std::swap(_currCapacity, other._currCapacity);
+	std::swap(_currSize, other._currSize);
+	if (wasLocal || otherWasLocal) {
+		//a local buffer can't be handed over, so its contents change places instead.
+		char tmp[LOCAL_CAPACITY];
+		memcpy(tmp, _localBuffer, LOCAL_CAPACITY);
+		memcpy(_localBuffer, other._localBuffer, LOCAL_CAPACITY);
+		memcpy(other._localBuffer, tmp, LOCAL_CAPACITY);
+		if (otherWasLocal) _buffer = _localBuffer;
+		if (wasLocal) other._buffer = other._localBuffer;
+	}
+}
+
 QuickString &QuickString::operator = (const char *inBuf){
 	set(inBuf, strlen(inBuf));
 	return *this;
@@ -222,12 +252,15 @@ bool QuickString::operator != (const QuickString &qs) const {
 	return !(*this == qs);
 }
 
+//compare the bytes both strings have, so neither buffer is read past its
+//end. A string that's a prefix of the other comes first.
 bool QuickString::operator < (const QuickString &qs) const {
-	return (memcmp(_buffer, qs._buffer, max(_currSize, qs._currSize)) < 0);
+	int cmp = memcmp(_buffer, qs._buffer, min(_currSize, qs._currSize));
+	return cmp < 0 || (cmp == 0 && _currSize < qs._currSize);
 }
 
 bool QuickString::operator > (const QuickString &qs) const {
-	return (memcmp(_buffer, qs._buffer, max(_currSize, qs._currSize))> 0);
+	return qs < *this;
 }
 
 void QuickString::set(const char *inBuf, size_t newLen) {
@@ -243,7 +276,14 @@ void QuickString::reserve(size_t newLen) {
 		while (_currCapacity <= newLen) {
 			_currCapacity = _currCapacity << 1;
 		}
-		_buffer = (char *)realloc(_buffer, _currCapacity );
+		if (isLocal()) {
+			_buffer = (char *)malloc(_currCapacity);
+			if (_buffer != NULL) {
+				memcpy(_buffer, _localBuffer, _currSize);
+			}
+		} else {
+			_buffer = (char *)realloc(_buffer, _currCapacity );
+		}
 		if (_buffer == NULL) {
 			fprintf(stderr, "Error: failed to reallocate string.\n");
 			_currSize = 0;
@@ -282,11 +322,11 @@ void QuickString::append(uint32_t num) {
 // }
 
 void QuickString::append(float num) {
-	append(ToString(num));
+	append((double)num);
 }
 
 void QuickString::append(double num) {
-	append(ToString(num));
+	double2str(num, *this, 6, true);
 }
 
 
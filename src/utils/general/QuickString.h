@@ -32,6 +32,7 @@ public:
 
 	void clear(); //only clears buffer, doesn't delete it.
 	void release(); //will deallocate current buffer, reallocate it at default size.
+	void swap(QuickString &other); //exchanges buffers, without copying either.
 	QuickString &operator = (const string &);
 	QuickString &operator = (const char *);
 	QuickString &operator = (const QuickString &);
@@ -69,9 +70,9 @@ public:
 	void append(const char *buf, size_t bufLen);
 	void append(char c);
 
-	//These are not templated because float and double require a stringstream based
-	//implementation, while the integer append uses a much faster home-brewed algorithm
-	//for better performance.
+	//These are not templated because float and double are formatted as
+	//printf's %g does (see double2str in ParseTools), while the integer
+	//append uses a much faster home-brewed algorithm for better performance.
 	void append(int num);
 	void append(uint32_t num);
 	//void append(size_t num);
@@ -85,11 +86,18 @@ public:
 	void substr(QuickString &newStr, size_t pos = 0, size_t len = UINT_MAX) const;
 
 private:
+	static const int DEFAULT_CAPACITY = 8;
+
+	//strings this short, such as most chrom names, strands and scores, are
+	//kept in _localBuffer rather than on the heap.
+	static const int LOCAL_CAPACITY = 16;
+
 	char *_buffer;
 	size_t _currCapacity;
 	size_t _currSize;
+	char _localBuffer[LOCAL_CAPACITY];
 
-	static const int DEFAULT_CAPACITY = 8;
+	bool isLocal() const { return _buffer == _localBuffer; }
 	void build();
 	void set(const char *len, size_t size);
 };
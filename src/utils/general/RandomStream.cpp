@@ -0,0 +1,64 @@
+/*
+ * RandomStream.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "RandomStream.h"
+
+RandomStream::RandomStream(uint64_t seed, uint64_t stream)
+{
+	reset(seed, stream);
+}
+
+void RandomStream::reset(uint64_t seed, uint64_t stream)
+{
+	_key[0] = (uint32_t)seed;
+	_key[1] = (uint32_t)(seed >> 32);
+	_stream = stream;
+	_pos = 0;
+}
+
+uint64_t RandomStream::below(uint64_t n)
+{
+	//reject the few values that would make the low end of the
+	//range more likely than the high end.
+	uint64_t threshold = (0 - n) % n;
+	while (1) {
+		uint64_t val = next();
+		if (val >= threshold) {
+			return val % n;
+		}
+	}
+}
+
+void RandomStream::philox(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4])
+{
+	uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+	uint32_t k0 = key[0], k1 = key[1];
+	for (int round = 0; round < 10; round++) {
+		uint64_t prod0 = (uint64_t)0xD2511F53 * c0;
+		uint64_t prod1 = (uint64_t)0xCD9E8D57 * c2;
+		c0 = (uint32_t)(prod1 >> 32) ^ c1 ^ k0;
+		c1 = (uint32_t)prod1;
+		c2 = (uint32_t)(prod0 >> 32) ^ c3 ^ k1;
+		c3 = (uint32_t)prod0;
+		k0 += 0x9E3779B9;
+		k1 += 0xBB67AE85;
+	}
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
+}
+
+void RandomStream::generate(uint64_t block)
+{
+	//the counter is the block number, then the stream.
+	uint32_t ctr[4] = { (uint32_t)block, (uint32_t)(block >> 32),
+						(uint32_t)_stream, (uint32_t)(_stream >> 32) };
+	uint32_t out[4];
+	philox(ctr, _key, out);
+	_out[0] = ((uint64_t)out[1] << 32) | out[0];
+	_out[1] = ((uint64_t)out[3] << 32) | out[2];
+}
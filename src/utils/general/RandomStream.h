@@ -0,0 +1,54 @@
+/*
+ * RandomStream.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef RANDOMSTREAM_H_
+#define RANDOMSTREAM_H_
+
+#include <stdint.h>
+
+//Counter-based random numbers (Philox4x32-10, Salmon et al., SC 2011).
+//Output n of stream s for a given seed is a pure function of
+//(seed, s, n), so every thread, chromosome or block of work can have
+//a stream of its own, and a seed gives the same numbers with any libc
+//and any number of threads.
+class RandomStream {
+public:
+	RandomStream(uint64_t seed = 0, uint64_t stream = 0);
+
+	void reset(uint64_t seed, uint64_t stream);
+
+	//64 random bits.
+	uint64_t next() {
+		//each block of the counter gives two outputs.
+		if ((_pos & 1) == 0) {
+			generate(_pos >> 1);
+		}
+		return _out[_pos++ & 1];
+	}
+
+	//uniform in [0, n). n must be positive.
+	uint64_t below(uint64_t n);
+
+	//uniform in [0, 1).
+	double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+	//uniform in (0, 1), so it's safe to take the log of.
+	double uniformPositive() { return ((next() >> 11) + 0.5) * (1.0 / 9007199254740992.0); }
+
+private:
+	uint32_t _key[2];
+	uint64_t _stream;
+	uint64_t _pos; //index of the next output in the stream.
+	uint64_t _out[2];
+
+	void generate(uint64_t block);
+
+	//raw Philox4x32-10 of a counter under a key.
+	static void philox(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]);
+};
+
+
+#endif /* RANDOMSTREAM_H_ */
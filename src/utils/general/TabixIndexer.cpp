@@ -0,0 +1,345 @@
+/*
+ * TabixIndexer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "TabixIndexer.h"
+#include "GzipWriter.h"
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+
+static void appendLE32(QuickString &buf, uint32_t val)
+{
+	for (int i = 0; i < 4; i++) {
+		buf.append((char)((val >> (8 * i)) & 0xff));
+	}
+}
+
+static void appendLE64(QuickString &buf, uint64_t val)
+{
+	appendLE32(buf, (uint32_t)(val & 0xffffffff));
+	appendLE32(buf, (uint32_t)(val >> 32));
+}
+
+// finds field idx (0-based) of a line, which has no newline.
+static bool getField(const char *line, size_t len, int idx, const char *&field, size_t &fieldLen)
+{
+	const char *end = line + len;
+	const char *pos = line;
+	for (int i = 0; i < idx; i++) {
+		pos = (const char *)memchr(pos, '\t', end - pos);
+		if (pos == NULL) return false;
+		pos++;
+	}
+	const char *tab = (const char *)memchr(pos, '\t', end - pos);
+	field = pos;
+	fieldLen = (tab == NULL ? end : tab) - pos;
+	return true;
+}
+
+static bool parsePos(const char *field, size_t len, CHRPOS &pos)
+{
+	if (len == 0) return false;
+	uint64_t val = 0;
+	for (size_t i = 0; i < len; i++) {
+		if (field[i] < '0' || field[i] > '9') return false;
+		val = val * 10 + (field[i] - '0');
+		if (val > 0xffffffff) return false;
+	}
+	pos = (CHRPOS)val;
+	return true;
+}
+
+const uint64_t TabixIndexer::NO_OFFSET;
+
+TabixIndexer::TabixIndexer(const QuickString &filename, PRESET preset)
+: _filename(filename),
+  _preset(preset),
+  _offset(0),
+  _lineNum(0),
+  _lastStart(0)
+{
+}
+
+bool TabixIndexer::parsePreset(const QuickString &name, PRESET &preset)
+{
+	if (name == "bed") {
+		preset = BED;
+	} else if (name == "gff") {
+		preset = GFF;
+	} else if (name == "vcf") {
+		preset = VCF;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void TabixIndexer::addText(const char *buf, size_t len)
+{
+	const char *pos = buf;
+	const char *end = buf + len;
+	while (pos < end) {
+		const char *newline = (const char *)memchr(pos, '\n', end - pos);
+		if (newline == NULL) {
+			_partLine.append(pos, end - pos);
+			_offset += end - pos;
+			return;
+		}
+		size_t lineLen = newline + 1 - pos;
+		if (_partLine.empty()) {
+			addLine(pos, lineLen, _offset);
+		} else {
+			uint64_t lineStart = _offset - _partLine.size();
+			_partLine.append(pos, lineLen);
+			addLine(_partLine.c_str(), _partLine.size(), lineStart);
+			_partLine.clear();
+		}
+		_offset += lineLen;
+		pos = newline + 1;
+	}
+}
+
+void TabixIndexer::addLine(const char *line, size_t len, uint64_t offset)
+{
+	_lineNum++;
+	//the text spans the whole line, but the fields end before the newline.
+	size_t textLen = len;
+	while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+		len--;
+	}
+	if (len == 0 || line[0] == '#') return;
+
+	const char *tab = (const char *)memchr(line, '\t', len);
+	if (tab == NULL) {
+		lineError(line, len, "has only one column");
+	}
+	size_t chromLen = tab - line;
+	CHRPOS start = 0, end = 0;
+	if (!parseCoords(line, len, start, end)) {
+		lineError(line, len, "has no valid start and end");
+	}
+
+	if (_chroms.empty() || _chromNames.back().size() != chromLen ||
+			memcmp(_chromNames.back().c_str(), line, chromLen) != 0) {
+		QuickString name;
+		name.append(line, chromLen);
+		if (_chromIds.find(name) != _chromIds.end()) {
+			lineError(line, len, "is not grouped with the others on its chrom");
+		}
+		_chromIds[name] = (int)_chromNames.size();
+		_chromNames.push_back(name);
+		_chroms.resize(_chroms.size() + 1);
+		_chroms.back().numLines = 0;
+	} else if (start < _lastStart) {
+		lineError(line, len, "is not sorted by start");
+	}
+	_lastStart = start;
+	if (end > MAX_POS) {
+		lineError(line, len, "ends past 2^29, the most a tabix index can hold");
+	}
+	//tabix gives an empty interval the base after it.
+	if (end <= start) {
+		end = start + 1;
+	}
+
+	ChromIndex &chromIdx = _chroms.back();
+	vector<Chunk> &chunks = chromIdx.bins[regionToBin(start, end)];
+	if (!chunks.empty() && chunks.back().end == offset) {
+		chunks.back().end = offset + textLen;
+	} else {
+		Chunk chunk;
+		chunk.beg = offset;
+		chunk.end = offset + textLen;
+		chunks.push_back(chunk);
+	}
+
+	size_t lastWindow = (end - 1) >> LINEAR_SHIFT;
+	if (chromIdx.linear.size() <= lastWindow) {
+		chromIdx.linear.resize(lastWindow + 1, NO_OFFSET);
+	}
+	for (size_t i = start >> LINEAR_SHIFT; i <= lastWindow; i++) {
+		if (chromIdx.linear[i] == NO_OFFSET) {
+			chromIdx.linear[i] = offset;
+		}
+	}
+
+	if (chromIdx.numLines == 0) {
+		chromIdx.beg = offset;
+	}
+	chromIdx.end = offset + textLen;
+	chromIdx.numLines++;
+}
+
+bool TabixIndexer::parseCoords(const char *line, size_t len, CHRPOS &start, CHRPOS &end)
+{
+	const char *field = NULL;
+	size_t fieldLen = 0;
+	switch (_preset) {
+	case BED:
+		return getField(line, len, 1, field, fieldLen) && parsePos(field, fieldLen, start) &&
+				getField(line, len, 2, field, fieldLen) && parsePos(field, fieldLen, end);
+
+	case GFF:
+		if (!getField(line, len, 3, field, fieldLen) || !parsePos(field, fieldLen, start) || start == 0) return false;
+		start--;
+		return getField(line, len, 4, field, fieldLen) && parsePos(field, fieldLen, end);
+
+	case VCF:
+	{
+		if (!getField(line, len, 1, field, fieldLen) || !parsePos(field, fieldLen, start) || start == 0) return false;
+		start--;
+		//the REF allele gives the end, unless the INFO field has an END.
+		if (!getField(line, len, 3, field, fieldLen)) return false;
+		end = start + (CHRPOS)fieldLen;
+		if (getField(line, len, 7, field, fieldLen)) {
+			const char *info = field;
+			const char *infoEnd = field + fieldLen;
+			while (info < infoEnd) {
+				const char *semi = (const char *)memchr(info, ';', infoEnd - info);
+				const char *next = semi == NULL ? infoEnd : semi;
+				CHRPOS infoPos = 0;
+				if (next - info > 4 && memcmp(info, "END=", 4) == 0 &&
+						parsePos(info + 4, next - info - 4, infoPos)) {
+					end = infoPos;
+					break;
+				}
+				info = next + 1;
+			}
+		}
+		return true;
+	}
+	}
+	return false;
+}
+
+void TabixIndexer::lineError(const char *line, size_t len, const char *msg)
+{
+	cerr << "Error: output line " << _lineNum << " " << msg
+		 << ", so it can't be indexed with -tbi:" << endl;
+	cerr.write(line, len);
+	cerr << endl;
+	exit(1);
+}
+
+uint32_t TabixIndexer::regionToBin(CHRPOS start, CHRPOS end)
+{
+	//the binning scheme of tabix and BAM indexes, for [start, end).
+	--end;
+	if (start >> 14 == end >> 14) return ((1 << 15) - 1) / 7 + (start >> 14);
+	if (start >> 17 == end >> 17) return ((1 << 12) - 1) / 7 + (start >> 17);
+	if (start >> 20 == end >> 20) return ((1 << 9) - 1) / 7 + (start >> 20);
+	if (start >> 23 == end >> 23) return ((1 << 6) - 1) / 7 + (start >> 23);
+	if (start >> 26 == end >> 26) return ((1 << 3) - 1) / 7 + (start >> 26);
+	return 0;
+}
+
+uint64_t TabixIndexer::virtualOffset(uint64_t offset, const vector<uint64_t> &blockOffsets, size_t blockDataSize)
+{
+	return (blockOffsets[offset / blockDataSize] << 16) | (offset % blockDataSize);
+}
+
+void TabixIndexer::write(const vector<uint64_t> &blockOffsets, size_t blockDataSize)
+{
+	//a last line with no newline still gets indexed.
+	if (!_partLine.empty()) {
+		addLine(_partLine.c_str(), _partLine.size(), _offset - _partLine.size());
+		_partLine.clear();
+	}
+
+	QuickString buf;
+	buf.append("TBI\1", 4);
+	appendLE32(buf, (uint32_t)_chroms.size());
+	//the format, and the 1-based columns of the chrom, start and end.
+	switch (_preset) {
+	case BED:
+		appendLE32(buf, 0x10000); //generic, with 0-based starts.
+		appendLE32(buf, 1);
+		appendLE32(buf, 2);
+		appendLE32(buf, 3);
+		break;
+	case GFF:
+		appendLE32(buf, 0);
+		appendLE32(buf, 1);
+		appendLE32(buf, 4);
+		appendLE32(buf, 5);
+		break;
+	case VCF:
+		appendLE32(buf, 2);
+		appendLE32(buf, 1);
+		appendLE32(buf, 2);
+		appendLE32(buf, 0);
+		break;
+	}
+	appendLE32(buf, '#'); //the header line marker.
+	appendLE32(buf, 0); //the lines to skip.
+
+	uint32_t namesLen = 0;
+	for (size_t i = 0; i < _chromNames.size(); i++) {
+		namesLen += _chromNames[i].size() + 1;
+	}
+	appendLE32(buf, namesLen);
+	for (size_t i = 0; i < _chromNames.size(); i++) {
+		buf.append(_chromNames[i].c_str(), _chromNames[i].size() + 1);
+	}
+
+	for (size_t i = 0; i < _chroms.size(); i++) {
+		ChromIndex &chromIdx = _chroms[i];
+		appendLE32(buf, (uint32_t)chromIdx.bins.size() + 1);
+		for (binMapType::iterator iter = chromIdx.bins.begin(); iter != chromIdx.bins.end(); ++iter) {
+			//chunks that meet in a block are read together anyway, so join them.
+			vector<Chunk> &chunks = iter->second;
+			size_t numChunks = 0;
+			for (size_t j = 0; j < chunks.size(); j++) {
+				Chunk chunk;
+				chunk.beg = virtualOffset(chunks[j].beg, blockOffsets, blockDataSize);
+				chunk.end = virtualOffset(chunks[j].end, blockOffsets, blockDataSize);
+				if (numChunks > 0 && chunks[numChunks - 1].end >> 16 >= chunk.beg >> 16) {
+					chunks[numChunks - 1].end = chunk.end;
+				} else {
+					chunks[numChunks++] = chunk;
+				}
+			}
+			appendLE32(buf, iter->first);
+			appendLE32(buf, (uint32_t)numChunks);
+			for (size_t j = 0; j < numChunks; j++) {
+				appendLE64(buf, chunks[j].beg);
+				appendLE64(buf, chunks[j].end);
+			}
+		}
+		//htslib's pseudo-bin, with the chrom's span and number of lines.
+		appendLE32(buf, META_BIN);
+		appendLE32(buf, 2);
+		appendLE64(buf, virtualOffset(chromIdx.beg, blockOffsets, blockDataSize));
+		appendLE64(buf, virtualOffset(chromIdx.end, blockOffsets, blockDataSize));
+		appendLE64(buf, chromIdx.numLines);
+		appendLE64(buf, 0);
+
+		//windows no line overlaps take the offset of the window before.
+		appendLE32(buf, (uint32_t)chromIdx.linear.size());
+		uint64_t prevOffset = virtualOffset(chromIdx.beg, blockOffsets, blockDataSize);
+		for (size_t j = 0; j < chromIdx.linear.size(); j++) {
+			if (chromIdx.linear[j] != NO_OFFSET) {
+				prevOffset = virtualOffset(chromIdx.linear[j], blockOffsets, blockDataSize);
+			}
+			appendLE64(buf, prevOffset);
+		}
+	}
+	appendLE64(buf, 0); //the lines with no coordinates.
+
+	FILE *fp = fopen(_filename.c_str(), "wb");
+	if (fp == NULL) {
+		cerr << "Error: Unable to open index file " << _filename << ". Exiting." << endl;
+		exit(1);
+	}
+	GzipWriter *writer = new GzipWriter(fp, GzipWriter::BGZF);
+	writer->write(buf.c_str(), buf.size());
+	delete writer;
+	if (fclose(fp) != 0) {
+		cerr << "Error: Unable to write index file " << _filename << ". Exiting." << endl;
+		exit(1);
+	}
+}
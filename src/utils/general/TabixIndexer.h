@@ -0,0 +1,81 @@
+/*
+ * TabixIndexer.h
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef TABIXINDEXER_H_
+#define TABIXINDEXER_H_
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "BedtoolsTypes.h"
+
+using namespace std;
+
+// Builds a tabix index (.tbi) of BGZF text while it's written, so the
+// output can be queried by region without running tabix on it.
+//
+// The text is indexed by its uncompressed offsets as it goes by, and
+// those are turned into BGZF virtual offsets once the blocks are written.
+// Lines must be grouped by chrom, and sorted by start within each chrom.
+// Lines starting with '#' are headers, and aren't indexed.
+class TabixIndexer {
+public:
+	//which columns hold the chrom, start and end, as tabix's -p.
+	typedef enum { BED, GFF, VCF } PRESET;
+
+	TabixIndexer(const QuickString &filename, PRESET preset);
+
+	//Indexes the next text written. Lines may be split between calls.
+	void addText(const char *buf, size_t len);
+
+	//Writes the index. Block i of the BGZF file starts at blockOffsets[i]
+	//and holds blockDataSize bytes of text; the last offset is the end.
+	void write(const vector<uint64_t> &blockOffsets, size_t blockDataSize);
+
+	//Sets the preset named by bed, gff or vcf.
+	static bool parsePreset(const QuickString &name, PRESET &preset);
+
+private:
+	// text from beg up to end, uncompressed offsets until the index is written.
+	struct Chunk {
+		uint64_t beg;
+		uint64_t end;
+	};
+	typedef map<uint32_t, vector<Chunk> > binMapType;
+
+	struct ChromIndex {
+		binMapType bins;
+		//the first text overlapping each 16 KB window, or NO_OFFSET.
+		vector<uint64_t> linear;
+		uint64_t beg; //the span of the chrom's lines.
+		uint64_t end;
+		uint64_t numLines;
+	};
+
+	QuickString _filename;
+	PRESET _preset;
+	vector<QuickString> _chromNames;
+	map<QuickString, int> _chromIds;
+	vector<ChromIndex> _chroms;
+
+	QuickString _partLine; //the start of a line split between calls.
+	uint64_t _offset; //of the next text to be added.
+	uint64_t _lineNum;
+	CHRPOS _lastStart;
+
+	static const int LINEAR_SHIFT = 14;
+	static const uint32_t MAX_POS = 1 << 29;
+	static const uint32_t META_BIN = 37450;
+	static const uint64_t NO_OFFSET = (uint64_t)-1;
+
+	void addLine(const char *line, size_t len, uint64_t offset);
+	bool parseCoords(const char *line, size_t len, CHRPOS &start, CHRPOS &end);
+	void lineError(const char *line, size_t len, const char *msg);
+	static uint32_t regionToBin(CHRPOS start, CHRPOS end);
+	static uint64_t virtualOffset(uint64_t offset, const vector<uint64_t> &blockOffsets, size_t blockDataSize);
+};
+
+#endif /* TABIXINDEXER_H_ */
@@ -40,6 +40,7 @@ BedWindow::BedWindow(string bedAFile, string bedBFile, int leftSlop, int rightSl
 
     _bedA          = new BedFile(bedAFile);
     _bedB          = new BedFile(bedBFile);
+    _bIndex        = NULL;
 
     if (_bamInput == false)
         WindowIntersectBed();
@@ -53,11 +54,12 @@ BedWindow::BedWindow(string bedAFile, string bedBFile, int leftSlop, int rightSl
     Destructor
 */
 BedWindow::~BedWindow(void) {
+    delete _bIndex;
 }
 
 
 
-void BedWindow::FindWindowOverlaps(const BED &a, vector<BED> &hits) {
+void BedWindow::FindWindowOverlaps(const BED &a, vector<size_t> &hits) {
 
     /*
         Adjust the start and end of a based on the requested window
@@ -73,18 +75,17 @@ void BedWindow::FindWindowOverlaps(const BED &a, vector<BED> &hits) {
         Now report the hits (if any) based on the window around a.
     */
     // get the hits in B for the A feature
-    _bedB->allHits(a.chrom, aFudgeStart, aFudgeEnd, a.strand, hits, 
-                   _matchOnSameStrand, _matchOnDiffStrand, 0.0, false);
+    _bIndex->allHits(a.chrom, aFudgeStart, aFudgeEnd, a.strand, hits, 
+                     _matchOnSameStrand, _matchOnDiffStrand, 0.0, false);
 
     int numOverlaps = 0;
 
     // loop through the hits and report those that meet the user's criteria
-    vector<BED>::const_iterator h = hits.begin();
-    vector<BED>::const_iterator hitsEnd = hits.end();
-    for (; h != hitsEnd; ++h) {
+    for (size_t i = 0; i < hits.size(); ++i) {
+        const BED &h = _bIndex->Get(hits[i]);
 
-        int s = max(aFudgeStart, h->start);
-        int e = min(aFudgeEnd, h->end);
+        int s = max(aFudgeStart, h.start);
+        int e = min(aFudgeEnd, h.end);
         int overlapBases = (e - s);             // the number of overlapping bases b/w a and b
         int aLength = (a.end - a.start);        // the length of a in b.p.
 
@@ -94,7 +95,7 @@ void BedWindow::FindWindowOverlaps(const BED &a, vector<BED> &hits) {
                 numOverlaps++;
                 if (_anyHit == false && _noHit == false && _writeCount == false) {
                     _bedA->reportBedTab(a);
-                    _bedB->reportBedNewLine(*h);
+                    _bedB->reportBedNewLine(h);
                 }
             }
         }
@@ -118,20 +119,20 @@ bool BedWindow::FindOneOrMoreWindowOverlaps(const BED &a) {
     CHRPOS aFudgeEnd;
     AddWindow(a, aFudgeStart, aFudgeEnd);
 
-    bool overlapsFound = _bedB->anyHits(a.chrom, a.start, a.end, a.strand, 
-                                        _matchOnSameStrand, _matchOnDiffStrand, 0.0, false);
+    bool overlapsFound = _bIndex->anyHits(a.chrom, a.start, a.end, a.strand, 
+                                          _matchOnSameStrand, _matchOnDiffStrand, 0.0, false);
     return overlapsFound;
 }
 
 
 void BedWindow::WindowIntersectBed() {
 
-    // load the "B" bed file into a map so
+    // load the "B" bed file into an index so
     // that we can easily compare "A" to it for overlaps
-    _bedB->loadBedFileIntoMap();
+    _bIndex = new BedIndex(_bedB);
 
     BED a;
-    vector<BED> hits;
+    vector<size_t> hits;
     hits.reserve(100);
 
     _bedA->Open();
@@ -151,9 +152,9 @@ void BedWindow::WindowIntersectBed() {
 
 void BedWindow::WindowIntersectBam(string bamFile) {
 
-    // load the "B" bed file into a map so
+    // load the "B" bed file into an index so
     // that we can easily compare "A" to it for overlaps
-    _bedB->loadBedFileIntoMap();
+    _bIndex = new BedIndex(_bedB);
 
     // open the BAM file
     BamReader reader;
@@ -178,7 +179,7 @@ void BedWindow::WindowIntersectBam(string bamFile) {
         writer.Open("stdout", bamHeader, refs);
     }
 
-    vector<BED> hits;                   // vector of potential hits
+    vector<size_t> hits;                   // vector of potential hits
     // reserve some space
     hits.reserve(100);
 
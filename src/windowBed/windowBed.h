@@ -18,6 +18,7 @@
 using namespace BamTools;
 
 #include "bedFile.h"
+#include "bedIndex.h"
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -59,11 +60,13 @@ private:
 
     // instance of a bed file class.
     BedFile *_bedA, *_bedB;
+    // B, indexed for searching.
+    BedIndex *_bIndex;
 
     // methods
     void WindowIntersectBed();
     void WindowIntersectBam(string bamFile);
-    void FindWindowOverlaps(const BED &a, vector<BED> &hits);
+    void FindWindowOverlaps(const BED &a, vector<size_t> &hits);
     bool FindOneOrMoreWindowOverlaps(const BED &a);
     void AddWindow(const BED &a, CHRPOS &fudgeStart, CHRPOS &fudgeEnd);
 
@@ -0,0 +1,89 @@
+BT=${BT-../../bin/bedtools}
+
+check()
+{
+	if diff $1 $2; then
+    	echo ok
+	else
+    	echo fail
+	fi
+}
+
+###########################################################
+#  Each job's output matches running the tool on its own
+###########################################################
+echo "    batch.t01...\c"
+echo \
+"intersect -u > obs.u
+coverage > obs.cov
+map -c 5 -o sum,count > obs.map" > jobs
+$BT batch -a a.bed -b b.bed -script jobs
+$BT intersect -u -a a.bed -b b.bed -sorted > exp.u
+$BT coverage -a a.bed -b b.bed -sorted > exp.cov
+$BT map -c 5 -o sum,count -a a.bed -b b.bed -sorted > exp.map
+cat obs.u obs.cov obs.map > obs
+cat exp.u exp.cov exp.map > exp
+check obs exp
+rm obs* exp* jobs
+
+###########################################################
+#  Jobs apply their own strand and fraction options
+###########################################################
+echo "    batch.t02...\c"
+echo \
+"# stranded and fractional jobs
+intersect -wa -wb -s > obs.s
+
+intersect -v -f 0.5 > obs.f
+coverage -hist -S > obs.hist
+subtract -s > obs.sub" > jobs
+$BT batch -a a.bed -b b.bed -script jobs
+$BT intersect -wa -wb -s -a a.bed -b b.bed -sorted > exp.s
+$BT intersect -v -f 0.5 -a a.bed -b b.bed -sorted > exp.f
+$BT coverage -hist -S -a a.bed -b b.bed -sorted > exp.hist
+$BT subtract -s -a a.bed -b b.bed -sorted > exp.sub
+cat obs.s obs.f obs.hist obs.sub > obs
+cat exp.s exp.f exp.hist exp.sub > exp
+check obs exp
+rm obs* exp* jobs
+
+###########################################################
+#  Unsupported tools are rejected
+###########################################################
+echo "    batch.t03...\c"
+echo "closest -d > obs.c" > jobs
+echo \
+"
+***** ERROR: jobs, line 1: batch supports intersect, map, coverage and subtract. *****" > exp
+$BT batch -a a.bed -b b.bed -script jobs 2>&1 > /dev/null | head -2 > obs
+check obs exp
+rm obs exp jobs
+
+###########################################################
+#  Every job needs an output file
+###########################################################
+echo "    batch.t04...\c"
+echo "intersect -u" > jobs
+echo \
+"
+***** ERROR: jobs, line 1: no output file given. End the line with '> file'. *****" > exp
+$BT batch -a a.bed -b b.bed -script jobs 2>&1 > /dev/null | head -2 > obs
+check obs exp
+rm obs exp jobs
+
+###########################################################
+#  -a from stdin is read once, for all the jobs
+###########################################################
+echo "    batch.t05...\c"
+awk 'BEGIN { for (i=0; i < 20000; i++) printf("chr1\t%d\t%d\ta%d\t%d\t+\n", i * 50, i * 50 + 30, i, i % 7) }' > big_a.bed
+awk 'BEGIN { for (i=0; i < 5000; i++) printf("chr1\t%d\t%d\tb%d\t%d\t-\n", i * 200 + 20, i * 200 + 60, i, i % 5) }' > big_b.bed
+echo \
+"coverage > obs.cov
+intersect -u > obs.u" > jobs
+cat big_a.bed | $BT batch -a stdin -b big_b.bed -script jobs
+$BT coverage -a big_a.bed -b big_b.bed -sorted > exp.cov
+$BT intersect -u -a big_a.bed -b big_b.bed -sorted > exp.u
+cat obs.cov obs.u > obs
+cat exp.cov exp.u > exp
+check obs exp
+rm obs* exp* jobs big_a.bed big_b.bed
@@ -822,6 +822,110 @@ $BT closest -a dmr.bed -b islands.2.bed tfbs.bed shores.bed -filenames -d -mdb e
 check exp obs
 rm exp obs
 
+###########################################################
+#  Test -unsorted with unsorted A and B
+############################################################
+echo "    closest.t72...\c"
+echo \
+"chr2	100	200	q1	0	+
+chr1	500	600	q2	0	-
+chr1	10	20	q3	0	+
+chr3	1	2	q4	0	+" > unsorted_a.bed
+echo \
+"chr1	700	800	b1	0	+
+chr2	150	160	b2	0	-
+chr1	100	110	b3	0	-
+chr1	30	40	b4	0	+" > unsorted_b.bed
+echo \
+"chr2	100	200	q1	0	+	chr2	150	160	b2	0	-	0
+chr1	500	600	q2	0	-	chr1	700	800	b1	0	+	101
+chr1	10	20	q3	0	+	chr1	30	40	b4	0	+	11
+chr3	1	2	q4	0	+	.	-1	-1	.	-1	.	-1" > exp
+$BT closest -a unsorted_a.bed -b unsorted_b.bed -d -unsorted > obs
+check exp obs
+rm exp obs
+
+###########################################################
+#  Test -unsorted with -k and -D
+############################################################
+echo "    closest.t73...\c"
+echo \
+"chr2	100	200	q1	0	+	chr2	150	160	b2	0	-	0
+chr1	500	600	q2	0	-	chr1	700	800	b1	0	+	-101
+chr1	500	600	q2	0	-	chr1	100	110	b3	0	-	391
+chr1	10	20	q3	0	+	chr1	30	40	b4	0	+	11
+chr1	10	20	q3	0	+	chr1	100	110	b3	0	-	81
+chr3	1	2	q4	0	+	.	-1	-1	.	-1	.	-1" > exp
+$BT closest -a unsorted_a.bed -b unsorted_b.bed -k 2 -D a -unsorted -threads 2 > obs
+check exp obs
+rm exp obs
+
+###########################################################
+#  Test that -unsorted matches the sorted sweep on sorted
+#  input, ties included
+############################################################
+echo "    closest.t74...\c"
+$BT closest -a close-a.bed -b close-b.bed -k 3 -d > exp
+$BT closest -a close-a.bed -b close-b.bed -k 3 -d -unsorted > obs
+check exp obs
+rm exp obs
+
+###########################################################
+#  Test that -threads needs -unsorted, or compressed output
+############################################################
+echo "    closest.t75...\c"
+echo \
+"
+*****
+*****ERROR: -threads is only for -unsorted input, or -obgz or -ogz output.
+*****" > exp
+$BT closest -a unsorted_a.bed -b unsorted_b.bed -threads 2 2>&1 > /dev/null | head -4 > obs
+check exp obs
+rm exp obs unsorted_a.bed unsorted_b.bed
+
+###########################################################
+#  Test that -D b -k keeps the farther hits a second A needs
+############################################################
+echo "    closest.t76...\c"
+echo \
+"chr1	134	142	a2	5	-
+chr1	138	162	a2	4	+" > sweep_a.bed
+echo \
+"chr1	57	76	b3	5	+
+chr1	62	89	a1	4	-
+chr1	249	266	b3	3	-" > sweep_b.bed
+echo \
+"chr1	134	142	a2	5	-	chr1	62	89	a1	4	-	-46
+chr1	134	142	a2	5	-	chr1	57	76	b3	5	+	59
+chr1	134	142	a2	5	-	chr1	249	266	b3	3	-	108
+chr1	138	162	a2	4	+	chr1	62	89	a1	4	-	-50
+chr1	138	162	a2	4	+	chr1	57	76	b3	5	+	63
+chr1	138	162	a2	4	+	chr1	249	266	b3	3	-	88" > exp
+$BT closest -a sweep_a.bed -b sweep_b.bed -D b -k 3 > obs
+check exp obs
+rm exp obs sweep_a.bed sweep_b.bed
+
+###########################################################
+#  Test that -N keeps the hits with other names
+############################################################
+echo "    closest.t77...\c"
+echo \
+"chr1	28	57	a3	2	-
+chr1	59	70	a2	5	-
+chr1	266	290	a1	2	+
+chr1	295	310	a2	7	+" > sweep_a.bed
+echo \
+"chr1	139	155	a1	1	-
+chr1	178	198	a2	8	+" > sweep_b.bed
+echo \
+"chr1	28	57	a3	2	-	chr1	139	155	a1	1	-
+chr1	59	70	a2	5	-	chr1	139	155	a1	1	-
+chr1	266	290	a1	2	+	chr1	178	198	a2	8	+
+chr1	295	310	a2	7	+	chr1	139	155	a1	1	-" > exp
+$BT closest -a sweep_a.bed -b sweep_b.bed -N > obs
+check exp obs
+rm exp obs sweep_a.bed sweep_b.bed
+
 cd sortAndNaming
 bash test-sort-and-naming.sh
 cd ..
@@ -279,3 +279,43 @@ check obs exp
 
 rm a.bed.gz b.bed.gz c.bed.gz a.bed b.bed c.bed genome.txt exp obs
 
+###########################################################
+#  Columnar BED (-cbed) output reads back as the same records
+###########################################################
+echo "    general.t43...\c"
+$BT intersect -a ../intersect/a.bed -b ../intersect/b.bed -cbed \
+  | $BT intersect -a stdin -b ../intersect/b.bed -wa -wb > obs
+$BT intersect -a ../intersect/a.bed -b ../intersect/b.bed \
+  | $BT intersect -a - -b ../intersect/b.bed -wa -wb > exp
+check obs exp
+
+echo "    general.t44...\c"
+$BT intersect -a ../intersect/a_vcfSVtest.vcf -b ../intersect/b_vcfSVtest.vcf -header -cbed > a.cbed
+$BT intersect -a a.cbed -b ../intersect/b_vcfSVtest.vcf -header > obs
+$BT intersect -a ../intersect/a_vcfSVtest.vcf -b ../intersect/b_vcfSVtest.vcf -header \
+  | $BT intersect -a - -b ../intersect/b_vcfSVtest.vcf -header > exp
+check obs exp
+
+echo "    general.t45...\c"
+$BT intersect -a ../intersect/blocks.bed12 -b ../intersect/blocks.bed12 -split -cbed > a.cbed
+$BT intersect -a a.cbed -b ../intersect/blocks.bed12 -split -sorted -wo > obs
+$BT intersect -a ../intersect/blocks.bed12 -b ../intersect/blocks.bed12 -split \
+  | $BT intersect -a - -b ../intersect/blocks.bed12 -split -sorted -wo > exp
+check obs exp
+
+echo "    general.t46...\c"
+$BT merge -i empty.bed -cbed > a.cbed
+$BT merge -i a.cbed > obs
+echo -n "" > exp
+check obs exp
+
+echo "    general.t47...\c"
+$BT coverage -a ../intersect/a.bed -b ../intersect/b.bed -hist -cbed 2> obs > /dev/null
+echo "Error: output line 5 has a different number of fields than the first record, so it can't be written in columnar format." > exp
+check obs exp
+
+echo "    general.t48...\c"
+$BT coverage -a ../intersect/a.bed -b ../intersect/b.bed -hist -cbed -nobuf 2> obs > /dev/null
+check obs exp
+
+rm a.cbed exp obs
@@ -331,3 +331,45 @@ echo \
 cut -f 1 test.bed | $BT groupby -g 1 -i - -c 1 -o collapse > obs
 check obs exp
 rm obs exp
+
+###########################################################
+#  Test unsorted input
+###########################################################
+echo "    groupby.t19...\c"
+echo \
+"chr3	14	4,3,1,2,4
+chr1	66	15,15,5,10,5,15,1" > exp
+grep -v "^#" values3.header.bed | awk 'NR % 2 == 0' | tac > unsorted.bed
+grep -v "^#" values3.header.bed | awk 'NR % 2 == 1' >> unsorted.bed
+$BT groupby -i unsorted.bed -g 1 -c 5,5 -o sum,collapse -unsorted > obs
+check obs exp
+rm obs exp unsorted.bed
+
+###########################################################
+#  Test that -unsorted spilling past -mem gives the same output
+###########################################################
+echo "    groupby.t20...\c"
+awk 'BEGIN { for (i=0; i < 3000; i++) printf("chr%d\t%d\t%d\tn%d\t%d\n", (i * 7) % 13, (i * 31) % 200, (i * 31) % 200 + 10, i % 5, i % 17) }' > unsorted.bed
+$BT groupby -i unsorted.bed -g 1,2 -c 5,5,5,4 -o sum,median,collapse,mode -unsorted > exp
+$BT groupby -i unsorted.bed -g 1,2 -c 5,5,5,4 -o sum,median,collapse,mode -unsorted -mem 1K > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test that -unsorted -full spilling past -mem gives the same output
+###########################################################
+echo "    groupby.t21...\c"
+$BT groupby -i unsorted.bed -g 2 -c 4 -o distinct -full -unsorted > exp
+$BT groupby -i unsorted.bed -g 2 -c 4 -o distinct -full -unsorted -mem 1K > obs
+check obs exp
+rm obs exp unsorted.bed
+
+###########################################################
+#  Test that -threads gives the same output
+###########################################################
+echo "    groupby.t22...\c"
+awk 'BEGIN { for (i=0; i < 3000; i++) printf("chr%d\t%d\t%d\tn%d\t%d\n", (i * 7) % 13, (i * 31) % 200, (i * 31) % 200 + 10, i % 5, i % 17) }' | sort -k1,1 -k2,2n > sorted.bed
+$BT groupby -i sorted.bed -g 1,2 -c 5,5,5,4,5 -o sum,median,collapse,mode,stdev > exp
+$BT groupby -i sorted.bed -g 1,2 -c 5,5,5,4,5 -o sum,median,collapse,mode,stdev -threads 3 > obs
+check obs exp
+rm obs exp sorted.bed
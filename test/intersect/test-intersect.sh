@@ -901,6 +901,83 @@ $BT intersect -a a -b b > obs
 check exp obs
 rm exp obs a b
 
+##################################################################
+# Test that a small output buffer, which is handed to the writer
+# thread after almost every record, keeps the output in order.
+##################################################################
+echo "    intersect.t80...\c"
+$BT intersect -a a.bed -b b.bed -wao -nobuf > exp
+$BT intersect -a a.bed -b b.bed -wao -obuf 16 > obs
+check exp obs
+rm exp obs
+
+##################################################################
+# Test BGZF output, compressed by more than one thread
+##################################################################
+echo "    intersect.t81...\c"
+$BT intersect -a a.bed -b b.bed -wao > exp
+$BT intersect -a a.bed -b b.bed -wao -obgz -threads 2 -obuf 16 | gzip -dc > obs
+check exp obs
+rm exp obs
+
+##################################################################
+# Test -split with blocks that are out of order, or overlap
+# each other, which are compared pair by pair
+##################################################################
+echo "    intersect.t82...\c"
+echo \
+"chr1	0	50	unordered	0	+	0	0	0	3	10,10,10,	40,0,20,	chr1	0	45	oneblock_comma	0	+	0	0	0	1	45,	0,	25
+chr1	0	50	unordered	0	+	0	0	0	3	10,10,10,	40,0,20,	chr1	0	45	oneblock_nocomma	0	+	0	0	0	1	45	0	25
+chr1	0	50	unordered	0	+	0	0	0	3	10,10,10,	40,0,20,	chr1	0	50	three_blocks_comma	0	+	0	0	0	3	10,10,10,	0,20,40,	30
+chr1	0	50	unordered	0	+	0	0	0	3	10,10,10,	40,0,20,	chr1	0	50	three_blocks_nocomma	0	+	0	0	0	3	10,10,10	0,20,40	30
+chr1	0	50	overlapping	0	+	0	0	0	2	25,10,	0,15,	chr1	0	45	oneblock_comma	0	+	0	0	0	1	45,	0,	35
+chr1	0	50	overlapping	0	+	0	0	0	2	25,10,	0,15,	chr1	0	45	oneblock_nocomma	0	+	0	0	0	1	45	0	35
+chr1	0	50	overlapping	0	+	0	0	0	2	25,10,	0,15,	chr1	0	50	three_blocks_comma	0	+	0	0	0	3	10,10,10,	0,20,40,	20
+chr1	0	50	overlapping	0	+	0	0	0	2	25,10,	0,15,	chr1	0	50	three_blocks_nocomma	0	+	0	0	0	3	10,10,10	0,20,40	20" > exp
+$BT intersect -a unordered_blocks.bed12 -b blocks.bed12 -split -wo > obs
+check exp obs
+rm exp obs
+
+##################################################################
+# Test gzip output, compressed by more than one thread, and
+# written as a single gzip member
+##################################################################
+echo "    intersect.t83...\c"
+$BT intersect -a a.bed -b b.bed -wao > exp
+$BT intersect -a a.bed -b b.bed -wao -ogz -threads 2 -obuf 16 | gzip -dc > obs
+check exp obs
+rm exp obs
+
+##################################################################
+# Test the tabix index written with -obgz -tbi. Both lines are
+# in bin 4681, from offset 0 up to 79.
+##################################################################
+echo "    intersect.t84...\c"
+echo \
+" 54 42 49 01 01 00 00 00 00 00 01 00 01 00 00 00
+ 02 00 00 00 03 00 00 00 23 00 00 00 00 00 00 00
+ 05 00 00 00 63 68 72 31 00 02 00 00 00 49 12 00
+ 00 01 00 00 00 00 00 00 00 00 00 00 00 4f 00 00
+ 00 00 00 00 00 4a 92 00 00 02 00 00 00 00 00 00
+ 00 00 00 00 00 4f 00 00 00 00 00 00 00 02 00 00
+ 00 00 00 00 00 00 00 00 00 00 00 00 00 01 00 00
+ 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00
+ 00" > exp
+$BT intersect -a a.bed -b b.bed -wa -wb -obgz -tbi obs.tbi > /dev/null
+gzip -dc obs.tbi | od -An -tx1 -v > obs
+check exp obs
+rm exp obs obs.tbi
+
+##################################################################
+# Test that -tbi rejects output that isn't sorted
+##################################################################
+echo "    intersect.t85...\c"
+echo -e "chr1\t300\t400\nchr1\t250\t260" > unsorted.bed
+echo "Error: output line 2 is not sorted by start, so it can't be indexed with -tbi:" > exp
+$BT intersect -a unsorted.bed -b b.bed -v -obgz -tbi obs.tbi 2>&1 > /dev/null | head -1 > obs
+check exp obs
+rm exp obs unsorted.bed
+
 
 
 cd multi_intersect
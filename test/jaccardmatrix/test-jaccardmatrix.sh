@@ -0,0 +1,61 @@
+BT=${BT-../../bin/bedtools}
+
+check()
+{
+	if diff $1 $2; then
+    	echo ok
+	else
+    	echo fail
+	fi
+}
+
+###########################################################
+#  Each pair matches bedtools jaccard
+###########################################################
+echo "    jaccardmatrix.t01...\c"
+echo \
+"file	A	B	C
+A	1	0.0714286	0.05
+B	0.0714286	1	0.166667
+C	0.05	0.166667	1" > exp
+$BT jaccardmatrix -i a.bed b.bed c.bed -names A B C > obs
+check obs exp
+rm obs exp
+
+echo "    jaccardmatrix.t02...\c"
+$BT jaccard -a a.bed -b b.bed | tail -1 | cut -f 3 > exp
+$BT jaccardmatrix -i a.bed b.bed | tail -1 | cut -f 2 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  -stat overlaps is jaccard's n_intersections
+###########################################################
+echo "    jaccardmatrix.t03...\c"
+echo \
+"file	A	B	C
+A	2	1	1
+B	1	3	2
+C	1	2	1" > exp
+$BT jaccardmatrix -i a.bed b.bed c.bed -names A B C -stat overlaps > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  -stat fisher is the right tail of fisher -m
+###########################################################
+echo "    jaccardmatrix.t04...\c"
+$BT fisher -m -a b.bed -b c.bed -g test.genome | tail -1 | cut -f 2 > exp
+$BT jaccardmatrix -i b.bed c.bed -stat fisher -g test.genome | tail -1 | cut -f 2 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  -list, and the same matrix for any -t
+###########################################################
+echo "    jaccardmatrix.t05...\c"
+$BT jaccardmatrix -i a.bed b.bed a.bed b.bed c.bed -threads 1 > exp
+echo -e "a.bed\nb.bed\nc.bed" > files.txt
+$BT jaccardmatrix -i a.bed b.bed -list files.txt -threads 3 > obs
+check obs exp
+rm obs exp files.txt
@@ -837,3 +837,29 @@ rm exp obs
 
 
 
+###########################################################
+#  Test that column operations computed on threads give
+#  the same output as without
+############################################################
+echo "    map.t56...\c"
+$BT map -a ivls.bed -b values.bed -c 5,5,4 -o sum,median,collapse > exp
+$BT map -a ivls.bed -b values.bed -c 5,5,4 -o sum,median,collapse -threads 3 > obs
+check exp obs
+rm exp obs
+
+
+###########################################################
+#  Test that -prec sets the significant digits of
+#  computed values
+############################################################
+echo "    map.t57...\c"
+echo \
+"chr1	0	100	10	4.08
+chr1	100	200	1	0
+chr2	0	100	.	.
+chr2	100	200	.	.
+chr3	0	100	2	0.816
+chr3	100	200	4	0" > exp
+$BT map -a ivls.bed -b values.bed -c 5,5 -o mean,stdev -prec 3 > obs
+check exp obs
+rm exp obs
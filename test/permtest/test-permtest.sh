@@ -0,0 +1,63 @@
+BT=${BT-../../bin/bedtools}
+
+check()
+{
+	if diff $1 $2; then
+    	echo ok
+	else
+    	echo fail
+	fi
+}
+
+###########################################################
+#  The observed statistic matches bedtools jaccard
+###########################################################
+echo "    permtest.t01...\c"
+$BT jaccard -a a.bed -b b.bed | tail -1 | cut -f 3 > exp
+$BT permtest -a a.bed -b b.bed -g test.genome -seed 1 -n 10 | tail -1 | cut -f 2 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Every shuffle is the same when -b covers the genome
+###########################################################
+echo "    permtest.t02...\c"
+echo \
+"statistic	observed	null_mean	null_sd	n_perm	p_greater	p_less
+jaccard	0.1	0.1	0	10	1	1" > exp
+$BT permtest -a <(echo -e "chr1\t10\t20") -b <(echo -e "chr1\t0\t100") \
+    -g <(echo -e "chr1\t100") -seed 1 -n 10 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  -excl leaves a single locus, which overlaps -b
+###########################################################
+echo "    permtest.t03...\c"
+echo \
+"statistic	observed	null_mean	null_sd	n_perm	p_greater	p_less
+overlaps	0	1	0	5	1	0.166667" > exp
+$BT permtest -a <(echo -e "chr1\t0\t10") -b <(echo -e "chr1\t45\t46") \
+    -g <(echo -e "chr1\t100") -excl <(echo -e "chr1\t0\t40\nchr1\t50\t100") \
+    -stat overlaps -seed 1 -n 5 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  The null distribution doesn't depend on -t
+###########################################################
+echo "    permtest.t04...\c"
+$BT permtest -a a.bed -b b.bed -g test.genome -seed 7 -n 50 -null -threads 1 > exp
+$BT permtest -a a.bed -b b.bed -g test.genome -seed 7 -n 50 -null -threads 3 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Features that fit nowhere are an error
+###########################################################
+echo "    permtest.t05...\c"
+echo "Error: feature 1 in big.bed can't be placed anywhere in the genome." > exp
+echo -e "chr1\t0\t2000" > big.bed
+$BT permtest -a big.bed -b b.bed -g test.genome -seed 1 -n 5 &> obs
+check obs exp
+rm obs exp big.bed
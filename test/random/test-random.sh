@@ -0,0 +1,44 @@
+BT=${BT-../../bin/bedtools}
+
+check()
+{
+	if diff $1 $2; then
+    	echo ok
+	else
+    	echo fail
+	fi
+}
+
+###########################################################
+#  A seed gives the same intervals on every platform
+###########################################################
+echo "    random.t01...\c"
+echo \
+"chr1	3686	3736	1	50	-
+chr1	8678	8728	2	50	-
+chr2	4358	4408	3	50	+
+chr1	9379	9429	4	50	+
+chr1	7791	7841	5	50	+" > exp
+$BT random -g test.genome -n 5 -l 50 -seed 11 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  ... and the same intervals with any number of threads
+###########################################################
+echo "    random.t02...\c"
+$BT random -g test.genome -n 150000 -l 50 -seed 11 -threads 1 > exp
+$BT random -g test.genome -n 150000 -l 50 -seed 11 -threads 3 > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Intervals stay within the chromosomes
+###########################################################
+echo "    random.t03...\c"
+echo "0" > exp
+$BT random -g test.genome -n 10000 -l 500 -seed 2 \
+    | awk '($1 == "chr1" && $3 > 10000) || ($1 == "chr2" && $3 > 5000)' \
+    | wc -l | tr -d ' ' > obs
+check obs exp
+rm obs exp
@@ -148,3 +148,29 @@ $BT reldist -a $DATA/refseq.chr1.exons.bed.gz \
             -b $DATA/gerp.chr1.bed.gz > obs
 check obs exp
 rm obs exp
+
+###########################################################
+#  Test -sorted. A query whose midpoint is a database
+# midpoint is at 0, even with no database midpoint left of it.
+############################################################
+echo "    reldist.t04...\c"
+echo \
+"chr1	14	16	0.000
+chr1	40	50	0.333
+chr1	150	160	0.500
+chr2	30	40	0.500" > exp
+$BT reldist -a a.bed -b b.bed -detail -sorted > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test that -sorted matches the default on sorted input.
+############################################################
+echo "    reldist.t05...\c"
+$BT reldist -a $DATA/gerp.chr1.bed.gz \
+            -b $DATA/refseq.chr1.exons.bed.gz > exp
+$BT sort -i $DATA/refseq.chr1.exons.bed.gz > refseq.sorted.bed
+$BT reldist -a $DATA/gerp.chr1.bed.gz \
+            -b refseq.sorted.bed -sorted > obs
+check obs exp
+rm obs exp refseq.sorted.bed
@@ -120,6 +120,65 @@ rm obs exp
 
 
 
+###########################################################
+#  Test that a seed gives the same sample on every platform
+############################################################
+echo "    sample.new.t10...\c"
+echo \
+"chr1	10	15	r1
+chr1	50	55	r5
+chr1	40	45	r4" > exp
+$BT sample -n 3 -seed 4 -i <(for i in $(seq 1 20); do echo -e "chr1\t$((i*10))\t$((i*10+5))\tr$i"; done) > obs
+check obs exp
+rm obs exp
+
+
+###########################################################
+#  Test that -w never samples records whose weight isn't
+#  positive, so only two can be chosen here.
+############################################################
+echo "    sample.new.t11...\c"
+echo \
+"a	1	2	r1	0	+
+a	3	4	r2	2	+
+a	5	6	r3	0	+
+b	1	2	r4	1	+
+b	3	4	r5	-1	+" > weighted.bed
+echo \
+"a	3	4	r2	2	+
+b	1	2	r4	1	+" > exp
+$BT sample -i weighted.bed -n 2 -w -seed 1 | sort > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test that -w fails when it can't find enough records
+#  with a positive weight.
+############################################################
+echo "    sample.new.t12...\c"
+echo \
+"
+***** ERROR: Input file has fewer records than the requested number of output records. *****
+" > exp
+$BT sample -i weighted.bed -n 3 -w -seed 1 2>&1 > /dev/null | cat - > obs
+check obs exp
+rm obs exp weighted.bed
+
+###########################################################
+#  Test that -perChrom samples -n records from each chrom,
+#  and all of a chrom's records when it has fewer.
+############################################################
+echo "    sample.new.t13...\c"
+echo \
+"      2 chr1
+      2 chr2
+      1 chr3" > exp
+$BT sample -n 2 -perChrom -seed 7 -i <(for i in $(seq 1 10); do echo -e "chr1\t$i\t$((i+1))"; echo -e "chr2\t$i\t$((i+1))"; done; echo -e "chr3\t1\t2") | cut -f1 | uniq -c > obs
+check obs exp
+rm obs exp
+
+
+
 rm mainFile.bed
 
 
@@ -0,0 +1,150 @@
+BT=${BT-../../bin/bedtools}
+
+check()
+{
+	if diff $1 $2; then
+    	echo ok
+		return 1
+	else
+    	echo fail
+		return 0
+	fi
+}
+
+# the YB tags of a BAM file, in alignment order. there's no samtools
+# here, so read them straight out of the decompressed records.
+tags()
+{
+	gzip -dc $1 | tr '\0' '\n' | grep -a -o "YBZ.*"
+}
+
+# reads.bam (the last read is unmapped)
+# chr1	10	20	r1	255	+
+# chr1	100	200	r2	255	-
+# chr1	130	150	r3	255	+
+# chr1	500	600	r4	255	+
+# chr2	50	80	r5	255	-
+#
+# nested.bed has several annotations nested in each other, and one on
+# a chrom that isn't in the BAM header.
+
+###########################################################
+#  Test tagging with labels, sorted and unsorted
+###########################################################
+echo "    tag.t1...\c"
+echo \
+"YBZn
+YBZn;g
+YBZn;g
+YBZn
+YBZn;g" > exp
+$BT tag -i reads.bam -files nested.bed genes.bed -labels n g > unsorted.bam
+$BT tag -i reads.bam -files nested.bed genes.bed -labels n g -sorted > sorted.bam
+tags sorted.bam > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test that -sorted writes the same BAM as the unsorted path
+###########################################################
+echo "    tag.t2...\c"
+if cmp -s unsorted.bam sorted.bam; then echo ok; else echo fail; fi
+rm unsorted.bam sorted.bam
+
+###########################################################
+#  Test multiple and nested hits
+###########################################################
+echo "    tag.t3...\c"
+echo \
+"YBZbig,mid
+YBZsmall1,small2,big,mid;g1,g2
+YBZsmall1,small2,big,mid;g1,g2
+YBZsmall3,big,mid
+YBZc2;g3" > exp
+$BT tag -i reads.bam -files nested.bed genes.bed -names | tags - > obs
+check obs exp
+rm obs
+
+###########################################################
+#  Test that -sorted reports multiple and nested hits
+#  in the same order as the unsorted path
+###########################################################
+echo "    tag.t4...\c"
+$BT tag -i reads.bam -files nested.bed genes.bed -names -sorted | tags - > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test -sorted with -scores
+###########################################################
+echo "    tag.t5...\c"
+echo \
+"YBZ1,2
+YBZ3,4,1,2;7,8
+YBZ3,4,1,2;7,8
+YBZ5,1,2
+YBZ6;9" > exp
+$BT tag -i reads.bam -files nested.bed genes.bed -scores -sorted | tags - > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test -sorted with -intervals
+###########################################################
+echo "    tag.t6...\c"
+echo \
+"YBZn:chr1:0-900000,big,1,+,n:chr1:15-300050,mid,2,+
+YBZn:chr1:120-180,small1,3,-,n:chr1:140-160,small2,4,+,n:chr1:0-900000,big,1,+,n:chr1:15-300050,mid,2,+;g:chr1:100-140,g1,7,+,g:chr1:135-145,g2,8,-
+YBZn:chr1:120-180,small1,3,-,n:chr1:140-160,small2,4,+,n:chr1:0-900000,big,1,+,n:chr1:15-300050,mid,2,+;g:chr1:100-140,g1,7,+,g:chr1:135-145,g2,8,-
+YBZn:chr1:550-560,small3,5,+,n:chr1:0-900000,big,1,+,n:chr1:15-300050,mid,2,+
+YBZn:chr2:0-100,c2,6,-;g:chr2:60-70,g3,9,+" > exp
+$BT tag -i reads.bam -files nested.bed genes.bed -labels n g -intervals -sorted | tags - > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test -sorted with -s, -S and -f, against the unsorted path
+###########################################################
+echo "    tag.t7...\c"
+for opts in "-s" "-S" "-f 0.5"; do
+	$BT tag -i reads.bam -files nested.bed genes.bed -names $opts > unsorted.bam
+	$BT tag -i reads.bam -files nested.bed genes.bed -names $opts -sorted > sorted.bam
+	cmp -s unsorted.bam sorted.bam || echo "$opts differs"
+done > obs
+touch exp
+check obs exp
+rm obs exp unsorted.bam sorted.bam
+
+###########################################################
+#  Test that annotations whose chroms are out of
+#  the BAM header's order are an error with -sorted
+###########################################################
+echo "    tag.t8...\c"
+echo \
+"Error: Sorted input specified, but the chromosome order of the file nested.chromorder.bed differs from the BAM header of reads.bam. Record was:
+chr1	120	180	small1	3	-" > exp
+$BT tag -i reads.bam -files nested.chromorder.bed -labels n -sorted 2>&1 > /dev/null | cat - > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test that annotations out of start order
+#  are an error with -sorted
+###########################################################
+echo "    tag.t9...\c"
+echo \
+"Error: Sorted input specified, but the file nested.unsorted.bed has the following out of order record
+chr1	15	300050	mid	2	+" > exp
+$BT tag -i reads.bam -files nested.unsorted.bed -labels n -sorted 2>&1 > /dev/null | cat - > obs
+check obs exp
+rm obs exp
+
+###########################################################
+#  Test that an unsorted BAM is an error with -sorted
+###########################################################
+echo "    tag.t10...\c"
+echo \
+"Error: Sorted input specified, but the BAM file reads.unsorted.bam has the following out of order alignment: r1" > exp
+$BT tag -i reads.unsorted.bam -files nested.bed -labels n -sorted 2>&1 > /dev/null | cat - > obs
+check obs exp
+rm obs exp
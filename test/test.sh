@@ -7,6 +7,9 @@ cd bed12tobed6; bash test-bed12tobed6.sh; cd ..
 echo " Testing bedtools bamtobed:"
 cd bamtobed; bash test-bamtobed.sh; cd ..
 
+echo " Testing bedtools batch:"
+cd batch; bash test-batch.sh; cd ..
+
 echo " Testing bedtools closest:"
 cd closest; bash test-closest.sh; cd ..
 
@@ -37,6 +40,9 @@ cd intersect; bash test-intersect.sh; bash new_test-intersect.sh; cd ..
 echo " Testing bedtools jaccard:"
 cd jaccard; bash test-jaccard.sh; cd ..
 
+echo " Testing bedtools jaccardmatrix:"
+cd jaccardmatrix; bash test-jaccardmatrix.sh; cd ..
+
 echo " Testing bedtools map:"
 cd map; bash test-map.sh; cd ..
 
@@ -46,6 +52,12 @@ cd merge; bash test-merge.sh; cd ..
 echo " Testing bedtools multicov:"
 cd multicov; bash test-multicov.sh; cd ..
 
+echo " Testing bedtools permtest:"
+cd permtest; bash test-permtest.sh; cd ..
+
+echo " Testing bedtools random:"
+cd random; bash test-random.sh; cd ..
+
 echo " Testing bedtools reldist:"
 cd reldist; bash test-reldist.sh; cd ..
 
@@ -72,3 +84,6 @@ cd split; bash test-split.sh; cd ..
 
 echo " Testing bedtools spacing:"
 cd spacing; bash test-spacing.sh; cd ..
+
+echo " Testing bedtools tag:"
+cd tagBam; bash test-tagBam.sh; cd ..